@@ -126,6 +126,9 @@ namespace ngcomp
     checksum = flags.GetDefineFlag ("checksum");
     spd = flags.GetDefineFlag ("spd");
     geom_free = flags.GetDefineFlag("geom_free");    
+    batch_assembly = flags.GetDefineFlag("batch_assembly");
+    owner_assembly = flags.GetDefineFlag("owner_assembly");
+    nodal_graph = !flags.GetDefineFlagX("nodal_graph").IsFalse();
     if (spd) symmetric = true;
     SetCheckUnused (!flags.GetDefineFlagX("check_unused").IsFalse());
   }
@@ -180,6 +183,9 @@ namespace ngcomp
                      !flags.GetDefineFlag ("nokeep_internal"));
     if (flags.GetDefineFlag ("store_inner")) SetStoreInner (1);
     geom_free = flags.GetDefineFlag("geom_free");
+    batch_assembly = flags.GetDefineFlag("batch_assembly");
+    owner_assembly = flags.GetDefineFlag("owner_assembly");
+    nodal_graph = !flags.GetDefineFlagX("nodal_graph").IsFalse();
     
     precompute = flags.GetDefineFlag ("precompute");
     checksum = flags.GetDefineFlag ("checksum");
@@ -229,6 +235,7 @@ namespace ngcomp
                        string ("bfi is ")+bfi->Name());
 
     parts.Append (bfi);
+    parameter_timestamp = 0;   // stored parameter matrices are outdated
 
     if ((bfi->geom_free && nonassemble) || geom_free)
       {
@@ -367,6 +374,242 @@ namespace ngcomp
   }
 
 
+  /*
+    Streaming graph construction for spaces with node-based dofs.
+
+    All dofs of a node couple with the same set of dofs, namely the union
+    of the element dofs of all elements sharing the node. This set is
+    computed per node, and written directly into the rows of the node
+    dofs. Neither the element-to-dof table nor its transpose is built.
+    Returns nullptr if the dofs are not node-based: if the space has no node
+    dofs, a dof belongs to two nodes, an element contains a dof but not its
+    node, or a dof is missing in some element around its node (then the
+    graph would have more entries than the element-based one).
+  */
+  static unique_ptr<MatrixGraph>
+  NodalMatrixGraph (const FESpace & fes, const MeshAccess & ma, bool symmetric,
+                    const function<void(ElementId,Array<DofId>&)> & eldofs)
+  {
+    static Timer timer ("BilinearForm::GetGraph - nodal");
+    RegionTimer reg (timer);
+
+    size_t ndof = fes.GetNDof();
+    int dim = ma.GetDimension();
+    size_t shift[3] = { 0, ma.GetNE(VOL), ma.GetNE(VOL)+ma.GetNE(BND) };
+    auto decode = [&] (size_t code)
+      {
+        VorB vb = (code < shift[BND]) ? VOL : (code < shift[BBND]) ? BND : BBND;
+        return ElementId(vb, code-shift[vb]);
+      };
+
+    auto elnodes = [&] (const Ngs_Element & el, NODE_TYPE nt, Array<int> & nodes)
+      {
+        nodes.SetSize0();
+        switch (nt)
+          {
+          case NT_VERTEX: for (auto v : el.Vertices()) nodes.Append(v); break;
+          case NT_EDGE: for (auto e : el.Edges()) nodes.Append(e); break;
+          case NT_FACE: for (auto f : el.Faces()) nodes.Append(f); break;
+          case NT_CELL: if (el.VB() == VOL && dim == 3) nodes.Append(el.Nr()); break;
+          default: break;
+          }
+      };
+
+    NODE_TYPE nts[] = { NT_VERTEX, NT_EDGE, NT_FACE, NT_CELL };
+
+    // some spaces (e.g. Discontinuous) don't provide node dofs at all
+    try
+      {
+        Array<DofId> dnums;
+        for (int k : Range(4))
+          if (ma.GetNNodes(nts[k]))
+            fes.GetDofNrs (NodeId(nts[k], 0), dnums);
+      }
+    catch (const Exception &)
+      {
+        return nullptr;
+      }
+
+    // owner node of every dof, encoded as 4*nr+k, a dof must not be in two nodes
+    constexpr size_t NO_NODE = numeric_limits<size_t>::max();
+    Array<size_t> owner(ndof);
+    owner = NO_NODE;
+    atomic<bool> nodal(true);
+    atomic<bool> has_dofs[4] = { false, false, false, false };
+    for (int k : Range(4))
+      ParallelForRange
+        (ma.GetNNodes(nts[k]), [&] (IntRange r)
+         {
+           Array<DofId> dnums;
+           bool mydofs = false;
+           for (auto nr : r)
+             {
+               fes.GetDofNrs (NodeId(nts[k], nr), dnums);
+               for (auto d : dnums)
+                 if (IsRegularDof(d))
+                   {
+                     size_t none = NO_NODE;
+                     if (!AsAtomic(owner[d]).compare_exchange_strong (none, 4*size_t(nr)+k))
+                       nodal = false;
+                     mydofs = true;
+                   }
+             }
+           if (mydofs) has_dofs[k] = true;
+         });
+    if (!nodal) return nullptr;
+
+    // every element containing a dof must contain the owner node of the dof,
+    // so the elements around the node are a superset of the elements of the dof
+    Array<int> elcnt(ndof);
+    elcnt = 0;
+    for (VorB vb : { VOL, BND, BBND })
+      ParallelForRange
+        (ma.GetNE(vb), [&] (IntRange r)
+         {
+           Array<DofId> dnums;
+           Array<int> nodes[4];
+           for (auto i : r)
+             {
+               ElementId ei(vb, i);
+               if (!fes.DefinedOn (vb, ma.GetElIndex(ei))) continue;
+               auto el = ma.GetElement(ei);
+               for (int k : Range(4))
+                 if (has_dofs[k]) elnodes (el, nts[k], nodes[k]);
+               eldofs (ei, dnums);
+               for (auto d : dnums)
+                 if (IsRegularDof(d))
+                   {
+                     AsAtomic(elcnt[d])++;
+                     size_t o = owner[d];
+                     if (o == NO_NODE || !nodes[o%4].Contains(int(o/4)))
+                       nodal = false;
+                   }
+             }
+         });
+    if (!nodal) return nullptr;
+
+    // elements around nodes, only for node types carrying dofs
+    Table<int> node2el[4];
+    for (int k : Range(4))
+      {
+        if (!has_dofs[k]) continue;
+        TableCreator<int> creator(ma.GetNNodes(nts[k]));
+        for ( ; !creator.Done(); creator++)
+          for (VorB vb : { VOL, BND, BBND })
+            ParallelForRange
+              (ma.GetNE(vb), [&] (IntRange r)
+               {
+                 Array<int> nodes;
+                 for (auto i : r)
+                   {
+                     ElementId ei(vb, i);
+                     if (!fes.DefinedOn (vb, ma.GetElIndex(ei))) continue;
+                     elnodes (ma.GetElement(ei), nts[k], nodes);
+                     for (auto n : nodes)
+                       creator.Add (n, shift[vb]+i);
+                   }
+               });
+        node2el[k] = creator.MoveTable();
+      }
+
+    // sorted union of the element dofs around a node
+    auto node_columns = [&] (FlatArray<int> els, Array<DofId> & dnums, Array<DofId> & cols)
+      {
+        cols.SetSize0();
+        for (auto code : els)
+          {
+            eldofs (decode(code), dnums);
+            for (auto d : dnums)
+              if (IsRegularDof(d)) cols.Append(d);
+          }
+        QuickSort (cols);
+        size_t n = 0;
+        for (size_t j = 0; j < cols.Size(); j++)
+          if (n == 0 || cols[j] != cols[n-1])
+            cols[n++] = cols[j];
+        cols.SetSize(n);
+      };
+    auto rowlength = [&] (FlatArray<DofId> cols, DofId d) -> int
+      {
+        if (!symmetric) return cols.Size();
+        int n = 0;
+        while (n < cols.Size() && cols[n] <= d) n++;
+        return n;
+      };
+
+    // uncoupled dofs keep the diagonal in the symmetric case
+    Array<int> rowsize(ndof);
+    ParallelForRange (ndof, [&] (IntRange r)
+                      {
+                        for (auto d : r)
+                          rowsize[d] = symmetric ? 1 : 0;
+                      });
+
+    for (int k : Range(4))
+      {
+        if (!has_dofs[k]) continue;
+        ParallelForRange
+          (node2el[k].Size(), [&] (IntRange r)
+           {
+             Array<DofId> dnums, ndofs, cols;
+             for (auto nr : r)
+               {
+                 fes.GetDofNrs (NodeId(nts[k], nr), ndofs);
+                 bool used = false;
+                 // together with the superset property above, equal counts
+                 // mean the dof lies in exactly the elements around its node
+                 for (auto d : ndofs)
+                   if (IsRegularDof(d) && elcnt[d] > 0)
+                     {
+                       if (elcnt[d] != node2el[k][nr].Size())
+                         nodal = false;
+                       used = true;
+                     }
+                 if (!used) continue;
+                 node_columns (node2el[k][nr], dnums, cols);
+                 for (auto d : ndofs)
+                   if (IsRegularDof(d) && elcnt[d] > 0)
+                     rowsize[d] = rowlength (cols, d);
+               }
+           });
+      }
+    if (!nodal) return nullptr;
+
+    auto graph = make_unique<MatrixGraph> (rowsize, ndof);
+
+    ParallelForRange (ndof, [&] (IntRange r)
+                      {
+                        for (auto d : r)
+                          if (elcnt[d] == 0 && symmetric)
+                            graph->GetRowIndices(d)[0] = d;
+                      });
+
+    for (int k : Range(4))
+      {
+        if (!has_dofs[k]) continue;
+        ParallelForRange
+          (node2el[k].Size(), [&] (IntRange r)
+           {
+             Array<DofId> dnums, ndofs, cols;
+             for (auto nr : r)
+               {
+                 fes.GetDofNrs (NodeId(nts[k], nr), ndofs);
+                 bool used = false;
+                 for (auto d : ndofs)
+                   if (IsRegularDof(d) && elcnt[d] > 0)
+                     used = true;
+                 if (!used) continue;
+                 node_columns (node2el[k][nr], dnums, cols);
+                 for (auto d : ndofs)
+                   if (IsRegularDof(d) && elcnt[d] > 0)
+                     graph->GetRowIndices(d) = cols.Range(0, rowlength(cols, d));
+               }
+           });
+      }
+    return graph;
+  }
+
+
   MatrixGraph BilinearForm :: GetGraph (int level, bool symmetric)
   {
     static Timer timer ("BilinearForm::GetGraph");
@@ -386,6 +629,24 @@ namespace ngcomp
     Array<int> nbelems; //neighbour elements
 
 
+    auto eldofs = [&] (ElementId eid, Array<DofId> & dnums)
+      {
+        bool condensation_allowed = (eid.VB() == VOL) || ((neV==0) && (eid.VB() == BND));
+        if (condensation_allowed && eliminate_internal)
+          fespace->GetDofNrs (eid, dnums, EXTERNAL_DOF);
+        else if (condensation_allowed && eliminate_hidden)
+          fespace->GetDofNrs (eid, dnums, VISIBLE_DOF);
+        else
+          fespace->GetDofNrs (eid, dnums);
+      };
+
+    if (nodal_graph && !fespace2 && !nspe && !fespace->UsesDGCoupling())
+      if (auto graph = NodalMatrixGraph (*fespace, *ma, symmetric, eldofs))
+        {
+          graph -> FindSameNZE();
+          return move(*graph);
+        }
+
     int maxind = neV + neB + neBB + specialelements.Size();
     if (fespace->UsesDGCoupling()) maxind += nf;
 
@@ -429,7 +690,6 @@ namespace ngcomp
 	for(VorB vb : {VOL, BND, BBND})
 	  {
             size_t shift = (vb==VOL) ? 0 : ((vb==BND) ? neV : neV+neB);
-            bool condensation_allowed = (vb == VOL) || ((neV==0) && (vb == BND));
 	    ParallelForRange
               (ma->GetNE(vb), [&](IntRange r)
                {
@@ -438,14 +698,7 @@ namespace ngcomp
                    {
                      auto eid = ElementId(vb,i);
                      if (!fespace->DefinedOn (vb, ma->GetElIndex(eid))) continue;
-                     
-                     if (condensation_allowed && eliminate_internal)
-                       fespace->GetDofNrs (eid, dnums, EXTERNAL_DOF);
-                     else if (condensation_allowed && eliminate_hidden)
-                       fespace->GetDofNrs (eid, dnums, VISIBLE_DOF);
-                     else
-                       fespace->GetDofNrs (eid, dnums);
-                         
+                     eldofs (eid, dnums);
                      
                      for (DofId d : dnums)
                        if (IsRegularDof(d)) creator.Add (shift+i, d);
@@ -729,7 +982,8 @@ namespace ngcomp
       }
 
 
-    DoAssemble(lh);
+    if (!precompute || !AssembleFromParameterCache(lh))
+      DoAssemble(lh);
 
 
     if (timing)
@@ -885,13 +1139,140 @@ namespace ngcomp
         return;
       }
 
-    GetMatrix() = 0.0;
-    DoAssemble(lh);
+    if (!precompute || !AssembleFromParameterCache(lh))
+      {
+        GetMatrix() = 0.0;
+        DoAssemble(lh);
+      }
 
     if (galerkin)
       GalerkinProjection();
   }
 
+
+  bool BilinearForm :: AssembleFromParameterCache (LocalHeap & lh)
+  {
+    // the matrix must be the plain sum of element matrices
+    if (eliminate_internal || eliminate_hidden || diagonal ||
+        preconditioners.Size() || specialelements.Size())
+      return false;
+
+    auto get_value = [] (const ParameterTerm & term)
+      {
+        if (term.region == -1)
+          return static_cast<ParameterCoefficientFunction<double>*> (term.cf) -> GetValue();
+        return (*static_cast<DomainConstantCoefficientFunction*> (term.cf)) [term.region];
+      };
+    auto set_value = [] (const ParameterTerm & term, double val)
+      {
+        if (term.region == -1)
+          static_cast<ParameterCoefficientFunction<double>*> (term.cf) -> SetValue(val);
+        else
+          static_cast<DomainConstantCoefficientFunction*> (term.cf) -> SetValue(term.region, val);
+      };
+
+    shared_ptr<BaseMatrix> mat = GetMatrixPtr();
+    if (auto parmat = dynamic_pointer_cast<ParallelMatrix> (mat))
+      mat = parmat->GetMatrix();
+    BaseVector & matvec = mat->AsVector();
+
+    // values of a mesh deformation can change without a new timestamp
+    if (ma->GetDeformation()) return false;
+
+    // the stored matrices depend on the graph, the geometry and the integrators
+    bool same_parts = parameter_parts.Size() == parts.Size();
+    for (size_t i = 0; same_parts && i < parts.Size(); i++)
+      same_parts = parameter_parts[i] == parts[i].get();
+    
+    if (parameter_timestamp != graph_timestamp ||
+        parameter_mesh_timestamp != ma->GetTimeStamp() ||
+        parameter_curve_order != ma->GetCurveOrder() || !same_parts)
+      {
+        parameter_timestamp = 0;
+        parameter_terms.SetSize0();
+        parameter_const = nullptr;
+        
+        Array<CoefficientFunction*> params;
+        for (auto & bfi : parts)
+          {
+            shared_ptr<CoefficientFunction> cf;
+            if (auto symbfi = dynamic_pointer_cast<SymbolicBilinearFormIntegrator> (bfi))
+              cf = symbfi->GetCoefficientFunction();
+            if (auto symbfi = dynamic_pointer_cast<SymbolicFacetBilinearFormIntegrator> (bfi))
+              cf = symbfi->GetCoefficientFunction();
+            if (!cf || bfi->GetDeformation()) return false;
+            int deg = ParameterDegree (*cf, params);
+            if (deg < 0 || deg > 1) return false;
+          }
+        if (params.Size() == 0) return false;
+
+        static Timer t("BilinearForm::BuildParameterCache");
+        RegionTimer reg(t);
+        
+        for (auto cf : params)
+          if (auto par = dynamic_cast<ParameterCoefficientFunction<double>*> (cf))
+            parameter_terms.Append ( ParameterTerm { cf, -1, par->GetValue(), nullptr } );
+          else
+            {
+              auto dcf = static_cast<DomainConstantCoefficientFunction*> (cf);
+              for (int i = 0; i < dcf->NumRegions(); i++)
+                parameter_terms.Append ( ParameterTerm { cf, i, (*dcf)[i], nullptr } );
+            }
+        cout << IM(3) << "assemble " << parameter_terms.Size()+1
+             << " matrices for the parameter cache" << endl;
+
+        // restore the user's values, also if assembling throws
+        struct RestoreParameters
+        {
+          Array<ParameterTerm> & terms;
+          decltype(set_value) & set;
+          ~RestoreParameters ()
+          {
+            for (auto & term : terms)
+              set (term, term.value);
+          }
+        } restore { parameter_terms, set_value };
+
+        // all parameters zero, then one parameter after the other
+        for (auto & term : parameter_terms)
+          set_value (term, 0.0);
+        
+        matvec = 0.0;
+        DoAssemble (lh);
+        parameter_const = matvec.CreateVector();
+        *parameter_const = matvec;
+
+        for (auto & term : parameter_terms)
+          {
+            set_value (term, 1.0);
+            matvec = 0.0;
+            DoAssemble (lh);
+            term.matvec = matvec.CreateVector();
+            *term.matvec = matvec - *parameter_const;
+            set_value (term, 0.0);
+          }
+
+        parameter_timestamp = graph_timestamp;
+        parameter_mesh_timestamp = ma->GetTimeStamp();
+        parameter_curve_order = ma->GetCurveOrder();
+        parameter_parts.SetSize0();
+        for (auto & bfi : parts)
+          parameter_parts.Append (bfi.get());
+      }
+
+    static Timer t("BilinearForm::AssembleFromParameterCache");
+    RegionTimer reg(t);
+    
+    matvec = *parameter_const;
+    for (auto & term : parameter_terms)
+      {
+        term.value = get_value (term);
+        if (term.value != 0.0)
+          matvec += term.value * *term.matvec;
+      }
+    return true;
+  }
+
   shared_ptr<BaseMatrix> BilinearForm :: GetMatrixPtr () const
   {
     if (!mats.Size())
@@ -1043,6 +1424,44 @@ namespace ngcomp
 
 
 
+  // same shape functions, such that element matrices can be computed in one batch ?
+  static bool SameShapes (const FiniteElement & fel1, const FiniteElement & fel2)
+  {
+    if (typeid(fel1) != typeid(fel2) || fel1.GetNDof() != fel2.GetNDof() ||
+        fel1.Order() != fel2.Order())
+      return false;
+    
+    if (auto cfel1 = dynamic_cast<const CompoundFiniteElement*> (&fel1))
+      {
+        auto & cfel2 = static_cast<const CompoundFiniteElement&> (fel2);
+        if (cfel1->GetNComponents() != cfel2.GetNComponents())
+          return false;
+        for (int i = 0; i < cfel1->GetNComponents(); i++)
+          if (!SameShapes ((*cfel1)[i], cfel2[i]))
+            return false;
+        return true;
+      }
+    
+    if (auto sfel1 = dynamic_cast<const BaseScalarFiniteElement*> (&fel1))
+      {
+        // orientation dependent shape functions differ at a generic point
+        auto & sfel2 = static_cast<const BaseScalarFiniteElement&> (fel2);
+        size_t ndof = fel1.GetNDof();
+        IntegrationPoint ip(0.1127, 0.2083, 0.3271);
+        ArrayMem<double,200> mem(2*ndof);
+        FlatVector<> shape1(ndof, mem.Data()), shape2(ndof, mem.Data()+ndof);
+        sfel1->CalcShape (ip, shape1);
+        sfel2.CalcShape (ip, shape2);
+        for (size_t i = 0; i < ndof; i++)
+          if (fabs (shape1(i)-shape2(i)) > 1e-12 * (1+fabs(shape1(i))))
+            return false;
+        return true;
+      }
+    
+    return false;
+  }
+
+
   template <class SCAL>
   void S_BilinearForm<SCAL> :: DoAssemble (LocalHeap & clh)
   {
@@ -1232,8 +1651,10 @@ namespace ngcomp
                           innermatrix = make_shared<ElementByElementMatrix<SCAL>>(ndof, ne);
                       }
                     */
-                    IterateElements
-                      (*fespace, vb, clh,  [&] (FESpace::Element el, LocalHeap & lh)
+                    ElementContributions<SCAL> * contributions = nullptr;
+                    
+                    auto assemble_element = [&] (FESpace::Element el, LocalHeap & lh,
+                                                 FlatMatrix<SCAL> * precomputed)
                        {
                          if (elmat_ev && vb == VOL) 
                            *testout << " Assemble Element " << el.Nr() << endl;  
@@ -1262,7 +1683,12 @@ namespace ngcomp
                          static Timer elmattimer("calc elmats", 2);
                          ThreadRegionTimer reg (elmattimer, TaskManager::GetThreadId());
                          
-                         if (printelmat || elmat_ev)
+                         if (precomputed)
+                           {
+                             sum_elmat = *precomputed;
+                             elem_has_integrator = true;
+                           }
+                         else if (printelmat || elmat_ev)
                            {
                              // need every part of the element matrix
                              sum_elmat = 0;
@@ -1678,6 +2104,14 @@ namespace ngcomp
                              *testout<< "elem " << el << ", elmat = " << endl << sum_elmat << endl;
                            }
                          
+                         if (contributions)
+                           {
+                             // added by the row owners, see below
+                             contributions->Add (el, dnums, FlatArray<SCAL> (sum_elmat.Height()*sum_elmat.Width(),
+                                                                             sum_elmat.Data()));
+                             return;
+                           }
+                         
                          AddElementMatrix (dnums, dnums, sum_elmat, el, lh);
 			 
                          for (auto pre : preconditioners)
@@ -1691,7 +2125,124 @@ namespace ngcomp
                                if (IsRegularDof(d)) useddof[d] = true;
                            }
                          // timer3_VB[vb].Stop();
-                       });
+                       };
+
+                    bool batched = batch_assembly && is_same<SCAL,double>::value &&
+                      vb == VOL && !printelmat && !elmat_ev && fespace->GetDimension() == 1;
+                    for (auto & bfi : VB_parts[vb])
+                      if (bfi->GetDeformation()) batched = false;
+
+                    if (batched)
+                      IterateElementBatches
+                        (*fespace, vb, clh, SIMD<double>::Size(),
+                         [&] (FlatArray<ElementId> ids, LocalHeap & lh)
+                         {
+                           size_t nb = ids.Size();
+                           ArrayMem<const FiniteElement*,8> fels(nb);
+                           ArrayMem<const ElementTransformation*,8> trafos(nb);
+                           ArrayMem<FlatMatrix<SCAL>,8> elmats(nb);
+                           for (size_t i = 0; i < nb; i++)
+                             {
+                               fels[i] = &fespace->GetFE (ids[i], lh);
+                               trafos[i] = &ma->GetTrafo (ids[i], lh);
+                             }
+
+                           bool use_batch = true;
+                           for (size_t i = 1; i < nb; i++)
+                             if (!SameShapes (*fels[0], *fels[i]))
+                               use_batch = false;
+
+                           bool has_integrator = false;
+                           int index = ma->GetElIndex (ids[0]);
+                           for (auto & bfi : VB_parts[vb])
+                             {
+                               if (!bfi->DefinedOn (index)) continue;
+                               has_integrator = true;
+                               for (auto id : ids)
+                                 if (!bfi->DefinedOnElement (id.Nr()))
+                                   use_batch = false;
+                             }
+                           use_batch &= has_integrator;
+
+                           if (use_batch)
+                             {
+                               size_t elmat_size = fels[0]->GetNDof();
+                               for (auto & elmat : elmats)
+                                 {
+                                   elmat.AssignMemory (elmat_size, elmat_size, lh);
+                                   elmat = SCAL(0.0);
+                                 }
+                               if constexpr (is_same<SCAL,double>::value)
+                                 for (auto & bfi : VB_parts[vb])
+                                   if (bfi->DefinedOn (index))
+                                     if (!bfi->CalcElementMatrixBatch (*fels[0], trafos, elmats, lh))
+                                       {
+                                         use_batch = false;
+                                         break;
+                                       }
+                             }
+
+                           ArrayMem<int,100> temp_dnums;
+                           ArrayMem<DofId,800> batch_dnums;
+                           ArrayMem<size_t,9> first;
+                           fespace->GetDofNrs (ids, batch_dnums, first);
+                           for (size_t i = 0; i < nb; i++)
+                             {
+                               HeapReset hr(lh);
+                               FESpace::Element el(*fespace, ids[i], temp_dnums, lh);
+                               el.SetDofs (batch_dnums.Range(first[i], first[i+1]));
+                               assemble_element (move(el), lh, use_batch ? &elmats[i] : nullptr);
+                             }
+                         });
+                    else if (owner_assembly && !preconditioners.Size() && !printelmat && !elmat_ev &&
+                             !(linearform && !keep_internal) &&
+                             dynamic_pointer_cast<BaseSparseMatrix> (mats.Last()))
+                      {
+                        /*
+                          no coloring: contiguous chunks of elements compute element 
+                          matrices into thread-private buffers, then every range of rows 
+                          is summed up by one task. 
+                        */
+                        ElementContributions<SCAL> elcontribs;
+                        contributions = &elcontribs;
+
+                        // at most 16M scalars buffered per wave
+                        IterateElementChunks
+                          (*fespace, vb, clh, 16*1024*1024,
+                           [&] (ElementId ei)
+                           {
+                             ArrayMem<DofId,100> dnums;
+                             fespace->GetDofNrs (ei, dnums);
+                             size_t n = dnums.Size()*fespace->GetDimension();
+                             return n*n;
+                           },
+                           [&] (FESpace::Element el, LocalHeap & lh)
+                           {
+                             assemble_element (move(el), lh, nullptr);
+                           },
+                           [&] ()
+                           {
+                             elcontribs.ReduceByOwner
+                               (ndof, clh, [&] (ElementId ei, FlatArray<DofId> dnums, FlatArray<SCAL> vals,
+                                                IntRange rows, LocalHeap & lh)
+                                {
+                                  size_t n = dnums.Size()*fespace->GetDimension();
+                                  AddElementMatrixRows (dnums, FlatMatrix<SCAL>(n, n, vals.Data()), rows, ei, lh);
+                                  if (check_unused)
+                                    for (auto d : dnums)
+                                      if (IsRegularDof(d) && size_t(d) >= rows.First() && size_t(d) < rows.Next())
+                                        useddof[d] = true;
+                                });
+                             elcontribs.Clear();
+                           });
+                        contributions = nullptr;
+                      }
+                    else
+                      IterateElements
+                        (*fespace, vb, clh,  [&] (FESpace::Element el, LocalHeap & lh)
+                         {
+                           assemble_element (move(el), lh, nullptr);
+                         });
                     progress.Done();
                     
                     /*
@@ -5984,6 +6535,17 @@ namespace ngcomp
     mymatrix -> TMATRIX::AddElementMatrixSymmetric (dnums1, elmat, this->fespace->HasAtomicDofs());
   }
 
+  template <class TM, class TV>
+  void T_BilinearFormSymmetric<TM,TV> :: 
+  AddElementMatrixRows (FlatArray<int> dnums,
+                        BareSliceMatrix<TSCAL> elmat,
+                        IntRange rows,
+                        ElementId id, 
+                        LocalHeap & lh) 
+  {
+    mymatrix -> TMATRIX::AddElementMatrixSymmetricRows (dnums, elmat, rows);
+  }
+
 
 
 
@@ -34,6 +34,12 @@ namespace ngcomp
     bool diagonal;
     /// element-matrix for ref-elements
     bool geom_free;
+    /// compute element matrices of batches of elements in SIMD lanes
+    bool batch_assembly = false;
+    /// assemble without element coloring, reduction by the owners of row ranges
+    bool owner_assembly = false;
+    /// build the matrix graph node by node, if the dofs are node-based
+    bool nodal_graph = true;
     /// store matrices on mesh hierarchy
     bool multilevel;
     /// galerkin projection of coarse grid matrices
@@ -112,6 +118,25 @@ namespace ngcomp
     bool precompute;
     /// precomputed element-wise data
     Array<void*> precomputed_data;
+    /// a parameter value (region = -1 for ParameterCF), and its part of the matrix
+    struct ParameterTerm
+    {
+      CoefficientFunction * cf;
+      int region;
+      double value;
+      shared_ptr<BaseVector> matvec;
+    };
+    /// for precompute: form is affine in parameters, matrix values of the terms
+    Array<ParameterTerm> parameter_terms;
+    /// matrix values with all parameters zero
+    shared_ptr<BaseVector> parameter_const;
+    /// graph timestamp of the stored matrices
+    size_t parameter_timestamp = 0;
+    /// mesh timestamp and curve order of the stored matrices
+    size_t parameter_mesh_timestamp = 0;
+    int parameter_curve_order = 0;
+    /// integrators of the stored matrices
+    Array<BilinearFormIntegrator*> parameter_parts;
     /// output of norm of matrix entries
     bool checksum;
     
@@ -208,6 +233,10 @@ namespace ngcomp
     /// if reallocate is false, the existing matrix is reused
     void ReAssemble (LocalHeap & lh, bool reallocate = 0);
 
+    /// matrix as linear combination of stored matrices, if the form is affine in 
+    /// its ParameterCFs and DomainConstantCFs. Returns false if not applicable
+    bool AssembleFromParameterCache (LocalHeap & lh);
+
     /// assembles matrix at linearization point given by lin
     /// needed for Newton's method
     virtual void AssembleLinearization (const BaseVector & lin,
@@ -573,6 +602,20 @@ namespace ngcomp
 				   ElementId id, 
 				   LocalHeap & lh) = 0;
 
+    /// adds only the rows dnums[i] in rows, see owner_assembly
+    virtual void AddElementMatrixRows (FlatArray<int> dnums,
+                                       BareSliceMatrix<SCAL> elmat,
+                                       IntRange rows,
+                                       ElementId id, 
+                                       LocalHeap & lh)
+    {
+      FlatArray<int> rowdnums(dnums.Size(), lh);
+      for (size_t i = 0; i < dnums.Size(); i++)
+        rowdnums[i] = (IsRegularDof(dnums[i]) && size_t(dnums[i]) >= rows.First()
+                       && size_t(dnums[i]) < rows.Next()) ? dnums[i] : NO_DOF_NR;
+      AddElementMatrix (rowdnums, dnums, elmat, id, lh);
+    }
+
     /*
     virtual void ApplyElementMatrix(const BaseVector & x,
 				    BaseVector & y,
@@ -709,6 +752,11 @@ namespace ngcomp
                                    BareSliceMatrix<TSCAL> elmat,
 				   ElementId id, 
 				   LocalHeap & lh) override;
+    virtual void AddElementMatrixRows (FlatArray<int> dnums,
+                                       BareSliceMatrix<TSCAL> elmat,
+                                       IntRange rows,
+                                       ElementId id, 
+                                       LocalHeap & lh) override;
     /*
     virtual void ApplyElementMatrix(const BaseVector & x,
 				    BaseVector & y,
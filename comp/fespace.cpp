@@ -41,6 +41,7 @@ namespace ngcomp
     DefineNumFlag ("definedonbound");
     DefineStringListFlag ("definedonbound");
     DefineDefineFlag("dgjumps");
+    DefineDefineFlag("cachedofs");
 
     order = int (flags.GetNumFlag ("order", 1));
 
@@ -78,6 +79,7 @@ namespace ngcomp
     timing = flags.GetDefineFlag("timing");
     print = flags.GetDefineFlag("print");
     dgjumps = flags.GetDefineFlag("dgjumps");
+    cache_dofs = flags.GetDefineFlag("cachedofs");
     no_low_order_space = flags.GetDefineFlagX("low_order_space").IsFalse() ||
       flags.GetDefineFlag("no_low_order_space");
     if (dgjumps) 
@@ -367,6 +369,9 @@ lot of new non-zero entries in the matrix!\n" << endl;
     docu.Arg("low_order_space") = "bool = True\n"
       "  Generate a lowest order space together with the high-order space,\n"
       "  needed for some preconditioners.";
+    docu.Arg("cachedofs") = "bool = False\n"
+      "  Keep a compressed element-to-dof table, which is used by assembly\n"
+      "  and evaluation instead of recomputing the element dofs.";
     docu.Arg("order_policy") = "ORDER_POLICY = ORDER_POLICY.OLDSTYLE\n"
       "  CONSTANT .. use the same fixed order for all elements,\n"
       "  NODAL ..... use the same order for nodes of same shape,\n"
@@ -400,6 +405,10 @@ lot of new non-zero entries in the matrix!\n" << endl;
     
     ma->UpdateBuffers();  // is free if netgen-mesh did not change
     int dim = ma->GetDimension();
+
+    // element dofs are about to change, cache is rebuilt in FinalizeUpdate
+    for (auto & cache : dof_cache)
+      cache = Table<DofId>();
     
     dirichlet_vertex.SetSize (ma->GetNV());
     dirichlet_edge.SetSize (ma->GetNEdges());
@@ -464,6 +473,157 @@ lot of new non-zero entries in the matrix!\n" << endl;
   }
 
 
+  /*
+    Parallel speculative coloring of n items, items sharing a dof get 
+    different colors. Contiguous ranges of items are colored by one task, 
+    claiming the color at every dof by an atomic fetch_or. Whoever finds 
+    the bit already set lost the race and is recolored in the next round 
+    (iterative conflict resolution). Colors are handled in windows of 64.
+    Among the admissible colors the least used one is taken, this 
+    balances the color classes. Within a color, items are sorted by
+    sortkey (e.g. smallest vertex number) for locality.
+    get_dofs returns false if the item is not to be colored.
+  */
+  static Table<int> ParallelColoring (size_t n, size_t ndof,
+                                      const function<bool(size_t,Array<DofId>&)> & get_dofs,
+                                      FlatArray<int> sortkey)
+  {
+    static Timer t("FESpace - parallel coloring");
+    RegionTimer reg(t);
+    
+    Array<int> col(n);
+    col = -1;
+    Array<uint64_t> mask(ndof);
+    Array<size_t> cnt;     // size of color classes
+
+    Array<size_t> work;
+    for (size_t i = 0; i < n; i++) work.Append(i);
+
+    int basecol = 0;
+    mutex merge_mutex;
+    
+    while (work.Size())
+      {
+        ParallelForRange (ndof, [&] (IntRange r) { mask[r] = 0; });
+        Array<atomic<size_t>> wcnt(64);
+        for (auto & c : wcnt) c = 0;
+        atomic<int> nused(0);    // colors used in this window
+        Array<size_t> deferred;  // all 64 colors are taken at some dof
+
+        while (work.Size())
+          {
+            Array<size_t> retry;
+            atomic<size_t> colored(0);
+            
+            ParallelForRange (work.Size(), [&] (IntRange r)
+              {
+                Array<DofId> dofs;
+                Array<size_t> myretry, mydeferred;
+                size_t mycolored = 0;
+                for (auto k : r)
+                  {
+                    size_t i = work[k];
+                    if (!get_dofs (i, dofs)) continue;
+                    QuickSort (dofs);
+                    for (int j = dofs.Size()-1; j > 0; j--)
+                      if (dofs[j] == dofs[j-1]) dofs.DeleteElement(j);
+
+                    uint64_t check = 0;
+                    for (auto d : dofs)
+                      check |= AsAtomic(mask[d]).load(memory_order_relaxed);
+                    if (check == ~uint64_t(0))
+                      {
+                        mydeferred.Append(i);
+                        continue;
+                      }
+
+                    // least used admissible color, or a new one
+                    int c = -1;
+                    int nu = nused;
+                    for (int cc = 0; cc < nu; cc++)
+                      if ( !(check & (uint64_t(1) << cc)) &&
+                           (c == -1 || wcnt[cc] < wcnt[c]) )
+                        c = cc;
+                    if (c == -1)
+                      {
+                        c = 0;
+                        while (check & (uint64_t(1) << c)) c++;
+                        int prev = nu;
+                        while (prev < c+1 && !nused.compare_exchange_weak(prev, c+1)) ;
+                      }
+                    uint64_t bit = uint64_t(1) << c;
+
+                    bool ok = true;
+                    for (auto d : dofs)
+                      if (AsAtomic(mask[d]).fetch_or(bit) & bit)
+                        ok = false;
+
+                    if (ok)
+                      {
+                        col[i] = basecol + c;
+                        wcnt[c]++;
+                        mycolored++;
+                      }
+                    else
+                      myretry.Append(i);
+                  }
+                colored += mycolored;
+                lock_guard<mutex> guard(merge_mutex);
+                retry += myretry;
+                deferred += mydeferred;
+              });
+
+            if (colored == 0 && retry.Size())
+              {
+                // no progress, resolve the remaining conflicts sequentially
+                Array<DofId> dofs;
+                for (auto i : retry)
+                  {
+                    get_dofs (i, dofs);
+                    uint64_t check = 0;
+                    for (auto d : dofs) check |= mask[d];
+                    if (check == ~uint64_t(0))
+                      {
+                        deferred.Append(i);
+                        continue;
+                      }
+                    int c = 0;
+                    while (check & (uint64_t(1) << c)) c++;
+                    for (auto d : dofs) mask[d] |= uint64_t(1) << c;
+                    col[i] = basecol + c;
+                    wcnt[c]++;
+                    if (c+1 > nused) nused = c+1;
+                  }
+                retry.SetSize0();
+              }
+            QuickSort (retry);   // keep contiguous ranges per task
+            work = std::move(retry);
+          }
+
+        for (int c = 0; c < nused; c++)
+          cnt.Append (wcnt[c]);
+        QuickSort (deferred);
+        work = std::move(deferred);
+        basecol += 64;
+      }
+
+    TableCreator<int> creator(cnt.Size());
+    for ( ; !creator.Done(); creator++)
+      for (size_t i = 0; i < n; i++)
+        if (col[i] >= 0)
+          creator.Add (col[i], i);
+    Table<int> coloring = creator.MoveTable();
+
+    if (sortkey.Size())
+      ParallelFor (coloring.Size(), [&] (size_t c)
+        {
+          QuickSort (coloring[c], [&] (int a, int b)
+                     { return sortkey[a] < sortkey[b] || (sortkey[a] == sortkey[b] && a < b); });
+        });
+    return coloring;
+  }
+
+  
   void FESpace :: FinalizeUpdate()
   {
     static Timer timer ("FESpace::FinalizeUpdate");
@@ -478,6 +638,7 @@ lot of new non-zero entries in the matrix!\n" << endl;
     if (low_order_space) low_order_space -> FinalizeUpdate();
 
     RegionTimer reg (timer);
+    UpdateDofCache();
     // timer1.Start();
     dirichlet_dofs.SetSize (GetNDof());
     dirichlet_dofs.Clear();
@@ -589,10 +750,6 @@ lot of new non-zero entries in the matrix!\n" << endl;
       }
     else
       {
-        // tcolmutex.Start();
-      Array<MyMutex> locks(GetNDof());
-      // tcolmutex.Stop();
-      
       for (auto vb : { VOL, BND, BBND, BBBND })
       {
         /*
@@ -673,104 +830,31 @@ lot of new non-zero entries in the matrix!\n" << endl;
 
 
 
-        // tcol.Start();
-        Array<int> col(ma->GetNE(vb));
-        col = -1;
-
-        int maxcolor = 0;
-        
-        int basecol = 0;
-        Array<unsigned int> mask(GetNDof());
-
-        atomic<int> found(0);
-        size_t cnt = 0;
-        for (ElementId el : Elements(vb)) { cnt++; (void)el; } // no warning 
-
-        while (found < cnt)
+        size_t ne = ma->GetNE(vb);
+        Array<int> minvertex(ne);
+        ParallelFor (ne, [&] (size_t nr)
           {
-            // mask = 0   | tasks;
-
-            ParallelForRange
-              (mask.Size(),
-               [&] (IntRange myrange) { mask[myrange] = 0; });
-
-            size_t ne = ma->GetNE(vb);
-
-            ParallelForRange
-              (ne, [&] (IntRange myrange)
-               {
-                 Array<DofId> dofs;
-                 size_t myfound = 0;
-                 
-                 for (size_t nr : myrange)
-                   {
-                     ElementId el = { vb, nr };
-                     if (!DefinedOn(el)) continue;
-                     if (col[el.Nr()] >= 0) continue;
-                     
-                     unsigned check = 0;
-                     GetDofNrs(el, dofs);
-                     
-                     if (HasAtomicDofs())
-                       {
-                         for (int i = dofs.Size()-1; i >= 0; i--)
-                           if (!IsRegularDof(dofs[i]) || IsAtomicDof(dofs[i])) dofs.DeleteElement(i);
-                       }
-                     else
-                       for (int i = dofs.Size()-1; i >= 0; i--)
-                         if (!IsRegularDof(dofs[i])) dofs.DeleteElement(i);
-                     QuickSort (dofs);   // sort to avoid dead-locks
-                     
-                     for (auto d : dofs) 
-                       locks[d].lock();
-                     
-                     for (auto d : dofs) 
-                       check |= mask[d];
-                     
-                     if (check != UINT_MAX) // 0xFFFFFFFF)
-                       {
-                         myfound++;
-                         unsigned checkbit = 1;
-                         int color = basecol;
-                         while (check & checkbit)
-                           {
-                             color++;
-                             checkbit *= 2;
-                           }
-                         
-                         col[el.Nr()] = color;
-                         if (color > maxcolor) maxcolor = color;
-                         
-                         for (auto d : dofs) // el.GetDofs())
-                           mask[d] |= checkbit;
-                       }
-                     
-                     for (auto d : dofs) 
-                       locks[d].unlock();
-                   }
-                 found += myfound;
-               });
-                 
-            basecol += 8*sizeof(unsigned int); // 32;
-          }
-
-        // tcol.Stop();
-
-        Array<int> cntcol(maxcolor+1);
-        cntcol = 0;
-
-        for (ElementId el : Elements(vb))
-          cntcol[col[el.Nr()]]++;
-        
-        Table<int> & coloring = element_coloring[vb];
-        coloring = Table<int> (cntcol);
+            auto verts = ma->GetElement(ElementId(vb,nr)).Vertices();
+            int mv = numeric_limits<int>::max();
+            for (auto v : verts) mv = min2(mv, int(v));
+            minvertex[nr] = mv;
+          });
 
-	cntcol = 0;
-        for (ElementId el : Elements(vb))
-          coloring[col[el.Nr()]][cntcol[col[el.Nr()]]++] = el.Nr();
+        element_coloring[vb] = ParallelColoring
+          (ne, GetNDof(),
+           [&] (size_t nr, Array<DofId> & dofs)
+           {
+             ElementId el(vb, nr);
+             if (!DefinedOn(el)) return false;
+             GetDofNrs(el, dofs);
+             for (int i = dofs.Size()-1; i >= 0; i--)
+               if (!IsRegularDof(dofs[i]) || (HasAtomicDofs() && IsAtomicDof(dofs[i])))
+                 dofs.DeleteElement(i);
+             return true;
+           }, minvertex);
         
         if (print)
-          *testout << "needed " << maxcolor+1 << " colors" 
+          *testout << "needed " << element_coloring[vb].Size() << " colors" 
                    << " for " << ((vb == VOL) ? "vol" : "bnd") << endl;
       }
       }
@@ -789,89 +873,41 @@ lot of new non-zero entries in the matrix!\n" << endl;
     if (facet_coloring.Size()) return facet_coloring;
 
     size_t nf = ma->GetNFacets();
-    Array<int> col(nf);
-    col = -1;
-    
-    int maxcolor = 0;
-    int basecol = 0;
-    Array<unsigned int> mask(GetNDof());
 
-    size_t cnt = nf, found = 0;
-    Array<DofId> dofs, dofs1;
-    Array<int> elnums, elnums_per;
-    
-    do
-      {
-        mask = 0;
-        for (size_t f = 0; f < nf; f++)
-          {
-            if (col[f] >= 0) continue;
-            
-            ma->GetFacetElements(f,elnums);
-            dofs.SetSize0();
-
-            if (elnums.Size() == 1)
-              {
-                size_t f2 = ma->GetPeriodicFacet(f);
-                // if (f2 < f) continue;
-                if (f2 != f) // color both, left and right facet
-                  {
-                    ma->GetFacetElements (f2, elnums_per);
-		    // if the facet is identified across subdomain
-		    // boundary, we only have the surface element
-		    // and not the other volume element!
-		    // that case does not impact coloring
-		    if (elnums_per.Size())
-		      elnums.Append(elnums_per[0]);
-                  }
-              }
-            for (auto el : elnums)
-              {
-                GetDofNrs(ElementId(VOL, el), dofs1);
-                dofs += dofs1;
-              }
-            
-            unsigned check = 0;
-            for (auto d : dofs)
-              if (IsRegularDof(d)) check |= mask[d];
-            
-            if (check != UINT_MAX) // 0xFFFFFFFF)
-              {
-                found++;
-                unsigned checkbit = 1;
-                int color = basecol;
-                while (check & checkbit)
-                  {
-                    color++;
-                    checkbit *= 2;
-                  }
-                
-                col[f] = color;
-                if (color > maxcolor) maxcolor = color;
-		
-                for (auto d : dofs)
-                  if (IsRegularDof(d)) mask[d] |= checkbit;
-              }
-          }
-        
-        basecol += 8*sizeof(unsigned int); // 32;
-      }
-    while (found < cnt);
-
-    Array<int> cntcol(maxcolor+1);
-    cntcol = 0;
-    
-    for (auto f : Range(nf))
-      cntcol[col[f]]++;
-    
-    const_cast<Table<int>&> (facet_coloring) = Table<int> (cntcol);
-    
-    cntcol = 0;
-    for (auto f : Range(nf))          
-      facet_coloring[col[f]][cntcol[col[f]]++] = f;
+    const_cast<Table<int>&> (facet_coloring) = ParallelColoring
+      (nf, GetNDof(),
+       [&] (size_t f, Array<DofId> & dofs)
+       {
+         ArrayMem<int,4> elnums, elnums_per;
+         ArrayMem<DofId,100> dofs1;
+         ma->GetFacetElements(f,elnums);
+         dofs.SetSize0();
+         
+         if (elnums.Size() == 1)
+           {
+             size_t f2 = ma->GetPeriodicFacet(f);
+             if (f2 != f) // color both, left and right facet
+               {
+                 ma->GetFacetElements (f2, elnums_per);
+                 // if the facet is identified across subdomain
+                 // boundary, we only have the surface element
+                 // and not the other volume element!
+                 // that case does not impact coloring
+                 if (elnums_per.Size())
+                   elnums.Append(elnums_per[0]);
+               }
+           }
+         for (auto el : elnums)
+           {
+             GetDofNrs(ElementId(VOL, el), dofs1);
+             for (auto d : dofs1)
+               if (IsRegularDof(d)) dofs.Append(d);
+           }
+         return true;
+       }, Array<int>());
 
     if (print)
-      *testout << "needed " << maxcolor+1 << " colors for facet-coloring" << endl;
+      *testout << "needed " << facet_coloring.Size() << " colors for facet-coloring" << endl;
 
     return facet_coloring;
   }
@@ -1103,7 +1139,7 @@ lot of new non-zero entries in the matrix!\n" << endl;
   void FESpace :: GetDofNrs (ElementId ei, Array<int> & dnums, COUPLING_TYPE ctype) const
   {
     ArrayMem<int,100> alldnums; 
-    GetDofNrs(ei, alldnums);
+    GetCachedDofNrs(ei, alldnums);
     dnums.SetSize(0);
 
     if (ctofdof.Size() == 0)
@@ -1117,10 +1153,112 @@ lot of new non-zero entries in the matrix!\n" << endl;
             dnums.Append(d);
       }
 
+  void FESpace :: GetDofNrs (FlatArray<ElementId> els, Array<DofId> & dnums,
+                             Array<size_t> & first) const
+  {
+    ArrayMem<DofId,100> eldnums;
+    first.SetSize (els.Size()+1);
+    first[0] = 0;
+    dnums.SetSize0();
+    for (size_t i : Range(els))
+      {
+        ElementId ei = els[i];
+        auto & cache = dof_cache[ei.VB()];
+        if (cache.Size() && dof_cache_runs[ei.VB()])
+          {
+            auto runs = cache[ei.Nr()];
+            size_t base = dnums.Size();
+            dnums.SetSize (base + DofRunsSize(runs));
+            ExpandDofRuns (runs, dnums.Data()+base);
+          }
+        else if (cache.Size())
+          dnums.Append (cache[ei.Nr()]);
+        else
+          {
+            GetDofNrs (ei, eldnums);
+            dnums.Append (eldnums);
+          }
+        first[i+1] = dnums.Size();
+      }
+  }
+
+  void FESpace :: UpdateDofCache ()
+  {
+    static Timer t("FESpace::UpdateDofCache");
+    RegionTimer reg(t);
+
+    // calls func(first, count) for runs of consecutive (or equal irregular) dofs
+    auto for_runs = [] (FlatArray<DofId> dnums, auto func)
+      {
+        for (size_t i = 0; i < dnums.Size(); )
+          {
+            DofId inc = IsRegularDof(dnums[i]) ? 1 : 0;
+            size_t j = i+1;
+            while (j < dnums.Size() && dnums[j] == dnums[i] + inc*DofId(j-i))
+              j++;
+            func (dnums[i], DofId(j-i));
+            i = j;
+          }
+      };
+
+    for (auto vb : { VOL, BND, BBND, BBBND })
+      {
+        dof_cache[vb] = Table<DofId>();
+        if (!cache_dofs) continue;
+
+        size_t ne = ma->GetNE(vb);
+        Array<int> nplain(ne), nruns(ne);
+        ParallelForRange (ne, [&] (IntRange r)
+          {
+            Array<DofId> dnums;
+            for (auto i : r)
+              {
+                GetDofNrs (ElementId(vb, i), dnums);
+                nplain[i] = dnums.Size();
+                nruns[i] = 0;
+                for_runs (dnums, [&] (DofId first, DofId cnt) { nruns[i] += 2; });
+              }
+          });
+
+        // runs pay off for high order, plain dofs for low order
+        auto sum = [] (FlatArray<int> cnt)
+          {
+            return ParallelReduce (cnt.Size(),
+                                   [&] (size_t i) { return size_t(cnt[i]); },
+                                   [] (size_t a, size_t b) { return a+b; },
+                                   size_t(0));
+          };
+        bool runs = sum(nruns) < sum(nplain);
+
+        Table<DofId> cache(runs ? nruns : nplain);
+        ParallelForRange (ne, [&] (IntRange r)
+          {
+            Array<DofId> dnums;
+            for (auto i : r)
+              {
+                GetDofNrs (ElementId(vb, i), dnums);
+                if (!runs)
+                  cache[i] = dnums;
+                else
+                  {
+                    size_t pos = 0;
+                    for_runs (dnums, [&] (DofId first, DofId cnt)
+                              {
+                                cache[i][pos++] = first;
+                                cache[i][pos++] = cnt;
+                              });
+                  }
+              }
+          });
+        dof_cache[vb] = move(cache);
+        dof_cache_runs[vb] = runs;
+      }
+  }
+
   void FESpace :: GetElementDofsOfType (ElementId ei, Array<DofId> & dnums, COUPLING_TYPE ctype) const
   {
     ArrayMem<int,100> alldnums; 
-    GetDofNrs(ei, alldnums);
+    GetCachedDofNrs(ei, alldnums);
     dnums.SetSize(0);
     
     if (ctofdof.Size() == 0)
@@ -1690,6 +1828,97 @@ lot of new non-zero entries in the matrix!\n" << endl;
         throw Exception (*ex);
       }
   }
+
+
+  void IterateElementChunks (const FESpace & fes,
+                             VorB vb,
+                             LocalHeap & clh,
+                             size_t wavesize,
+                             const function<size_t(ElementId)> & elsize,
+                             const function<void(FESpace::Element,LocalHeap&)> & func,
+                             const function<void()> & reduce)
+  {
+    size_t ne = fes.GetMeshAccess()->GetNE(vb);
+
+    Array<size_t> sizes(ne);
+    ParallelFor (ne, [&] (size_t nr)
+                 {
+                   ElementId ei(vb, nr);
+                   sizes[nr] = fes.DefinedOn(ei) ? elsize(ei) : 0;
+                 });
+
+    for (size_t first = 0, next; first < ne; first = next)
+      {
+        size_t sum = sizes[first];
+        for (next = first+1; next < ne && sum+sizes[next] <= wavesize; next++)
+          sum += sizes[next];
+        IntRange wave(first, next);
+        ParallelForRange (wave, [&] (IntRange r)
+          {
+            LocalHeap lh = clh.Split();
+            ArrayMem<int,100> temp_dnums;
+            for (auto nr : r)
+              {
+                ElementId ei(vb, nr);
+                if (!fes.DefinedOn(ei)) continue;
+                HeapReset hr(lh);
+                FESpace::Element el(fes, ei, temp_dnums, lh);
+                func (move(el), lh);
+              }
+          }, TasksPerThread(4));
+        reduce();
+      }
+  }
+
+
+  void IterateElementBatches (const FESpace & fes,
+                              VorB vb,
+                              LocalHeap & clh,
+                              size_t batchsize,
+                              const function<void(FlatArray<ElementId>,LocalHeap&)> & func)
+  {
+    auto ma = fes.GetMeshAccess();
+    const Table<int> & element_coloring = fes.ElementColoring(vb);
+
+    for (FlatArray<int> els_of_col : element_coloring)
+      ParallelForRange (IntRange(els_of_col.Size()), [&] (IntRange r)
+      {
+        LocalHeap lh = clh.Split();
+
+        // key: element type | material index | ranks of vertex numbers
+        Array<uint64_t> keys(r.Size());
+        Array<int> index(r.Size());
+        for (size_t i = 0; i < r.Size(); i++)
+          {
+            Ngs_Element ngel = ma->GetElement (ElementId(vb, els_of_col[r.First()+i]));
+            auto verts = ngel.Vertices();
+            uint64_t pattern = 0;
+            for (size_t j = 0; j < verts.Size() && j < 8; j++)
+              {
+                int rank = 0;
+                for (size_t k = 0; k < verts.Size(); k++)
+                  if (verts[k] < verts[j]) rank++;
+                pattern = 8*pattern + min2(rank, 7);
+              }
+            keys[i] = (uint64_t(ngel.GetType()) << 56) + (uint64_t(ngel.GetIndex()) << 24) + pattern;
+            index[i] = i;
+          }
+        QuickSortI (keys, index);
+
+        ArrayMem<ElementId,16> batch;
+        for (size_t i = 0; i < index.Size(); )
+          {
+            uint64_t key = keys[index[i]];
+            batch.SetSize0();
+            for ( ; i < index.Size() && keys[index[i]] == key && batch.Size() < batchsize; i++)
+              batch.Append (ElementId(vb, els_of_col[r.First()+index[i]]));
+
+            HeapReset hr(lh);
+            func (batch, lh);
+          }
+        ProgressOutput::SumUpLocal();
+      });
+  }
   
   /*
   // Aendern, Bremse!!!
@@ -210,6 +210,12 @@ ANY                  1 1 1 1 | 15
     
     Table<int> element_coloring[4]; 
     Table<int> facet_coloring;  // elements on facet in own colors (DG)
+
+    /// keep a compressed element-to-dof table (flag "cachedofs")
+    bool cache_dofs = false;
+    /// element dofs, either plain or as runs (first, count)
+    Table<DofId> dof_cache[4];
+    bool dof_cache_runs[4] = { false, false, false, false };
     Array<COUPLING_TYPE> ctofdof;
 
     shared_ptr<ParallelDofs> paralleldofs;
@@ -337,11 +343,18 @@ ANY                  1 1 1 1 | 15
       INLINE FlatArray<DofId> GetDofs() const
       {
         if (!dofs_set)
-          fes.GetDofNrs (*this, temp_dnums);
+          fes.GetCachedDofNrs (*this, temp_dnums);
         dofs_set = true;
         return temp_dnums;
       }
 
+      /// use dofs gathered beforehand, e.g. by the batched GetDofNrs
+      INLINE void SetDofs (FlatArray<DofId> dofs) const
+      {
+        temp_dnums = dofs;
+        dofs_set = true;
+      }
+
       INLINE const ElementTransformation & GetTrafo() const
       {
         return fes.GetMeshAccess()->GetTrafo (ElementId(*this), lh);
@@ -452,6 +465,48 @@ ANY                  1 1 1 1 | 15
 
     /// get dof-nrs of domain or boundary element elnr
     virtual void GetDofNrs (ElementId ei, Array<DofId> & dnums) const = 0;
+
+    /// get dof-nrs of element, from the dof cache if available
+    INLINE void GetCachedDofNrs (ElementId ei, Array<DofId> & dnums) const
+    {
+      auto & cache = dof_cache[ei.VB()];
+      if (cache.Size() == 0)
+        GetDofNrs (ei, dnums);
+      else if (!dof_cache_runs[ei.VB()])
+        dnums = cache[ei.Nr()];
+      else
+        {
+          dnums.SetSize (DofRunsSize (cache[ei.Nr()]));
+          ExpandDofRuns (cache[ei.Nr()], dnums.Data());
+        }
+    }
+
+    /// dofs of many elements into one buffer, dofs of els[i] are dnums[first[i]..first[i+1])
+    void GetDofNrs (FlatArray<ElementId> els, Array<DofId> & dnums, Array<size_t> & first) const;
+
+    /// build (or drop) the compressed element-to-dof table
+    void UpdateDofCache ();
+    bool HasDofCache () const { return cache_dofs; }
+    void SetDofCache (bool acache_dofs) { cache_dofs = acache_dofs; UpdateDofCache(); }
+
+    static INLINE size_t DofRunsSize (FlatArray<DofId> runs)
+    {
+      size_t n = 0;
+      for (size_t i = 1; i < runs.Size(); i += 2)
+        n += runs[i];
+      return n;
+    }
+
+    static INLINE void ExpandDofRuns (FlatArray<DofId> runs, DofId * dnums)
+    {
+      for (size_t i = 0; i < runs.Size(); i += 2)
+        {
+          DofId first = runs[i];
+          DofId inc = IsRegularDof(first) ? 1 : 0;
+          for (DofId j = 0; j < runs[i+1]; j++)
+            *dnums++ = first + inc*j;
+        }
+    }
     
     virtual void GetDofNrs (NodeId ni, Array<DofId> & dnums) const;
     BitArray GetDofs (Region reg) const;
@@ -887,6 +942,146 @@ ANY                  1 1 1 1 | 15
 			       VorB vb, 
 			       LocalHeap & clh, 
 			       const function<void(FESpace::Element,LocalHeap&)> & func);
+
+  /**
+     Calls func for batches of at most batchsize elements of the same color
+     which share element type, material index and ordering of vertex numbers.
+   */
+  extern NGS_DLL_HEADER void IterateElementBatches (const FESpace & fes,
+                                                    VorB vb,
+                                                    LocalHeap & clh,
+                                                    size_t batchsize,
+                                                    const function<void(FlatArray<ElementId>,LocalHeap&)> & func);
+  /**
+     Element loop without coloring. The elements are processed in waves,
+     the sum of elsize over the elements of a wave is at most wavesize 
+     (or the wave is a single element). Every wave is split into contiguous 
+     chunks, one task per chunk. After every wave, reduce is called 
+     (outside the parallel region).
+   */
+  extern NGS_DLL_HEADER void IterateElementChunks (const FESpace & fes,
+                                                   VorB vb,
+                                                   LocalHeap & clh,
+                                                   size_t wavesize,
+                                                   const function<size_t(ElementId)> & elsize,
+                                                   const function<void(FESpace::Element,LocalHeap&)> & func,
+                                                   const function<void()> & reduce);
+
+  /**
+     Element contributions (dofs and values) stored in thread-private 
+     slabs, for assembling without coloring. ReduceByOwner splits the
+     dofs into disjoint ranges, every range is summed up by one task,
+     so no atomic operations are needed.
+   */
+  template <typename SCAL>
+  class ElementContributions
+  {
+    struct Slab
+    {
+      Array<ElementId> ids;
+      Array<DofId> dnums;
+      Array<SCAL> values;
+      Array<size_t> firstdof { 0 }, firstval { 0 };
+    };
+    Array<Slab> slabs;
+
+  public:
+    ElementContributions () : slabs(TaskManager::GetMaxThreads()) { ; }
+
+    /// called from the element loop, stores into the slab of the thread
+    void Add (ElementId ei, FlatArray<DofId> dnums, FlatArray<SCAL> values)
+    {
+      auto & slab = slabs[TaskManager::GetThreadId()];
+      slab.ids.Append (ei);
+      slab.dnums.Append (dnums);
+      slab.values.Append (values);
+      slab.firstdof.Append (slab.dnums.Size());
+      slab.firstval.Append (slab.values.Size());
+    }
+
+    void Clear ()
+    {
+      for (auto & slab : slabs)
+        {
+          slab.ids.SetSize0();
+          slab.dnums.SetSize0();
+          slab.values.SetSize0();
+          slab.firstdof.SetSize(1);
+          slab.firstval.SetSize(1);
+        }
+    }
+
+    /**
+       add(ei, dnums, values, rows, lh) must add only the contributions
+       to dofs in rows.
+     */
+    void ReduceByOwner (size_t ndof, LocalHeap & clh,
+                        const function<void(ElementId, FlatArray<DofId>, FlatArray<SCAL>,
+                                            IntRange, LocalHeap&)> & add) const
+    {
+      static Timer t("ElementContributions::ReduceByOwner");
+      RegionTimer reg(t);
+      if (ndof == 0) return;
+
+      size_t nranges = min(ndof, size_t(4*TaskManager::GetNumThreads()));
+      size_t rangesize = (ndof+nranges-1) / nranges;
+
+      Array<size_t> first(slabs.Size()+1);
+      first[0] = 0;
+      for (size_t s = 0; s < slabs.Size(); s++)
+        first[s+1] = first[s] + slabs[s].ids.Size();
+
+      auto elnr = [&] (size_t i)
+        {
+          size_t s = 0;
+          while (first[s+1] <= i) s++;
+          return tuple<size_t,size_t> (s, i-first[s]);
+        };
+
+      // elements per range of dofs
+      TableCreator<size_t> creator(nranges);
+      for ( ; !creator.Done(); creator++)
+        ParallelForRange (slabs.Size(), [&] (IntRange r)
+          {
+            for (auto s : r)
+              {
+                auto & slab = slabs[s];
+                for (size_t k = 0; k < slab.ids.Size(); k++)
+                  {
+                    ArrayMem<size_t,32> owners;
+                    for (auto d : slab.dnums.Range(slab.firstdof[k], slab.firstdof[k+1]))
+                      if (IsRegularDof(d))
+                        {
+                          size_t o = d / rangesize;
+                          if (!owners.Contains(o))
+                            {
+                              owners.Append(o);
+                              creator.Add (o, first[s]+k);
+                            }
+                        }
+                  }
+              }
+          });
+      Table<size_t> range2el = creator.MoveTable();
+
+      ParallelFor (nranges, [&] (size_t o)
+        {
+          LocalHeap lh = clh.Split();
+          IntRange rows(o*rangesize, min(ndof, (o+1)*rangesize));
+          for (size_t i : range2el[o])
+            {
+              HeapReset hr(lh);
+              auto [s,k] = elnr(i);
+              auto & slab = slabs[s];
+              add (slab.ids[k],
+                   slab.dnums.Range(slab.firstdof[k], slab.firstdof[k+1]),
+                   slab.values.Range(slab.firstval[k], slab.firstval[k+1]),
+                   rows, lh);
+            }
+        });
+    }
+  };
+
   /*
   template <typename TFUNC>
   inline void IterateElements (const FESpace & fes, 
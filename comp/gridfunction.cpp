@@ -1239,7 +1239,7 @@ namespace ngcomp
     int dim = fes->GetDimension();
     
     ArrayMem<int, 50> dnums;
-    fes->GetDofNrs (ei, dnums);
+    fes->GetCachedDofNrs (ei, dnums);
     
     VectorMem<50> elu(dnums.Size()*dim);
 
@@ -1304,7 +1304,7 @@ namespace ngcomp
     int dim = fes->GetDimension();
     
     ArrayMem<int, 50> dnums;
-    fes->GetDofNrs (ei, dnums);
+    fes->GetCachedDofNrs (ei, dnums);
     
     VectorMem<50, Complex> elu(dnums.Size()*dim);
 
@@ -1364,7 +1364,7 @@ namespace ngcomp
     int dim = fes->GetDimension();
 
     ArrayMem<int, 50> dnums;
-    fes->GetDofNrs (ei, dnums);
+    fes->GetCachedDofNrs (ei, dnums);
     
     VectorMem<50> elu(dnums.Size()*dim);
 
@@ -1427,7 +1427,7 @@ namespace ngcomp
     int dim = fes->GetDimension();
 
     ArrayMem<int, 50> dnums;
-    fes->GetDofNrs (ei, dnums);
+    fes->GetCachedDofNrs (ei, dnums);
     
     VectorMem<50,Complex> elu(dnums.Size()*dim);
 
@@ -1502,7 +1502,7 @@ namespace ngcomp
     int dim = fes->GetDimension();
 
     ArrayMem<int, 50> dnums;
-    fes->GetDofNrs (ei, dnums);
+    fes->GetCachedDofNrs (ei, dnums);
     
     VectorMem<50> elu(dnums.Size()*dim);
 
@@ -1579,7 +1579,7 @@ namespace ngcomp
     int dim = fes.GetDimension();
 
     ArrayMem<int, 50> dnums;
-    fes.GetDofNrs (ei, dnums);
+    fes.GetCachedDofNrs (ei, dnums);
     
     VectorMem<50, Complex> elu(dnums.Size()*dim);
 
@@ -18,6 +18,7 @@ namespace ngcomp
     allocated = false;
     initialassembling = true;
     checksum = flags.GetDefineFlag ("checksum");
+    owner_assembly = flags.GetDefineFlag ("owner_assembly");
     cacheblocksize = 1;
   }
 
@@ -206,6 +207,64 @@ namespace ngcomp
 		// ProgressOutput progress (ma, string("assemble ") + vb_str + string(" element"),ne);
                 ProgressOutput progress (ma, string("assemble ") + ToString(vb) + string(" element"),ne);
 		gcnt += ne;
+
+                bool owner = owner_assembly && !printelvec;
+                for (auto & lfip : VB_parts[vb])
+                  if (lfip->CacheComp() != 0) owner = false;
+                
+                if (owner)
+                  {
+                    // no coloring, element vectors are summed up by the owners of dof ranges
+                    ElementContributions<SCAL> elcontribs;
+                    IterateElementChunks
+                      (*fespace, vb, clh, 16*1024*1024,
+                       [&] (ElementId ei)
+                       {
+                         ArrayMem<DofId,100> dnums;
+                         fespace->GetDofNrs (ei, dnums);
+                         return dnums.Size()*fespace->GetDimension();
+                       },
+                       [&] (FESpace::Element el, LocalHeap & lh)
+                       {
+                         progress.Update();
+                         auto & fel = el.GetFE();
+                         auto & eltrans = el.GetTrafo();
+                         int elvec_size = fel.GetNDof()*fespace->GetDimension();
+                         FlatVector<TSCAL> sum_elvec(elvec_size, lh);
+                         sum_elvec = 0.0;
+                         bool has_integrator = false;
+                         for (auto & lfip : VB_parts[vb])
+                           {
+                             if(!lfip->DefinedOn(el.GetIndex())) continue;
+                             if(!lfip->DefinedOnElement(el.Nr())) continue;
+                             has_integrator = true;
+                             FlatVector<TSCAL> elvec(elvec_size, lh);
+                             auto & mapped_trafo = eltrans.AddDeformation(lfip->GetDeformation().get(), lh);
+                             lfip -> CalcElementVector (fel, mapped_trafo, elvec, lh);
+                             sum_elvec += elvec;
+                           }
+                         if (!has_integrator) return;
+                         fespace->TransformVec (el, sum_elvec, TRANSFORM_RHS);
+                         elcontribs.Add (el, el.GetDofs(), FlatArray<TSCAL>(elvec_size, sum_elvec.Data()));
+                       },
+                       [&] ()
+                       {
+                         elcontribs.ReduceByOwner
+                           (fespace->GetNDof(), clh,
+                            [&] (ElementId ei, FlatArray<DofId> dnums, FlatArray<TSCAL> vals,
+                                 IntRange rows, LocalHeap & lh)
+                            {
+                              FlatArray<DofId> rowdnums(dnums.Size(), lh);
+                              for (size_t i = 0; i < dnums.Size(); i++)
+                                rowdnums[i] = (IsRegularDof(dnums[i]) && size_t(dnums[i]) >= rows.First()
+                                               && size_t(dnums[i]) < rows.Next()) ? dnums[i] : NO_DOF_NR;
+                              AddElementVector (rowdnums, FlatVector<TSCAL>(vals.Size(), vals.Data()));
+                            });
+                         elcontribs.Clear();
+                       });
+                    continue;
+                  }
+                
 		IterateElements
 		  (*fespace,vb,clh,[&] (FESpace::Element el, LocalHeap &lh)
 		   {
@@ -37,6 +37,8 @@ namespace ngcomp
     int cacheblocksize;
     /// output of norm of matrix entries
     bool checksum;
+    /// assemble without element coloring, reduction by the owners of dof ranges
+    bool owner_assembly;
 
   public:
     ///
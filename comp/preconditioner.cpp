@@ -263,6 +263,10 @@ namespace ngcomp
       {
 	sm = make_shared<AnisotropicSmoother> (*ma, *lo_bfa);
       }
+    else if (smoothertype == "chebyshev")
+      {
+	sm = make_shared<ChebyshevSmoother> (*ma, *lo_bfa, flags);
+      }
     else if (smoothertype == "block") 
       {
 	if (!lfconstraint)
@@ -360,6 +364,10 @@ namespace ngcomp
       {
 	sm = make_shared<AnisotropicSmoother> (*ma, *lo_bfa);
       }
+    else if (smoothertype == "chebyshev")
+      {
+	sm = make_shared<ChebyshevSmoother> (*ma, *lo_bfa, flags);
+      }
     else if (smoothertype == "block") 
       {
 	// if (!lfconstraint)
@@ -235,7 +235,7 @@ ANY_DOF: Any used dof (LOCAL_DOF or INTERFACE_DOF or WIREBASKET_DOF)
                              // this allows to keep the elements without the iterator
                              // return MakePyList (el.GetDofs()); 
                              Array<DofId> dofs;
-                             el.GetFESpace().GetDofNrs(el, dofs);
+                             el.GetFESpace().GetCachedDofNrs(el, dofs);
                              return MakePyList (dofs);
                            },
                            "degrees of freedom of element"
@@ -2138,6 +2138,20 @@ space : ngsolve.FESpace
                      py::arg("geom_free") = "bool = False\n"
                      "  when element matrices are independent of geometry, we store them \n"
                      "  only for the referecne elements",
+                     py::arg("precompute") = "bool = False\n"
+                     "  if the form is affine in its Parameters, the matrix parts of the\n"
+                     "  Parameters are stored, and re-assembly only combines them.\n"
+                     "  Changes of other coefficients require Assemble(reallocate=True)",
+                     py::arg("batch_assembly") = "bool = False\n"
+                     "  element matrices of affine simplicial elements with equal shape\n"
+                     "  functions are computed together, one element per SIMD lane",
+                     py::arg("owner_assembly") = "bool = False\n"
+                     "  assemble without element coloring: contiguous chunks of elements\n"
+                     "  store element matrices in thread-private buffers, which are summed\n"
+                     "  up row-range wise. Not used together with preconditioners.",
+                     py::arg("nodal_graph") = "bool = True\n"
+                     "  for node-based dofs the matrix graph is built node by node,\n"
+                     "  without the element-to-dof table",
                      py::arg("check_unused") = "bool = True\n"
 		     "  If set prints warnings if not UNUSED_DOFS are not used."
                      );
@@ -2460,7 +2474,10 @@ flags : dict
                      "  This file must be set by ngsolve.SetTestoutFile. Use\n"
                      "  ngsolve.SetNumThreads(1) for serial output.",
                      py::arg("printelvec") = "bool\n"
-                     "  print element vectors to testout file"
+                     "  print element vectors to testout file",
+                     py::arg("owner_assembly") = "bool = False\n"
+                     "  assemble without element coloring, element vectors are summed\n"
+                     "  up by the owners of dof ranges"
                      );
                 })
     .def("__str__",  [](LF & self ) { return ToString<LinearForm>(self); } )
@@ -3806,7 +3823,8 @@ deformation : ngsolve.comp.GridFunction
 
    py::class_<BaseVTKOutput, shared_ptr<BaseVTKOutput>>(m, "VTKOutput")
     .def(py::init([] (shared_ptr<MeshAccess> ma, py::list coefs_list,
-                      py::list names_list, string filename, int subdivision, int only_element)
+                      py::list names_list, string filename, int subdivision, int only_element,
+                      string format)
          -> shared_ptr<BaseVTKOutput>
          {
            Array<shared_ptr<CoefficientFunction> > coefs
@@ -3815,9 +3833,9 @@ deformation : ngsolve.comp.GridFunction
              = makeCArray<string> (names_list);
            shared_ptr<BaseVTKOutput> ret;
            if (ma->GetDimension() == 2)
-             ret = make_shared<VTKOutput<2>> (ma, coefs, names, filename, subdivision, only_element);
+             ret = make_shared<VTKOutput<2>> (ma, coefs, names, filename, subdivision, only_element, format);
            else
-             ret = make_shared<VTKOutput<3>> (ma, coefs, names, filename, subdivision, only_element);
+             ret = make_shared<VTKOutput<3>> (ma, coefs, names, filename, subdivision, only_element, format);
            return ret;
          }),
          py::arg("ma"),
@@ -3825,7 +3843,17 @@ deformation : ngsolve.comp.GridFunction
          py::arg("names") = py::list(),
          py::arg("filename") = "vtkout",
          py::arg("subdivision") = 0,
-         py::arg("only_element") = -1
+         py::arg("only_element") = -1,
+         py::arg("format") = "vtk",
+         docu_string(R"raw_string(
+Writes the mesh and coefficient functions evaluated in the vertices of
+subdivided elements.
+
+format : str
+  'vtk' for legacy ASCII files, 'vtu' for XML files with binary data.
+  For MPI runs with 'vtu' every rank writes its piece, and rank 0 the
+  collecting .pvtu file.
+)raw_string")
          )
      .def("Do", [](shared_ptr<BaseVTKOutput> self, VorB vb)
           { 
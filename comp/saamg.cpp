@@ -0,0 +1,607 @@
+#include <saamg.hpp>
+
+#include <comp.hpp>
+using namespace ngcomp;
+
+
+namespace ngcomp
+{
+
+  // scalar copy of a block matrix, unknown bs*i+k belongs to node i
+  template <int BS>
+  static shared_ptr<SparseMatrix<double>> ExpandBlocks (const SparseMatrixTM<Mat<BS,BS,double>> & mat)
+  {
+    static Timer t("SAAMG - expand blocks"); RegionTimer reg(t);
+    size_t n = mat.Height();
+    Array<int> cnt(BS*n);
+    for (size_t i = 0; i < n; i++)
+      for (int k = 0; k < BS; k++)
+        cnt[BS*i+k] = BS*mat.GetRowIndices(i).Size();
+
+    auto smat = make_shared<SparseMatrix<double>> (cnt, BS*mat.Width());
+    ParallelFor (n, [&] (size_t i)
+                 {
+                   auto cols = mat.GetRowIndices(i);
+                   auto vals = mat.GetRowValues(i);
+                   for (int k = 0; k < BS; k++)
+                     {
+                       auto scols = smat->GetRowIndices(BS*i+k);
+                       auto svals = smat->GetRowValues(BS*i+k);
+                       for (size_t j = 0; j < cols.Size(); j++)
+                         for (int l = 0; l < BS; l++)
+                           {
+                             scols[BS*j+l] = BS*cols[j]+l;
+                             svals[BS*j+l] = vals[j](k,l);
+                           }
+                     }
+                 });
+    return smat;
+  }
+
+
+  SmoothedAggregationAMG ::
+  SmoothedAggregationAMG (shared_ptr<BaseSparseMatrix> amat, int abs,
+                          shared_ptr<BitArray> freedofs,
+                          FlatMatrix<double> kernel,
+                          const Parameters & params, int level)
+    : mat(amat), bs(abs), smoothing_steps(params.smoothing_steps)
+  {
+    static Timer t("SAAMG"); RegionTimer reg(t);
+    static Timer tagg("SAAMG - aggregation");
+    static Timer tprol("SAAMG - prolongation");
+    static Timer trap("SAAMG - Galerkin product");
+
+    // work on the scalar matrix, the fine matrix may have block entries
+    auto smat = dynamic_pointer_cast<SparseMatrixTM<double>> (mat);
+    int es = 1;     // unknowns per row of mat
+    if (!smat)
+      {
+#if MAX_SYS_DIM >= 2
+        if (auto bmat = dynamic_pointer_cast<SparseMatrixTM<Mat<2,2,double>>> (mat); bmat && bs == 2)
+          smat = ExpandBlocks (*bmat);
+#endif
+#if MAX_SYS_DIM >= 3
+        if (auto bmat = dynamic_pointer_cast<SparseMatrixTM<Mat<3,3,double>>> (mat); bmat && bs == 3)
+          smat = ExpandBlocks (*bmat);
+#endif
+        if (!smat)
+          throw Exception ("SmoothedAggregationAMG: need matrix entries double or Mat<bs,bs>");
+        es = bs;
+      }
+
+    size_t ndof = smat->Height();
+    nnodes = ndof / bs;
+    int nk = kernel.Width();
+
+    cout << IM(3) << "SAAMG: level = " << level << ", nodes = " << nnodes << endl;
+
+    auto isfree = [&] (size_t dof) { return !freedofs || freedofs->Test(dof/es); };
+
+    BitArray freenode(nnodes);
+    freenode.Clear();
+    for (size_t d = 0; d < ndof; d++)
+      if (isfree(d))
+        freenode.SetBit(d/bs);
+
+    // nodal graph with squared Frobenius norms of the blocks
+    auto node_row = [&] (size_t i, Array<int> & nbs, Array<double> & w)
+      {
+        nbs.SetSize0();
+        w.SetSize0();
+        for (int k = 0; k < bs; k++)
+          {
+            auto cols = smat->GetRowIndices(bs*i+k);
+            auto vals = smat->GetRowValues(bs*i+k);
+            for (size_t j = 0; j < cols.Size(); j++)
+              {
+                int nj = cols[j] / bs;
+                auto pos = nbs.Pos(nj);
+                if (pos == -1)
+                  {
+                    pos = nbs.Size();
+                    nbs.Append (nj);
+                    w.Append (0);
+                  }
+                w[pos] += sqr (vals[j]);
+              }
+          }
+      };
+
+    Array<double> dnorm(nnodes);
+    ParallelFor (nnodes, [&] (size_t i)
+                 {
+                   Array<int> nbs;
+                   Array<double> w;
+                   node_row (i, nbs, w);
+                   auto pos = nbs.Pos(i);
+                   dnorm[i] = (pos != -1) ? sqrt(w[pos]) : 0.0;
+                 });
+
+    // strong connections |A_ij| > theta sqrt(|A_ii| |A_jj|) between free nodes
+    auto strong_row = [&] (size_t i, Array<int> & strong, Array<double> & strength)
+      {
+        strong.SetSize0();
+        strength.SetSize0();
+        if (!freenode.Test(i)) return;
+        Array<int> nbs;
+        Array<double> w;
+        node_row (i, nbs, w);
+        for (size_t j = 0; j < nbs.Size(); j++)
+          {
+            int nj = nbs[j];
+            if (nj == i || !freenode.Test(nj)) continue;
+            double s = sqrt(w[j]) / sqrt(dnorm[i]*dnorm[nj]);
+            if (s > params.theta)
+              {
+                strong.Append (nj);
+                strength.Append (s);
+              }
+          }
+      };
+
+    RegionTimer regagg(tagg);
+    Array<int> cnt(nnodes);
+    ParallelFor (nnodes, [&] (size_t i)
+                 {
+                   Array<int> strong;
+                   Array<double> strength;
+                   strong_row (i, strong, strength);
+                   cnt[i] = strong.Size();
+                 });
+    Table<int> strong(cnt);
+    Table<double> strength(cnt);
+    ParallelFor (nnodes, [&] (size_t i)
+                 {
+                   Array<int> hstrong;
+                   Array<double> hstrength;
+                   strong_row (i, hstrong, hstrength);
+                   strong[i] = hstrong;
+                   strength[i] = hstrength;
+                 });
+
+
+    /*
+      Phase 1: roots form a distance-2 maximal independent set,
+      selected in parallel rounds with random priorities (Luby).
+      Neighbours of a root join its aggregate.
+    */
+    auto prio = [] (size_t i)
+      {
+        size_t h = i * 2654435761u;
+        return std::make_tuple (h ^ (h >> 16), i);
+      };
+
+    enum { UNDECIDED, ROOT, DONE };
+    Array<int> state(nnodes), nextstate(nnodes);
+    Array<int> agg(nnodes);    // root node of the aggregate
+    Array<bool> newroot(nnodes);
+    agg = -1;
+    for (size_t i = 0; i < nnodes; i++)
+      state[i] = (freenode.Test(i) && strong[i].Size()) ? UNDECIDED : DONE;
+
+    size_t nundecided = nnodes;
+    while (nundecided)
+      {
+        ParallelFor (nnodes, [&] (size_t i)
+                     {
+                       newroot[i] = false;
+                       if (state[i] != UNDECIDED) return;
+                       auto pi = prio(i);
+                       for (auto j : strong[i])
+                         {
+                           if (state[j] == UNDECIDED && prio(j) > pi) return;
+                           for (auto k : strong[j])
+                             if (k != i && state[k] == UNDECIDED && prio(k) > pi) return;
+                         }
+                       newroot[i] = true;
+                     });
+
+        // roots are at least 3 apart, so every node finds at most one
+        ParallelFor (nnodes, [&] (size_t i)
+                     {
+                       nextstate[i] = state[i];
+                       if (newroot[i])
+                         {
+                           agg[i] = i;
+                           nextstate[i] = ROOT;
+                           return;
+                         }
+                       if (state[i] == ROOT) return;
+                       for (auto j : strong[i])
+                         {
+                           if (newroot[j])
+                             {
+                               if (agg[i] == -1) agg[i] = j;
+                               nextstate[i] = DONE;
+                             }
+                           for (auto k : strong[j])
+                             if (newroot[k])
+                               nextstate[i] = DONE;
+                         }
+                     });
+        state.Swap (nextstate);
+
+        nundecided = 0;
+        for (auto s : state)
+          if (s == UNDECIDED) nundecided++;
+      }
+
+    // Phase 2: remaining nodes join the strongest neighbouring aggregate
+    Array<int> agg2(nnodes);
+    ParallelFor (nnodes, [&] (size_t i)
+                 {
+                   agg2[i] = agg[i];
+                   if (agg[i] != -1) return;
+                   double maxs = 0;
+                   for (size_t j = 0; j < strong[i].Size(); j++)
+                     {
+                       int nj = strong[i][j];
+                       if (agg[nj] != -1 && strength[i][j] > maxs)
+                         {
+                           maxs = strength[i][j];
+                           agg2[i] = agg[nj];
+                         }
+                     }
+                 });
+    agg.Swap (agg2);
+
+    // Phase 3: what is left forms new aggregates with its neighbours
+    for (size_t i = 0; i < nnodes; i++)
+      if (agg[i] == -1 && strong[i].Size())
+        {
+          agg[i] = i;
+          for (auto j : strong[i])
+            if (agg[j] == -1) agg[j] = i;
+        }
+
+    Array<int> node2agg(nnodes);
+    node2agg = -1;
+    size_t nagg = 0;
+    for (size_t i = 0; i < nnodes; i++)
+      if (agg[i] == i)
+        node2agg[i] = nagg++;
+    for (size_t i = 0; i < nnodes; i++)
+      if (agg[i] != -1)
+        node2agg[i] = node2agg[agg[i]];
+    regagg.Stop();
+
+    cout << IM(3) << "SAAMG: aggregates = " << nagg << endl;
+
+    smoother = nullptr;
+    shared_ptr<BaseMatrix> jac;
+    if (es == 1)
+      {
+        TableCreator<int> creator(nnodes);
+        for ( ; !creator.Done(); creator++)
+          for (size_t d = 0; d < ndof; d++)
+            if (isfree(d))
+              creator.Add (d/bs, d);
+        jac = mat->CreateBlockJacobiPrecond (make_shared<Table<int>> (creator.MoveTable()));
+      }
+    else
+      jac = mat->CreateJacobiPrecond (freedofs);
+    smoother = make_shared<ChebyshevSmoothing> (mat, jac);
+
+    if (nagg == 0 || level+1 >= params.max_levels)
+      return;
+
+
+    // tentative prolongation by local QR of the kernel, R is the coarse kernel
+    RegionTimer regprol(tprol);
+    TableCreator<int> aggcreator(nagg);
+    for ( ; !aggcreator.Done(); aggcreator++)
+      for (size_t i = 0; i < nnodes; i++)
+        if (node2agg[i] != -1)
+          aggcreator.Add (node2agg[i], i);
+    Table<int> aggnodes = aggcreator.MoveTable();
+
+    size_t ncoarse = nagg*nk;
+    Matrix<double> coarse_kernel(ncoarse, nk);
+    auto coarse_freedofs = make_shared<BitArray> (ncoarse);
+    coarse_freedofs->Clear();
+
+    Array<int> pcnt(ndof);
+    for (size_t d = 0; d < ndof; d++)
+      pcnt[d] = (node2agg[d/bs] != -1 && isfree(d)) ? nk : 0;
+    auto ptent = make_shared<SparseMatrix<double>> (pcnt, ncoarse);
+
+    ParallelFor (nagg, [&] (size_t a)
+                 {
+                   auto nodes = aggnodes[a];
+                   size_t m = nodes.Size()*bs;
+                   Matrix<> q(m, nk);
+                   for (size_t l = 0; l < nodes.Size(); l++)
+                     for (int k = 0; k < bs; k++)
+                       {
+                         size_t d = nodes[l]*bs+k;
+                         if (isfree(d))
+                           q.Row(l*bs+k) = kernel.Row(d);
+                         else
+                           q.Row(l*bs+k) = 0.0;
+                       }
+
+                   // modified Gram-Schmidt, twice is enough
+                   auto r = coarse_kernel.Rows(a*nk, (a+1)*nk);
+                   r = 0.0;
+                   for (int c = 0; c < nk; c++)
+                     {
+                       double norm0 = L2Norm (q.Col(c));
+                       for (int pass = 0; pass < 2; pass++)
+                         for (int c2 = 0; c2 < c; c2++)
+                           {
+                             double h = InnerProduct (q.Col(c2), q.Col(c));
+                             r(c2,c) += h;
+                             q.Col(c) -= h * q.Col(c2);
+                           }
+                       double norm = L2Norm (q.Col(c));
+                       if (norm > 1e-10 * norm0)
+                         {
+                           r(c,c) = norm;
+                           q.Col(c) /= norm;
+                           coarse_freedofs->SetBitAtomic (a*nk+c);
+                         }
+                       else
+                         q.Col(c) = 0.0;
+                     }
+
+                   for (size_t l = 0; l < nodes.Size(); l++)
+                     for (int k = 0; k < bs; k++)
+                       {
+                         size_t d = nodes[l]*bs+k;
+                         if (!isfree(d)) continue;
+                         auto cols = ptent->GetRowIndices(d);
+                         auto vals = ptent->GetRowValues(d);
+                         for (int c = 0; c < nk; c++)
+                           {
+                             cols[c] = a*nk+c;
+                             vals[c] = q(l*bs+k, c);
+                           }
+                       }
+                 });
+
+
+    // smoothed prolongation P = (I - omega D^-1 A) Ptent
+    double omega = 4.0 / (3.0 * smoother->GetLamMax());
+
+    auto smooth_row = [&] (size_t i, Array<int> & cols, Matrix<> & vals)
+      {
+        cols.SetSize0();
+        for (int k = 0; k < bs; k++)
+          for (auto c : smat->GetRowIndices(bs*i+k))
+            if (!cols.Contains(c))
+              cols.Append (c);
+        QuickSort (cols);
+
+        Matrix<> arow(bs, cols.Size()), dinv(bs, bs);
+        arow = 0.0;
+        for (int k = 0; k < bs; k++)
+          {
+            auto rcols = smat->GetRowIndices(bs*i+k);
+            auto rvals = smat->GetRowValues(bs*i+k);
+            for (size_t j = 0; j < rcols.Size(); j++)
+              arow(k, cols.Pos(rcols[j])) = rvals[j];
+          }
+        for (int k = 0; k < bs; k++)
+          for (int l = 0; l < bs; l++)
+            {
+              auto pos = cols.Pos(bs*i+l);
+              dinv(k,l) = (pos != -1) ? arow(k,pos) : 0.0;
+            }
+        // restrict the diagonal block to free unknowns
+        for (int k = 0; k < bs; k++)
+          if (!isfree(bs*i+k))
+            {
+              dinv.Row(k) = 0.0;
+              dinv.Col(k) = 0.0;
+              dinv(k,k) = 1.0;
+            }
+        CalcInverse (dinv);
+        for (int k = 0; k < bs; k++)
+          if (!isfree(bs*i+k))
+            dinv(k,k) = 0.0;
+
+        vals.SetSize (bs, cols.Size());
+        vals = -omega * dinv * arow;
+        for (int k = 0; k < bs; k++)
+          if (isfree(bs*i+k))
+            vals(k, cols.Pos(bs*i+k)) += 1.0;
+      };
+
+    Array<int> scnt(ndof);
+    ParallelFor (nnodes, [&] (size_t i)
+                 {
+                   Array<int> cols;
+                   Matrix<> vals;
+                   if (freenode.Test(i))
+                     smooth_row (i, cols, vals);
+                   for (int k = 0; k < bs; k++)
+                     scnt[bs*i+k] = isfree(bs*i+k) ? cols.Size() : 0;
+                 });
+    auto smoothmat = make_shared<SparseMatrix<double>> (scnt, ndof);
+    ParallelFor (nnodes, [&] (size_t i)
+                 {
+                   if (!freenode.Test(i)) return;
+                   Array<int> cols;
+                   Matrix<> vals;
+                   smooth_row (i, cols, vals);
+                   for (int k = 0; k < bs; k++)
+                     {
+                       if (!isfree(bs*i+k)) continue;
+                       smoothmat->GetRowIndices(bs*i+k) = cols;
+                       smoothmat->GetRowValues(bs*i+k) = vals.Row(k);
+                     }
+                 });
+
+    prolongation = MatMult (*smoothmat, *ptent);
+    restriction = dynamic_pointer_cast<SparseMatrixTM<double>> (prolongation->CreateTranspose());
+    smoothmat = nullptr;
+    ptent = nullptr;
+    regprol.Stop();
+
+    // Galerkin product
+    shared_ptr<BaseSparseMatrix> coarsemat;
+    {
+      RegionTimer regrap(trap);
+      coarsemat = smat->Restrict (*prolongation);
+    }
+    smat = nullptr;
+
+    if (ncoarse <= params.max_coarse || nagg*nk >= ndof || level+2 >= params.max_levels)
+      {
+        coarsemat->SetInverseType (SPARSECHOLESKY);
+        coarse_precond = coarsemat->InverseMatrix (coarse_freedofs);
+      }
+    else
+      coarse_precond = make_shared<SmoothedAggregationAMG> (coarsemat, nk, coarse_freedofs,
+                                                            coarse_kernel, params, level+1);
+  }
+
+
+  void SmoothedAggregationAMG :: Mult (const BaseVector & b, BaseVector & x) const
+  {
+    static Timer t("SAAMG::Mult"); RegionTimer reg(t);
+
+    x = 0;
+    smoother->Smooth (x, b, smoothing_steps);
+    if (!coarse_precond) return;
+
+    auto res = b.CreateVector();
+    res = b - (*mat) * x;
+
+    // scalar views of the (block) vectors
+    S_BaseVectorPtr<double> sres(nnodes*bs, 1, res.Memory());
+    S_BaseVectorPtr<double> sx(nnodes*bs, 1, x.Memory());
+
+    auto coarse_res = restriction->CreateColVector();
+    auto coarse_x = restriction->CreateColVector();
+    restriction->Mult (sres, coarse_res);
+    coarse_precond->Mult (coarse_res, coarse_x);
+    prolongation->MultAdd (1, coarse_x, sx);
+
+    smoother->Smooth (x, b, smoothing_steps);
+  }
+
+
+
+  /**
+     Smoothed aggregation AMG preconditioner for elasticity.
+     Needs a lowest order H1 space with dim = mesh dimension,
+     the rigid body modes are computed from the vertex coordinates.
+  */
+  class SAAMG_Preconditioner : public Preconditioner
+  {
+    shared_ptr<BilinearForm> bfa;
+    shared_ptr<BitArray> freedofs;
+    shared_ptr<SmoothedAggregationAMG> mat;
+    shared_ptr<BaseMatrix> amat;
+    SmoothedAggregationAMG::Parameters params;
+
+  public:
+    static shared_ptr<Preconditioner> Create (const PDE & pde, const Flags & flags, const string & name)
+    {
+      return make_shared<SAAMG_Preconditioner> (pde, flags, name);
+    }
+
+    static shared_ptr<Preconditioner> CreateBF (shared_ptr<BilinearForm> bfa, const Flags & flags, const string & name)
+    {
+      return make_shared<SAAMG_Preconditioner> (bfa, flags, name);
+    }
+
+    SAAMG_Preconditioner (shared_ptr<BilinearForm> abfa, const Flags & aflags,
+                          const string aname = "saamg")
+      : Preconditioner (abfa, aflags, aname), bfa(abfa)
+    {
+      params.theta = flags.GetNumFlag ("theta", params.theta);
+      params.smoothing_steps = int(flags.GetNumFlag ("smoothingsteps", params.smoothing_steps));
+      params.max_coarse = size_t(flags.GetNumFlag ("maxcoarse", params.max_coarse));
+      params.max_levels = int(flags.GetNumFlag ("maxlevels", params.max_levels));
+      cout << IM(3) << "Create SAAMG" << endl;
+    }
+
+    SAAMG_Preconditioner (const PDE & pde, const Flags & aflags, const string & aname)
+      : SAAMG_Preconditioner (pde.GetBilinearForm (aflags.GetStringFlag ("bilinearform")),
+                              aflags, aname)
+    { ; }
+
+    virtual void InitLevel (shared_ptr<BitArray> _freedofs) override
+    {
+      freedofs = _freedofs;
+    }
+
+    virtual void FinalizeLevel (const BaseMatrix * matrix) override
+    {
+      amat = const_cast<BaseMatrix*>(matrix)->shared_from_this();
+      auto smat = dynamic_pointer_cast<BaseSparseMatrix> (amat);
+      if (!smat)
+        throw Exception ("saamg: need a sparse matrix");
+      if (bfa->SymmetricStorage())
+        throw Exception ("saamg: symmetric storage not supported");
+
+      auto fes = bfa->GetFESpace();
+      auto ma = fes->GetMeshAccess();
+      int dim = ma->GetDimension();
+      int bs = fes->GetDimension();
+      size_t nv = ma->GetNV();
+      if (bs != dim || fes->IsComplex())
+        throw Exception ("saamg: need a real space with dim = mesh dimension");
+      if (fes->GetNDof() != nv)
+        throw Exception ("saamg: only lowest order spaces are supported");
+
+      // rigid body modes, relative to the center of mass for conditioning
+      int nk = dim*(dim+1)/2;
+      Matrix<double> kernel(nv*bs, nk);
+      kernel = 0.0;
+      Vec<3> center = 0.0;
+      for (size_t v = 0; v < nv; v++)
+        center += ma->GetPoint<3>(v);
+      center /= double(max(nv, size_t(1)));
+
+      Array<DofId> dnums;
+      for (size_t v = 0; v < nv; v++)
+        {
+          fes->GetDofNrs (NodeId(NT_VERTEX, v), dnums);
+          if (dnums.Size() != 1) continue;
+          size_t d = dnums[0];
+          Vec<3> p = ma->GetPoint<3>(v) - center;
+          auto kv = kernel.Rows(d*bs, (d+1)*bs);
+          for (int k = 0; k < bs; k++)
+            kv(k,k) = 1;
+          if (dim == 2)
+            {
+              kv(0,2) = -p(1); kv(1,2) = p(0);
+            }
+          else
+            {
+              kv(1,3) = -p(2); kv(2,3) = p(1);
+              kv(0,4) = p(2);  kv(2,4) = -p(0);
+              kv(0,5) = -p(1); kv(1,5) = p(0);
+            }
+        }
+
+      mat = make_shared<SmoothedAggregationAMG> (smat, bs, freedofs, kernel, params);
+    }
+
+    virtual void Update () override { ; }
+
+    virtual const BaseMatrix & GetMatrix() const override
+    {
+      return *mat;
+    }
+
+    virtual const BaseMatrix & GetAMatrix() const override
+    {
+      return *amat;
+    }
+
+    virtual const char * ClassName() const override
+    { return "SmoothedAggregation AMG Preconditioner"; }
+  };
+
+
+  auto initsaamg = [] () {
+    GetPreconditionerClasses().AddPreconditioner("saamg",
+                                                 SAAMG_Preconditioner::Create,
+                                                 SAAMG_Preconditioner::CreateBF);
+    return 1;
+  } ();
+}
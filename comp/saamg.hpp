@@ -0,0 +1,62 @@
+#ifndef SAAMG_HPP_
+#define SAAMG_HPP_
+
+#include <comp.hpp>
+
+namespace ngcomp
+{
+  /**
+     Smoothed aggregation AMG for vector valued problems.
+
+     Unknowns come in node blocks of size bs. The near-nullspace is
+     given nodewise by bs x nkernel blocks (rigid body modes for elasticity).
+     The fine matrix may have Mat<bs,bs> entries, coarse matrices are
+     scalar with nkernel unknowns per aggregate.
+  */
+  class NGS_DLL_HEADER SmoothedAggregationAMG : public ngla::BaseMatrix
+  {
+  public:
+    struct Parameters
+    {
+      /// strength of connection threshold
+      double theta = 0.08;
+      /// degree of the Chebyshev smoother
+      int smoothing_steps = 2;
+      /// direct solver below this number of unknowns
+      size_t max_coarse = 500;
+      ///
+      int max_levels = 10;
+    };
+
+  private:
+    std::shared_ptr<ngla::BaseSparseMatrix> mat;
+    size_t nnodes;
+    int bs;
+    std::shared_ptr<ngla::ChebyshevSmoothing> smoother;
+    std::shared_ptr<ngla::SparseMatrixTM<double>> prolongation, restriction;
+    std::shared_ptr<ngla::BaseMatrix> coarse_precond;
+    int smoothing_steps;
+
+  public:
+    /**
+       amat ... level matrix with Mat<bs,bs> or double entries
+       freedofs ... one bit per row of amat
+       kernel ... (nnodes*bs) x nkernel, row k*bs+i belongs to node k
+    */
+    SmoothedAggregationAMG (std::shared_ptr<ngla::BaseSparseMatrix> amat, int abs,
+                            std::shared_ptr<ngcore::BitArray> freedofs,
+                            FlatMatrix<double> kernel,
+                            const Parameters & params, int level = 0);
+
+    virtual int VHeight() const override { return mat->VHeight(); }
+    virtual int VWidth() const override { return mat->VWidth(); }
+    virtual bool IsComplex() const override { return false; }
+
+    virtual AutoVector CreateRowVector () const override { return mat->CreateColVector(); }
+    virtual AutoVector CreateColVector () const override { return mat->CreateRowVector(); }
+
+    virtual void Mult (const ngla::BaseVector & b, ngla::BaseVector & x) const override;
+  };
+}
+
+#endif // SAAMG_HPP_
@@ -19,7 +19,8 @@ namespace ngcomp
                 flags.GetStringListFlag ("fieldnames" ),
                 flags.GetStringFlag ("filename","output"),
                 (int) flags.GetNumFlag ( "subdivision", 0),
-                (int) flags.GetNumFlag ( "only_element", -1))
+                (int) flags.GetNumFlag ( "only_element", -1),
+                flags.GetStringFlag ("format", "vtk"))
   {;}
 
 
@@ -27,10 +28,15 @@ namespace ngcomp
   VTKOutput<D>::VTKOutput (shared_ptr<MeshAccess> ama,
                            const Array<shared_ptr<CoefficientFunction>> & a_coefs,
                            const Array<string> & a_field_names,
-                           string a_filename, int a_subdivision, int a_only_element)
+                           string a_filename, int a_subdivision, int a_only_element,
+                           string a_format)
     : ma(ama), coefs(a_coefs), fieldnames(a_field_names),
-      filename(a_filename), subdivision(a_subdivision), only_element(a_only_element)
+      filename(a_filename), subdivision(a_subdivision), only_element(a_only_element),
+      format(a_format)
   {
+    if (format != "vtk" && format != "vtu")
+      throw Exception ("VTKOutput: unknown format '"+format+"', use 'vtk' or 'vtu'");
+
     value_field.SetSize(a_coefs.Size());
     for (int i = 0; i < a_coefs.Size(); i++)
       if (fieldnames.Size() > i)
@@ -46,6 +52,7 @@ namespace ngcomp
   {
     points.SetSize(0);
     cells.SetSize(0);
+    celltypes.SetSize(0);
     for (auto field : value_field)
       field->SetSize(0);
   }
@@ -347,45 +354,13 @@ namespace ngcomp
     }
   }
 
-  /// output of cell types (here only simplices)
+  /// output of cell types
   template <int D> 
-  void VTKOutput<D>::PrintCellTypes(VorB vb, const BitArray * drawelems)
+  void VTKOutput<D>::PrintCellTypes()
   {
     *fileout << "CELL_TYPES " << cells.Size() << endl;
-    int factor = (1<<subdivision)*(1<<subdivision);
-    if (D==3 && vb == VOL)
-      factor *= (1<<subdivision);
-    for (auto e : ma->Elements(vb))
-    {
-      if (drawelems && !(drawelems->Test(e.Nr())))
-          continue;
-
-      switch(ma->GetElType(e))
-      {
-      case ET_TET:
-        for(int i=0; i<factor; i++)
-          *fileout << "10 " << endl; //(void)c;
-        break;
-      case ET_QUAD:
-        for(int i=0; i<factor; i++)
-          *fileout << "9 " << endl;
-        break;
-      case ET_TRIG:
-        for(int i=0; i<factor; i++)
-          *fileout << "5 " << endl;
-        break;
-      case ET_PRISM:
-        for(int i=0; i<factor; i++)
-          *fileout << "13 " << endl;
-        break;
-      case ET_HEX:
-        for(int i=0; i<factor; i++)
-          *fileout << "12 " << endl;
-        break;        
-      default:
-        cout << "VTKOutput Element Type " << ma->GetElType(e) << " not supported!" << endl;
-      }
-    }
+    for (auto type : celltypes)
+      *fileout << int(type) << " " << endl;
     *fileout << "CELL_DATA " << cells.Size() << endl;
     *fileout << "POINT_DATA " << points.Size() << endl;
   }
@@ -408,16 +383,135 @@ namespace ngcomp
   }
     
 
+  static bool IsLittleEndian ()
+  {
+    uint16_t one = 1;
+    return *reinterpret_cast<unsigned char*> (&one) == 1;
+  }
+
+  template <int D> 
+  void VTKOutput<D>::WriteVTU (const string & vtufilename)
+  {
+    static Timer t("VTKOutput::WriteVTU");
+    RegionTimer reg(t);
+    
+    size_t np = points.Size(), nc = cells.Size();
+
+    // binary arrays, as VTK types Float32, Int64 and UInt8
+    Array<float> pointdata(3*np);
+    ParallelFor (np, [&] (size_t i)
+                 {
+                   for (int d = 0; d < 3; d++)
+                     pointdata[3*i+d] = (d < D) ? points[i](d) : 0.0f;
+                 });
+
+    Array<int64_t> offsets(nc);
+    int64_t nconn = 0;
+    for (size_t i = 0; i < nc; i++)
+      {
+        nconn += cells[i][0];
+        offsets[i] = nconn;
+      }
+    Array<int64_t> connectivity(nconn);
+    ParallelFor (nc, [&] (size_t i)
+                 {
+                   int nv = cells[i][0];
+                   for (int j = 0; j < nv; j++)
+                     connectivity[offsets[i]-nv+j] = cells[i][j+1];
+                 });
+
+    Array<Array<float>> fielddata(value_field.Size());
+    for (size_t k = 0; k < value_field.Size(); k++)
+      {
+        auto & field = *value_field[k];
+        fielddata[k].SetSize (field.Size());
+        ParallelFor (field.Size(), [&] (size_t i) { fielddata[k][i] = field[i]; });
+      }
+
+    ofstream out(vtufilename, ios::binary);
+    size_t offset = 0;
+    auto header = [&] (string attributes, size_t nbytes)
+      {
+        out << "<DataArray " << attributes << " format=\"appended\" offset=\"" << offset << "\"/>\n";
+        offset += sizeof(uint64_t) + nbytes;
+      };
+    auto block = [&] (const auto & data)
+      {
+        uint64_t nbytes = data.Size() * sizeof(data[0]);
+        out.write (reinterpret_cast<const char*> (&nbytes), sizeof(nbytes));
+        out.write (reinterpret_cast<const char*> (data.Data()), nbytes);
+      };
+    
+    out << "<?xml version=\"1.0\"?>\n"
+        << "<VTKFile type=\"UnstructuredGrid\" version=\"1.0\" byte_order=\""
+        << (IsLittleEndian() ? "LittleEndian" : "BigEndian") << "\" header_type=\"UInt64\">\n"
+        << "<UnstructuredGrid>\n"
+        << "<Piece NumberOfPoints=\"" << np << "\" NumberOfCells=\"" << nc << "\">\n";
+    out << "<Points>\n";
+    header ("type=\"Float32\" NumberOfComponents=\"3\"", pointdata.Size()*sizeof(float));
+    out << "</Points>\n";
+    out << "<Cells>\n";
+    header ("type=\"Int64\" Name=\"connectivity\"", connectivity.Size()*sizeof(int64_t));
+    header ("type=\"Int64\" Name=\"offsets\"", offsets.Size()*sizeof(int64_t));
+    header ("type=\"UInt8\" Name=\"types\"", celltypes.Size());
+    out << "</Cells>\n";
+    out << "<PointData>\n";
+    for (size_t k = 0; k < value_field.Size(); k++)
+      header ("type=\"Float32\" Name=\"" + value_field[k]->Name() +
+              "\" NumberOfComponents=\"" + ToString(value_field[k]->Dimension()) + "\"",
+              fielddata[k].Size()*sizeof(float));
+    out << "</PointData>\n";
+    out << "</Piece>\n"
+        << "</UnstructuredGrid>\n"
+        << "<AppendedData encoding=\"raw\">\n_";
+    block (pointdata);
+    block (connectivity);
+    block (offsets);
+    block (celltypes);
+    for (auto & data : fielddata)
+      block (data);
+    out << "\n</AppendedData>\n"
+        << "</VTKFile>\n";
+  }
+
+  template <int D> 
+  void VTKOutput<D>::WritePVTU (const string & pvtufilename, const string & piecename, int npieces)
+  {
+    ofstream out(pvtufilename);
+    out << "<?xml version=\"1.0\"?>\n"
+        << "<VTKFile type=\"PUnstructuredGrid\" version=\"1.0\" byte_order=\""
+        << (IsLittleEndian() ? "LittleEndian" : "BigEndian") << "\" header_type=\"UInt64\">\n"
+        << "<PUnstructuredGrid GhostLevel=\"0\">\n"
+        << "<PPoints>\n"
+        << "<PDataArray type=\"Float32\" NumberOfComponents=\"3\"/>\n"
+        << "</PPoints>\n"
+        << "<PPointData>\n";
+    for (auto field : value_field)
+      out << "<PDataArray type=\"Float32\" Name=\"" << field->Name()
+          << "\" NumberOfComponents=\"" << field->Dimension() << "\"/>\n";
+    out << "</PPointData>\n";
+
+    // pieces are in the same directory
+    string basename = piecename.substr (piecename.find_last_of("/\\")+1);
+    for (int i = 0; i < npieces; i++)
+      out << "<Piece Source=\"" << basename << "_" << i << ".vtu\"/>\n";
+    out << "</PUnstructuredGrid>\n"
+        << "</VTKFile>\n";
+  }
+  
+
   template <int D> 
   void VTKOutput<D>::Do (LocalHeap & lh, VorB vb, const BitArray * drawelems)
   {
+    static Timer t("VTKOutput::Do");
+    static Timer tfill("VTKOutput::Do - evaluate");
+    RegionTimer reg(t);
+    
     ostringstream filenamefinal;
     filenamefinal << filename;
     if (output_cnt > 0)
       filenamefinal << "_" << output_cnt;
     lastoutputname = filenamefinal.str();
-    filenamefinal << ".vtk";
-    fileout = make_shared<ofstream>(filenamefinal.str());
     cout << IM(4) << " Writing VTK-Output (" << lastoutputname << ")";
     if (output_cnt > 0)
       cout << IM(4) << " ( " << output_cnt << " )";
@@ -427,123 +521,159 @@ namespace ngcomp
 
     ResetArrays();
 
-    Array<IntegrationPoint> ref_vertices_tet(0), ref_vertices_prism(0), ref_vertices_trig(0), ref_vertices_quad(0), ref_vertices_hex(0);
-    Array<INT<ELEMENT_MAXPOINTS+1>> ref_tets(0), ref_prisms(0), ref_trigs(0), ref_quads(0), ref_hexes(0);
-    FlatArray<IntegrationPoint> ref_vertices;
-    FlatArray<INT<ELEMENT_MAXPOINTS+1>> ref_elems;
-    /*
-    if (D==3)
-      FillReferenceData3D(ref_vertices,ref_tets);
-    else
-      FillReferenceData2D(ref_vertices,ref_tets);
-    */
-    FillReferenceTet(ref_vertices_tet,ref_tets);
-    FillReferencePrism(ref_vertices_prism,ref_prisms);
-    FillReferenceQuad(ref_vertices_quad,ref_quads);
-    FillReferenceTrig(ref_vertices_trig,ref_trigs);
-    FillReferenceHex(ref_vertices_hex,ref_hexes);
-      
-    // header:
-    *fileout << "# vtk DataFile Version 3.0" << endl;
-    *fileout << "vtk output" << endl;
-    *fileout << "ASCII" << endl;
-    *fileout << "DATASET UNSTRUCTURED_GRID" << endl;
-
+    // subdivided reference elements, indexed by element type
+    struct RefElement
+    {
+      Array<IntegrationPoint> vertices;
+      Array<INT<ELEMENT_MAXPOINTS+1>> elems;
+      unique_ptr<SIMD_IntegrationRule> simd_ir;
+      int celltype = -1;
+    };
+    std::array<RefElement,25> refels;
+    FillReferenceTet(refels[ET_TET].vertices, refels[ET_TET].elems);
+    FillReferencePrism(refels[ET_PRISM].vertices, refels[ET_PRISM].elems);
+    FillReferenceQuad(refels[ET_QUAD].vertices, refels[ET_QUAD].elems);
+    FillReferenceTrig(refels[ET_TRIG].vertices, refels[ET_TRIG].elems);
+    FillReferenceHex(refels[ET_HEX].vertices, refels[ET_HEX].elems);
+    refels[ET_TET].celltype = 10;
+    refels[ET_PRISM].celltype = 13;
+    refels[ET_QUAD].celltype = 9;
+    refels[ET_TRIG].celltype = 5;
+    refels[ET_HEX].celltype = 12;
+    for (auto & refel : refels)
+      if (refel.vertices.Size())
+        refel.simd_ir = make_unique<SIMD_IntegrationRule>
+          (IntegrationRule (refel.vertices.Size(), refel.vertices.Data()));
+    
     int ne = ma->GetNE(vb);
-
     IntRange range = only_element >= 0 ? IntRange(only_element,only_element+1) : IntRange(ne);
-    
-    for ( int elnr : range)
-    {
-      if (drawelems && !(drawelems->Test(elnr)))
-          continue;
-      
-      HeapReset hr(lh);
 
-      ElementId ei(vb, elnr);
-      ElementTransformation & eltrans = ma->GetTrafo (ei, lh);
-      ELEMENT_TYPE eltype = ma->GetElType(ei);
+    Array<int> elnrs;
+    for (int elnr : range)
+      if (!drawelems || drawelems->Test(elnr))
+        elnrs.Append (elnr);
 
-      switch(eltype)
+    // first point and first cell of every element
+    Array<size_t> first_point(elnrs.Size()+1), first_cell(elnrs.Size()+1);
+    first_point[0] = first_cell[0] = 0;
+    for (size_t i = 0; i < elnrs.Size(); i++)
       {
-      case ET_TRIG:
-        ref_vertices.Assign(ref_vertices_trig);
-        ref_elems.Assign(ref_trigs);
-        break;
-      case ET_QUAD:
-        ref_vertices.Assign(ref_vertices_quad);
-        ref_elems.Assign(ref_quads);
-        break;
-      case ET_TET:
-        ref_vertices.Assign(ref_vertices_tet);
-        ref_elems.Assign(ref_tets);
-        break;
-      case ET_HEX:
-        ref_vertices.Assign(ref_vertices_hex);
-        ref_elems.Assign(ref_hexes);
-        break;        
-      case ET_PRISM:
-        ref_vertices.Assign(ref_vertices_prism);
-        ref_elems.Assign(ref_prisms);
-        break;
-      default:
-        throw Exception("VTK output for element-type"+ToString(eltype)+"not supported");
+        ELEMENT_TYPE eltype = ma->GetElType(ElementId(vb, elnrs[i]));
+        if (refels[eltype].celltype == -1)
+          throw Exception("VTK output for element-type"+ToString(eltype)+"not supported");
+        first_point[i+1] = first_point[i] + refels[eltype].vertices.Size();
+        first_cell[i+1] = first_cell[i] + refels[eltype].elems.Size();
       }
+    
+    points.SetSize (first_point.Last());
+    cells.SetSize (first_cell.Last());
+    celltypes.SetSize (first_cell.Last());
+    for (auto field : value_field)
+      field->SetSize (first_point.Last() * field->Dimension());
 
-      int offset = points.Size();
-      for ( auto ip : ref_vertices)
-      {
-        if (vb==VOL)
-        {
-          MappedIntegrationPoint<D,D> mip(ip, eltrans);
-          points.Append(mip.GetPoint());
-        }
-        else
-        {
-          MappedIntegrationPoint<D-1,D> mip(ip, eltrans);
-          points.Append(mip.GetPoint());
-        }
-      }
-      
-      for (int i = 0; i < coefs.Size(); i++)
+    {
+    RegionTimer regfill(tfill);
+    constexpr size_t SW = SIMD<double>::Size();
+    atomic<bool> simd_evaluate(true);
+    
+    ParallelForRange (elnrs.Size(), [&] (IntRange r)
       {
-        for ( auto ip : ref_vertices)
-        {
-          if (vb==VOL)
+        LocalHeap slh = lh.Split();
+        for (auto i : r)
           {
-            MappedIntegrationPoint<D,D> mip(ip, eltrans);
-            const int dim = coefs[i]->Dimension();
-            FlatVector<> tmp(dim,lh);
-            coefs[i]->Evaluate(mip,tmp);
-            for (int d = 0; d < dim; ++d)
-              value_field[i]->Append(tmp(d));
+            HeapReset hr(slh);
+            ElementId ei(vb, elnrs[i]);
+            ElementTransformation & eltrans = ma->GetTrafo (ei, slh);
+            const RefElement & refel = refels[ma->GetElType(ei)];
+            size_t first = first_point[i];
+            size_t np = refel.vertices.Size();
+
+            bool done = false;
+            if (simd_evaluate)
+              try
+                {
+                  auto & mir = eltrans(*refel.simd_ir, slh);
+                  auto pts = mir.GetPoints();
+                  for (size_t j = 0; j < np; j++)
+                    for (int d = 0; d < D; d++)
+                      points[first+j](d) = pts(j/SW, d)[j%SW];
+                  
+                  for (size_t k = 0; k < coefs.Size(); k++)
+                    {
+                      int dim = coefs[k]->Dimension();
+                      FlatMatrix<SIMD<double>> values(dim, mir.Size(), slh);
+                      coefs[k]->Evaluate (mir, values);
+                      auto & field = *value_field[k];
+                      for (size_t j = 0; j < np; j++)
+                        for (int d = 0; d < dim; d++)
+                          field[(first+j)*dim+d] = values(d, j/SW)[j%SW];
+                    }
+                  done = true;
+                }
+              catch (ExceptionNOSIMD e)
+                {
+                  simd_evaluate = false;
+                }
+
+            if (!done)
+              {
+                IntegrationRule ir(np, const_cast<IntegrationPoint*> (refel.vertices.Data()));
+                auto & mir = eltrans(ir, slh);
+                for (size_t j = 0; j < np; j++)
+                  points[first+j] = mir[j].GetPoint();
+                
+                for (size_t k = 0; k < coefs.Size(); k++)
+                  {
+                    int dim = coefs[k]->Dimension();
+                    FlatMatrix<> values(np, dim, slh);
+                    coefs[k]->Evaluate (mir, values);
+                    auto & field = *value_field[k];
+                    for (size_t j = 0; j < np; j++)
+                      for (int d = 0; d < dim; d++)
+                        field[(first+j)*dim+d] = values(j, d);
+                  }
+              }
+      
+            for (size_t j = 0; j < refel.elems.Size(); j++)
+              {
+                INT<ELEMENT_MAXPOINTS+1> new_elem = refel.elems[j];
+                for (int k = 1; k <= new_elem[0]; ++k)
+                  new_elem[k] += first;
+                cells[first_cell[i]+j] = new_elem;
+                celltypes[first_cell[i]+j] = refel.celltype;
+              }
           }
-          else
+      });
+    }
+
+    if (format == "vtu")
+      {
+        NgMPI_Comm comm = ma->GetCommunicator();
+        if (comm.Size() > 1)
           {
-            MappedIntegrationPoint<D-1,D> mip(ip, eltrans);
-            const int dim = coefs[i]->Dimension();
-            FlatVector<> tmp(dim,lh);
-            coefs[i]->Evaluate(mip,tmp);
-            for (int d = 0; d < dim; ++d)
-              value_field[i]->Append(tmp(d));
+            string piecename = lastoutputname + "_" + ToString(comm.Rank());
+            WriteVTU (piecename + ".vtu");
+            if (comm.Rank() == 0)
+              WritePVTU (lastoutputname + ".pvtu", lastoutputname, comm.Size());
           }
-        }
+        else
+          WriteVTU (lastoutputname + ".vtu");
       }
-      
-      for ( auto elem : ref_elems)
+    else
       {
-        INT<ELEMENT_MAXPOINTS+1> new_elem = elem;
-        for (int i = 1; i <= new_elem[0]; ++i)
-          new_elem[i] += offset;
-        cells.Append(new_elem);
+        fileout = make_shared<ofstream>(lastoutputname + ".vtk");
+        // header:
+        *fileout << "# vtk DataFile Version 3.0" << endl;
+        *fileout << "vtk output" << endl;
+        *fileout << "ASCII" << endl;
+        *fileout << "DATASET UNSTRUCTURED_GRID" << endl;
+
+        PrintPoints();
+        PrintCells();
+        PrintCellTypes();
+        PrintFieldData();
+        fileout = nullptr;
       }
-
-    }
-
-    PrintPoints();
-    PrintCells();
-    PrintCellTypes(vb,drawelems);
-    PrintFieldData();
       
     cout << IM(4) << " Done." << endl;
   }    
@@ -45,10 +45,13 @@ namespace ngcomp
     string filename;
     int subdivision;
     int only_element = -1;
+    /// "vtk" for legacy ASCII, "vtu" for XML with appended raw binary data
+    string format = "vtk";
 
     Array<shared_ptr<ValueField>> value_field;
     Array<Vec<D>> points;
     Array<INT<ELEMENT_MAXPOINTS+1>> cells;
+    Array<unsigned char> celltypes;
 
     int output_cnt = 0;
     
@@ -60,7 +63,7 @@ namespace ngcomp
                const Flags &,shared_ptr<MeshAccess>);
 
     VTKOutput (shared_ptr<MeshAccess>, const Array<shared_ptr<CoefficientFunction>> &,
-               const Array<string> &, string, int, int);
+               const Array<string> &, string, int, int, string aformat = "vtk");
     virtual ~VTKOutput() { ; }
     
     void ResetArrays();
@@ -73,9 +76,14 @@ namespace ngcomp
     // void FillReferenceData3D(Array<IntegrationPoint> & ref_coords, Array<INT<D+1>> & ref_tets);
     void PrintPoints();
     void PrintCells();
-    void PrintCellTypes(VorB vb, const BitArray * drawelems=nullptr);
+    void PrintCellTypes();
     void PrintFieldData();    
 
+    /// XML unstructured grid, arrays appended as raw binary
+    void WriteVTU (const string & vtufilename);
+    /// parallel file collecting the pieces of all ranks
+    void WritePVTU (const string & pvtufilename, const string & piecename, int npieces);
+
     virtual void Do (LocalHeap & lh, VorB vb = VOL, const BitArray * drawelems = 0);
   };
 
@@ -3,6 +3,18 @@
 #include<l2hofe_impl.hpp>
 #include<l2hofefo.hpp>
 #include<regex>
+#include<iomanip>
+
+#ifdef WIN32
+#include <direct.h>
+#include <process.h>
+#define getpid _getpid
+#else
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/file.h>
+#endif
 
 namespace ngfem
 {
@@ -27,55 +39,346 @@ namespace ngfem
         return name;
     }
 
-    unique_ptr<SharedLibrary> CompileCode(const std::vector<string> &codes, const std::vector<string> &link_flags )
+    namespace
     {
-      static int counter = 0;
-      static ngstd::Timer tcompile("CompiledCF::Compile");
-      static ngstd::Timer tlink("CompiledCF::Link");
-      string object_files;
-      int i = 0;
-      string prefix = "code" + ToString(counter++);
-      for(string code : codes) {
-        string file_prefix = prefix+"_"+ToString(i++);
-        ofstream codefile(file_prefix+".cpp");
-        codefile << code;
-        codefile.close();
-        cout << IM(3) << "compiling..." << endl;
-        tcompile.Start();
+      // FNV-1a, stable over runs and builds (unlike std::hash)
+      uint64_t HashString (const string & str, uint64_t h = 14695981039346656037ull)
+      {
+        for (unsigned char c : str)
+          {
+            h ^= c;
+            h *= 1099511628211ull;
+          }
+        return h;
+      }
+
+      string HashToString (uint64_t h)
+      {
+        stringstream s;
+        s << std::hex << std::setfill('0') << std::setw(16) << h;
+        return s.str();
+      }
+
+      bool FileExists (const string & filename)
+      {
+        ifstream f(filename);
+        return f.good();
+      }
+
+      string ReadFile (const string & filename)
+      {
+        ifstream f(filename, ios::binary);
+        stringstream s;
+        s << f.rdbuf();
+        return s.str();
+      }
+
 #ifdef WIN32
-        string scompile = "cmd /C \"ngscxx.bat " + file_prefix + ".cpp\"";
-        object_files += file_prefix+".obj ";
+      constexpr char path_separator = '\\';
 #else
-        string scompile = "ngscxx -c " + file_prefix + ".cpp -o " + file_prefix + ".o";
-        object_files += file_prefix+".o ";
+      constexpr char path_separator = '/';
 #endif
-        int err = system(scompile.c_str());
-        if (err) throw Exception ("problem calling compiler");
-        tcompile.Stop();
+
+      // like mkdir -p
+      void MakeDirectories (const string & path)
+      {
+        for (size_t pos = 1; pos <= path.size(); pos++)
+          if (pos == path.size() || path[pos] == '/' || path[pos] == '\\')
+            {
+              string sub = path.substr(0, pos);
+#ifdef WIN32
+              _mkdir (sub.c_str());
+#else
+              mkdir (sub.c_str(), 0755);
+#endif
+            }
       }
 
-      cout << IM(3) << "linking..." << endl;
-      tlink.Start();
+      /*
+        Compiled CFs are cached in the directory given by the environment
+        variable NGS_COMPILE_CACHE (caching is off if it is set but empty),
+        by default in $XDG_CACHE_HOME/ngsolve/compiled_cf or
+        ~/.cache/ngsolve/compiled_cf.
+       */
+      string CompileCacheDirectory ()
+      {
+        static string dir = [] ()
+          {
+            string dir;
+            if (const char * env = getenv("NGS_COMPILE_CACHE"))
+              dir = env;
+            else
+              {
 #ifdef WIN32
-        string slink = "cmd /C \"ngsld.bat /OUT:" + prefix+".dll " + object_files + "\"";
+                if (const char * home = getenv("LOCALAPPDATA"))
+                  dir = string(home) + "\\ngsolve\\compiled_cf";
 #else
-        string slink = "ngsld -shared " + object_files + " -o " + prefix + ".so -lngstd -lngbla -lngfem -lngcore";
+                if (const char * xdg = getenv("XDG_CACHE_HOME"); xdg && *xdg)
+                  dir = string(xdg) + "/ngsolve/compiled_cf";
+                else if (const char * home = getenv("HOME"))
+                  dir = string(home) + "/.cache/ngsolve/compiled_cf";
+#endif
+              }
+            if (dir != "")
+              {
+                MakeDirectories (dir);
+                // test if we can write there
+                string testfile = dir + path_separator + "writetest" + ToString(getpid());
+                {
+                  ofstream f(testfile);
+                  f << "ngsolve" << endl;
+                }
+                if (!FileExists (testfile))
+                  {
+                    cout << IM(3) << "cannot write to compile cache " << dir << ", caching is off" << endl;
+                    dir = "";
+                  }
+                remove (testfile.c_str());
+              }
+            return dir;
+          } ();
+        return dir;
+      }
+
+      // the compiler wrappers contain compiler, flags and include paths
+      string CompilerIdentity ()
+      {
+        static string identity = [] ()
+          {
+            string identity = "ngsolve-" + ngsolve_version + "\n";
+#ifdef WIN32
+            char sep = ';';
+            std::vector<string> tools = { "ngscxx.bat", "ngsld.bat" };
+#else
+            char sep = ':';
+            std::vector<string> tools = { "ngscxx", "ngsld" };
+#endif
+            string path = getenv("PATH") ? getenv("PATH") : "";
+            for (auto tool : tools)
+              {
+                identity += tool + "\n";
+                size_t first = 0;
+                while (first <= path.size())
+                  {
+                    size_t last = min(path.find(sep, first), path.size());
+                    string filename = path.substr(first, last-first) + path_separator + tool;
+                    if (last > first && FileExists (filename))
+                      {
+                        identity += ReadFile (filename);
+                        break;
+                      }
+                    first = last+1;
+                  }
+              }
+            return identity;
+          } ();
+        return identity;
+      }
+
+      // inter-process lock, also excludes other threads of this process
+      class CompileLock
+      {
+#ifdef WIN32
+        HANDLE handle;
+      public:
+        CompileLock (const string & filename)
+        {
+          handle = CreateFileA (filename.c_str(), GENERIC_READ | GENERIC_WRITE,
+                                FILE_SHARE_READ | FILE_SHARE_WRITE, NULL,
+                                OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+          if (handle == INVALID_HANDLE_VALUE)
+            throw Exception ("cannot open lock file " + filename);
+          OVERLAPPED ov = { 0 };
+          LockFileEx (handle, LOCKFILE_EXCLUSIVE_LOCK, 0, MAXDWORD, MAXDWORD, &ov);
+        }
+        ~CompileLock ()
+        {
+          OVERLAPPED ov = { 0 };
+          UnlockFileEx (handle, 0, MAXDWORD, MAXDWORD, &ov);
+          CloseHandle (handle);
+        }
+#else
+        int fd;
+      public:
+        CompileLock (const string & filename)
+        {
+          fd = open (filename.c_str(), O_RDWR | O_CREAT, 0644);
+          if (fd == -1)
+            throw Exception ("cannot open lock file " + filename);
+          while (flock (fd, LOCK_EX) == -1 && errno == EINTR) ;
+        }
+        ~CompileLock ()
+        {
+          flock (fd, LOCK_UN);
+          close (fd);
+        }
+#endif
+      };
+
+      int CallCompiler (const string & dir, const string & file_prefix)
+      {
+#ifdef WIN32
+        string scompile = "cmd /C \"cd /D " + dir + " && ngscxx.bat " + file_prefix + ".cpp\"";
+#else
+        string scompile = "ngscxx -c " + dir + "/" + file_prefix + ".cpp -o " + dir + "/" + file_prefix + ".o";
+#endif
+        return system(scompile.c_str());
+      }
+
+      int CallLinker (const string & dir, const string & prefix,
+                      const string & object_files, const std::vector<string> & link_flags)
+      {
+#ifdef WIN32
+        string slink = "cmd /C \"cd /D " + dir + " && ngsld.bat /OUT:" + prefix+".dll " + object_files + "\"";
+#else
+        string slink = "ngsld -shared " + object_files + " -o " + dir + "/" + prefix + ".so -lngstd -lngbla -lngfem -lngcore";
         for (auto flag : link_flags)
-            slink += " "+flag;
+          slink += " "+flag;
 #endif
-      int err = system(slink.c_str());
-      if (err) throw Exception ("problem calling linker");      
-      tlink.Stop();
-      cout << IM(3) << "done" << endl;
-      auto library = make_unique<SharedLibrary>();
+        return system(slink.c_str());
+      }
+
 #ifdef WIN32
-      library->Load(prefix+".dll");
+      const string object_suffix = ".obj";
+      const string library_suffix = ".dll";
 #else
+      const string object_suffix = ".o";
+      const string library_suffix = ".so";
+#endif
+
+      /*
+        Builds a file in the cache directory, unless it is already there.
+        The build writes to a process-unique name which is renamed when
+        complete, so readers never see half-written files. Concurrent builds
+        of the same key are serialized by a lock file.
+       */
+      template <typename TBUILD>
+      string BuildCached (const string & dir, const string & key, const string & suffix,
+                          const string & content, TBUILD build)
+      {
+        string base = dir + path_separator + key;
+        string target = base + suffix;
+
+        // the content is kept next to the result to exclude hash collisions
+        auto is_valid = [&] ()
+          { return FileExists (target) && ReadFile (base + ".key") == content; };
+
+        if (is_valid()) return target;
+
+        CompileLock lock(base + ".lock");
+        if (is_valid()) return target;
+        if (FileExists (target) && FileExists (base + ".key"))
+          return "";   // hash collision, don't touch the other entry
+
+        string tmp_prefix = key + "_tmp" + ToString(getpid());
+        if (!build (tmp_prefix))
+          return "";
+        {
+          ofstream keyfile(base + ".key", ios::binary);
+          keyfile << content;
+        }
+        remove (target.c_str());
+        if (rename ((dir + path_separator + tmp_prefix + suffix).c_str(), target.c_str()))
+          return "";
+        return target;
+      }
+    }
+
+
+    unique_ptr<SharedLibrary> CompileCode(const std::vector<string> &codes, const std::vector<string> &link_flags,
+                                          const string & local_code)
+    {
+      static int counter = 0;
+      static ngstd::Timer tcompile("CompiledCF::Compile");
+      static ngstd::Timer tlink("CompiledCF::Link");
+
+      string cache_dir = CompileCacheDirectory();
       char *temp = getcwd(nullptr, 0);
       string cwd(temp);
       free(temp);
-      library->Load(cwd+"/"+prefix+".so");
-#endif
+
+      string object_files;
+      string link_key = CompilerIdentity();
+      bool use_cache = cache_dir != "";
+
+      for (auto & code : codes)
+        {
+          string key = CompilerIdentity() + code;
+          string objfile;
+          if (use_cache)
+            objfile = BuildCached (cache_dir, HashToString(HashString(key)), object_suffix, key,
+                                   [&] (string file_prefix)
+                                   {
+                                     ofstream codefile(cache_dir + path_separator + file_prefix + ".cpp");
+                                     codefile << code;
+                                     codefile.close();
+                                     cout << IM(3) << "compiling..." << endl;
+                                     RegionTimer reg(tcompile);
+                                     int err = CallCompiler (cache_dir, file_prefix);
+                                     remove ((cache_dir + path_separator + file_prefix + ".cpp").c_str());
+                                     return err == 0;
+                                   });
+          if (objfile == "")
+            {
+              // no cache, or something went wrong with it: compile in the working directory
+              use_cache = false;
+              string file_prefix = "code" + ToString(counter++);
+              ofstream codefile(file_prefix+".cpp");
+              codefile << code;
+              codefile.close();
+              cout << IM(3) << "compiling..." << endl;
+              RegionTimer reg(tcompile);
+              if (CallCompiler (cwd, file_prefix))
+                throw Exception ("problem calling compiler");
+              objfile = cwd + path_separator + file_prefix + object_suffix;
+            }
+          else
+            cout << IM(5) << "using cached object " << objfile << endl;
+          object_files += objfile + " ";
+          link_key += objfile + "\n";
+        }
+
+      // code which differs from process to process (e.g. pointer values) is not cached
+      if (local_code != "")
+        {
+          use_cache = false;
+          string file_prefix = "code" + ToString(counter++);
+          ofstream codefile(file_prefix+".cpp");
+          codefile << local_code;
+          codefile.close();
+          RegionTimer reg(tcompile);
+          if (CallCompiler (cwd, file_prefix))
+            throw Exception ("problem calling compiler");
+          object_files += cwd + path_separator + file_prefix + object_suffix + " ";
+        }
+
+      for (auto flag : link_flags)
+        link_key += flag + "\n";
+
+      string libfile;
+      if (use_cache)
+        libfile = BuildCached (cache_dir, HashToString(HashString(link_key)), library_suffix, link_key,
+                               [&] (string prefix)
+                               {
+                                 cout << IM(3) << "linking..." << endl;
+                                 RegionTimer reg(tlink);
+                                 return CallLinker (cache_dir, prefix, object_files, link_flags) == 0;
+                               });
+      if (libfile == "")
+        {
+          string prefix = "code" + ToString(counter++);
+          cout << IM(3) << "linking..." << endl;
+          RegionTimer reg(tlink);
+          if (CallLinker (cwd, prefix, object_files, link_flags))
+            throw Exception ("problem calling linker");
+          libfile = cwd + path_separator + prefix + library_suffix;
+        }
+      else
+        cout << IM(5) << "using cached library " << libfile << endl;
+
+      cout << IM(3) << "done" << endl;
+      auto library = make_unique<SharedLibrary>();
+      library->Load(libfile);
       return library;
     }
 
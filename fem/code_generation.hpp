@@ -177,7 +177,14 @@ namespace ngfem
     }
   }
 
-  unique_ptr<SharedLibrary> CompileCode(const std::vector<string> &codes, const std::vector<string> &libraries );
+  /*
+    Compiles and links the codes into a shared library. Objects and library
+    are cached on disk, keyed by the code, the compiler wrappers and the link
+    flags, see NGS_COMPILE_CACHE. local_code is compiled and linked in addition,
+    but never cached.
+  */
+  unique_ptr<SharedLibrary> CompileCode(const std::vector<string> &codes, const std::vector<string> &libraries,
+                                        const string & local_code = "");
   namespace detail {
       string GenerateL2ElementCode(int order);
   }
@@ -1181,6 +1181,8 @@ public:
     archive.Shallow(c1) & scal;
   }
 
+  double GetScalingFactor () const { return scal; }
+
   virtual void PrintReport (ostream & ost) const override
   {
     ost << scal << "*(";
@@ -4580,6 +4582,8 @@ public:
     BASE::DoArchive(ar);
     ar.Shallow(c1) & dim1 & comp;
   }
+
+  int GetComponent () const { return comp; }
   
   virtual void GenerateCode(Code &code, FlatArray<int> inputs, int index) const override
   {
@@ -5771,6 +5775,8 @@ public:
       ar & dir;
     }
 
+    int GetDir () const { return dir; }
+
     virtual string GetDescription () const override
     {
       string dirname;
@@ -5970,6 +5976,546 @@ shared_ptr<CoefficientFunction> Freeze (shared_ptr<CoefficientFunction> cf)
 
 
 
+  bool IsPointwiseCF (const CoefficientFunction & cf)
+  {
+    bool pointwise = true;
+    const_cast<CoefficientFunction&> (cf).TraverseTree
+      ( [&] (CoefficientFunction & nodecf)
+        {
+          if (dynamic_cast<ProxyFunction*> (&nodecf) ||
+              dynamic_cast<ConstantCoefficientFunction*> (&nodecf) ||
+              dynamic_cast<ParameterCoefficientFunction<double>*> (&nodecf) ||
+              dynamic_cast<DomainConstantCoefficientFunction*> (&nodecf) ||
+              dynamic_cast<CoordCoefficientFunction*> (&nodecf) ||
+              dynamic_cast<ScaleCoefficientFunction*> (&nodecf) ||
+              dynamic_cast<MultScalVecCoefficientFunction*> (&nodecf) ||
+              dynamic_cast<ComponentCoefficientFunction*> (&nodecf) ||
+              dynamic_cast<DomainWiseCoefficientFunction*> (&nodecf) ||
+              dynamic_cast<IdentityCoefficientFunction*> (&nodecf))
+            return;
+          
+          string desc = nodecf.GetDescription();
+          for (string prefix : { "ZeroCF", "unary operation", "binary operation", "innerproduct",
+                "matrix-matrix multiply", "matrix-vector multiply", "cross-product",
+                "Matrix transpose", "trace", "VectorialCoefficientFunction" })
+            if (desc.compare (0, prefix.size(), prefix) == 0)
+              return;
+          pointwise = false;
+        });
+    return pointwise;
+  }
+
+
+  int ParameterDegree (const CoefficientFunction & cf, Array<CoefficientFunction*> & params)
+  {
+    auto & ncf = const_cast<CoefficientFunction&> (cf);
+    if (dynamic_cast<ParameterCoefficientFunction<double>*> (&ncf) ||
+        dynamic_cast<DomainConstantCoefficientFunction*> (&ncf))
+      {
+        if (!params.Contains (&ncf))
+          params.Append (&ncf);
+        return 1;
+      }
+
+    auto inputs = cf.InputCoefficientFunctions();
+    if (inputs.Size() == 0)
+      return IsPointwiseCF (cf) ? 0 : -1;
+
+    int maxdeg = 0, sumdeg = 0;
+    for (auto & in : inputs)
+      {
+        int deg = ParameterDegree (*in, params);
+        if (deg < 0) return -1;
+        maxdeg = max2 (maxdeg, deg);
+        sumdeg += deg;
+      }
+    if (maxdeg == 0)
+      return IsPointwiseCF (cf) ? 0 : -1;
+
+    string desc = cf.GetDescription();
+    auto starts_with = [&desc] (string prefix)
+      { return desc.compare (0, prefix.size(), prefix) == 0; };
+    
+    // linear in every input
+    if (desc == "binary operation '+'" || desc == "binary operation '-'" ||
+        dynamic_cast<ComponentCoefficientFunction*> (&ncf) ||
+        dynamic_cast<DomainWiseCoefficientFunction*> (&ncf) ||
+        starts_with ("VectorialCoefficientFunction") ||
+        starts_with ("Matrix transpose") || starts_with ("trace"))
+      return maxdeg;
+
+    // linear in each factor
+    if (desc == "binary operation '*'" ||
+        dynamic_cast<ScaleCoefficientFunction*> (&ncf) ||
+        dynamic_cast<MultScalVecCoefficientFunction*> (&ncf) ||
+        starts_with ("innerproduct") || starts_with ("matrix-matrix multiply") ||
+        starts_with ("matrix-vector multiply") || starts_with ("cross-product"))
+      return sumdeg;
+
+    if (desc == "binary operation '/'" && inputs.Size() == 2)
+      return (ParameterDegree (*inputs[1], params) == 0) ? sumdeg : -1;
+
+    return -1;
+  }
+  
+
+  // ///////////////////////////// Bytecode for compiled CF /////////////////////////
+
+  /*
+    Bytecode for the steps of a compiled CF, used when no library from the
+    C++ compiler is available (see Compile with realcompile=True).
+
+    Arithmetic steps and standard functions are translated to instructions
+    acting on registers, a register holds the values of one component at
+    all points. Constants become immediate operands, and registers of dead
+    step results are re-used. Steps without bytecode are evaluated by their
+    own Evaluate, with inputs and output in registers.
+  */
+  class CFBytecode
+  {
+    enum OPCODE { OP_CONST, OP_COORD, OP_COPY,
+                  OP_ADD, OP_SUB, OP_MUL, OP_DIV, OP_FMA, OP_POW, OP_ATAN2,
+                  OP_ADDC, OP_MULC, OP_CSUB, OP_CDIV, OP_POWC,
+                  OP_SIN, OP_COS, OP_TAN, OP_SINH, OP_COSH, OP_EXP, OP_LOG,
+                  OP_ATAN, OP_ACOS, OP_ASIN, OP_SQRT, OP_FLOOR, OP_CEIL,
+                  OP_STEP };
+
+    struct Instruction
+    {
+      OPCODE op;
+      int dst, a, b;    // registers, or index of coordinate / foreign step
+      double c;         // immediate operand
+    };
+
+    struct ForeignStep
+    {
+      CoefficientFunction * cf;
+      int dim;
+      Array<int> input_reg, input_dim;
+    };
+
+    // register, or constant if reg == -1
+    struct Operand
+    {
+      int reg;
+      double val;
+    };
+
+    Array<Instruction> code;
+    Array<ForeignStep> foreign;
+    int nregs = 0;
+    int result_dim;
+    int result_reg = -1;
+    double result_val = 0;
+
+  public:
+    CFBytecode (FlatArray<CoefficientFunction*> steps, const DynamicTable<int> & inputs)
+    {
+      size_t nsteps = steps.Size();
+      Array<int> lastuse(nsteps);
+      lastuse = -1;
+      for (size_t i = 0; i < nsteps; i++)
+        for (int j : inputs[i])
+          lastuse[j] = i;
+      lastuse.Last() = nsteps;
+
+      Array<int> reg(nsteps);
+      reg = -1;
+      Array<bool> isconst(nsteps);
+      isconst = false;
+      Array<double> constval(nsteps);
+      Array<bool> busy;
+
+      auto alloc = [&] (int n)
+        {
+          int first = 0;
+          while (true)
+            {
+              int len = 0;
+              while (len < n && first+len < busy.Size() && !busy[first+len]) len++;
+              if (len == n || first+len == busy.Size()) break;
+              first += len+1;
+            }
+          while (busy.Size() < first+n) busy.Append(false);
+          for (int k = 0; k < n; k++) busy[first+k] = true;
+          nregs = max2(nregs, int(busy.Size()));
+          return first;
+        };
+
+      auto emit = [&] (OPCODE op, int dst, int a = -1, int b = -1, double c = 0)
+        { code.Append (Instruction{op, dst, a, b, c}); };
+
+      auto materialize = [&] (int j)
+        {
+          if (reg[j] == -1)
+            {
+              reg[j] = alloc(steps[j]->Dimension());
+              for (int k = 0; k < steps[j]->Dimension(); k++)
+                emit (OP_CONST, reg[j]+k, -1, -1, constval[j]);
+            }
+          return reg[j];
+        };
+
+      auto release = [&] (int i)
+        {
+          for (int j : inputs[i])
+            if (lastuse[j] == int(i) && reg[j] != -1)
+              {
+                for (int k = 0; k < steps[j]->Dimension(); k++)
+                  busy[reg[j]+k] = false;
+                reg[j] = -1;
+                lastuse[j] = -1;  // input may appear twice
+              }
+        };
+
+      // materialized constants are read from their register
+      auto operand = [&] (int j, int k)
+        { return (reg[j] != -1) ? Operand{reg[j]+k, 0} : Operand{-1, constval[j]}; };
+
+      auto fold = [] (string op, double a, double b)
+        {
+          if (op == "+") return a+b;
+          if (op == "-") return a-b;
+          if (op == "*") return a*b;
+          if (op == "/") return a/b;
+          if (op == "pow") return pow(a,b);
+          return atan2(a,b);
+        };
+
+      static const std::map<string, OPCODE> unary_ops =
+        { { "sin", OP_SIN }, { "cos", OP_COS }, { "tan", OP_TAN },
+          { "sinh", OP_SINH }, { "cosh", OP_COSH }, { "exp", OP_EXP },
+          { "log", OP_LOG }, { "atan", OP_ATAN }, { "acos", OP_ACOS },
+          { "asin", OP_ASIN }, { "sqrt", OP_SQRT }, { "floor", OP_FLOOR },
+          { "ceil", OP_CEIL }, { " ", OP_COPY } };
+      static const std::map<string, OPCODE> binary_ops =
+        { { "+", OP_ADD }, { "-", OP_SUB }, { "*", OP_MUL }, { "/", OP_DIV },
+          { "pow", OP_POW }, { "atan2", OP_ATAN2 } };
+
+      auto quoted = [] (const string & desc, const string & prefix, string & name)
+        {
+          if (desc.compare(0, prefix.size(), prefix) != 0 || desc.back() != '\'')
+            return false;
+          name = desc.substr(prefix.size(), desc.size()-prefix.size()-1);
+          return true;
+        };
+
+      for (size_t i = 0; i < nsteps; i++)
+        {
+          auto cf = steps[i];
+          int dim = cf->Dimension();
+          auto in = inputs[i];
+          string desc = cf->GetDescription();
+          string name;
+
+          if (auto constcf = dynamic_cast<ConstantCoefficientFunction*> (cf))
+            {
+              isconst[i] = true;
+              constval[i] = constcf->EvaluateConst();
+            }
+          
+          else if (desc == "ZeroCF")
+            {
+              isconst[i] = true;
+              constval[i] = 0;
+            }
+
+          else if (auto coordcf = dynamic_cast<CoordCoefficientFunction*> (cf))
+            {
+              reg[i] = alloc(1);
+              emit (OP_COORD, reg[i], coordcf->GetDir());
+            }
+
+          else if (quoted (desc, "unary operation '", name) && unary_ops.count(name) && in.Size() == 1)
+            {
+              OPCODE op = unary_ops.at(name);
+              if (isconst[in[0]])
+                {
+                  double v = constval[in[0]];
+                  switch (op)
+                    {
+                    case OP_SIN: v = sin(v); break;
+                    case OP_COS: v = cos(v); break;
+                    case OP_TAN: v = tan(v); break;
+                    case OP_SINH: v = sinh(v); break;
+                    case OP_COSH: v = cosh(v); break;
+                    case OP_EXP: v = exp(v); break;
+                    case OP_LOG: v = log(v); break;
+                    case OP_ATAN: v = atan(v); break;
+                    case OP_ACOS: v = acos(v); break;
+                    case OP_ASIN: v = asin(v); break;
+                    case OP_SQRT: v = sqrt(v); break;
+                    case OP_FLOOR: v = floor(v); break;
+                    case OP_CEIL: v = ceil(v); break;
+                    default: ;
+                    }
+                  isconst[i] = true;
+                  constval[i] = v;
+                }
+              else
+                {
+                  int a = reg[in[0]];
+                  release(i);
+                  reg[i] = alloc(dim);
+                  for (int k = 0; k < dim; k++)
+                    emit (op, reg[i]+k, a+k);
+                }
+            }
+
+          else if (quoted (desc, "binary operation '", name) && binary_ops.count(name) && in.Size() == 2)
+            {
+              OPCODE op = binary_ops.at(name);
+              if (isconst[in[0]] && isconst[in[1]])
+                {
+                  isconst[i] = true;
+                  constval[i] = fold (name, constval[in[0]], constval[in[1]]);
+                }
+              else
+                {
+                  // constants are immediate operands, except as base of pow and for atan2
+                  if (isconst[in[0]] && (op == OP_POW || op == OP_ATAN2))
+                    materialize (in[0]);
+                  if (isconst[in[1]] && op == OP_ATAN2)
+                    materialize (in[1]);
+                  Array<Operand> opa(dim), opb(dim);
+                  for (int k = 0; k < dim; k++)
+                    {
+                      opa[k] = operand(in[0], k);
+                      opb[k] = operand(in[1], k);
+                    }
+                  release(i);
+                  reg[i] = alloc(dim);
+                  for (int k = 0; k < dim; k++)
+                    {
+                      int dst = reg[i]+k;
+                      Operand a = opa[k], b = opb[k];
+                      if (a.reg != -1 && b.reg != -1)
+                        emit (op, dst, a.reg, b.reg);
+                      else if (b.reg == -1)   // register op constant
+                        switch (op)
+                          {
+                          case OP_ADD: emit (OP_ADDC, dst, a.reg, -1, b.val); break;
+                          case OP_SUB: emit (OP_ADDC, dst, a.reg, -1, -b.val); break;
+                          case OP_MUL: emit (OP_MULC, dst, a.reg, -1, b.val); break;
+                          case OP_DIV: emit (OP_MULC, dst, a.reg, -1, 1.0/b.val); break;
+                          default:
+                            if (b.val == 2)
+                              emit (OP_MUL, dst, a.reg, a.reg);
+                            else
+                              emit (OP_POWC, dst, a.reg, -1, b.val);
+                          }
+                      else                    // constant op register
+                        switch (op)
+                          {
+                          case OP_ADD: emit (OP_ADDC, dst, b.reg, -1, a.val); break;
+                          case OP_SUB: emit (OP_CSUB, dst, b.reg, -1, a.val); break;
+                          case OP_MUL: emit (OP_MULC, dst, b.reg, -1, a.val); break;
+                          case OP_DIV: emit (OP_CDIV, dst, b.reg, -1, a.val); break;
+                          default:
+                            throw Exception ("CFBytecode: constant operand not materialized");
+                          }
+                    }
+                }
+            }
+
+          else if (auto scalecf = dynamic_cast<ScaleCoefficientFunction*> (cf); scalecf && in.Size() == 1)
+            {
+              double scal = scalecf->GetScalingFactor();
+              if (isconst[in[0]])
+                {
+                  isconst[i] = true;
+                  constval[i] = scal * constval[in[0]];
+                }
+              else
+                {
+                  int a = reg[in[0]];
+                  release(i);
+                  reg[i] = alloc(dim);
+                  for (int k = 0; k < dim; k++)
+                    emit (OP_MULC, reg[i]+k, a+k, -1, scal);
+                }
+            }
+
+          else if (auto compcf = dynamic_cast<ComponentCoefficientFunction*> (cf); compcf && in.Size() == 1)
+            {
+              if (isconst[in[0]])
+                {
+                  isconst[i] = true;
+                  constval[i] = constval[in[0]];
+                }
+              else
+                {
+                  int a = reg[in[0]] + compcf->GetComponent();
+                  release(i);
+                  reg[i] = alloc(1);
+                  emit (OP_COPY, reg[i], a);
+                }
+            }
+
+          else if (desc.compare(0, 12, "innerproduct") == 0 && in.Size() == 2 && dim == 1)
+            {
+              for (int j : in) materialize (j);
+              int a = reg[in[0]], b = reg[in[1]];
+              int n = steps[in[0]]->Dimension();
+              release(i);
+              reg[i] = alloc(1);
+              emit (OP_MUL, reg[i], a, b);
+              for (int k = 1; k < n; k++)
+                emit (OP_FMA, reg[i], a+k, b+k);
+            }
+
+          else if (dynamic_cast<MultScalVecCoefficientFunction*> (cf) && in.Size() == 2)
+            {
+              // c1 is the scalar
+              reg[i] = alloc(dim);
+              for (int k = 0; k < dim; k++)
+                {
+                  Operand a = operand(in[0], 0), b = operand(in[1], k);
+                  if (a.reg != -1 && b.reg != -1)
+                    emit (OP_MUL, reg[i]+k, a.reg, b.reg);
+                  else if (a.reg != -1)
+                    emit (OP_MULC, reg[i]+k, a.reg, -1, b.val);
+                  else if (b.reg != -1)
+                    emit (OP_MULC, reg[i]+k, b.reg, -1, a.val);
+                  else
+                    emit (OP_CONST, reg[i]+k, -1, -1, a.val*b.val);
+                }
+              release(i);
+            }
+
+          else if (desc == "VectorialCoefficientFunction")
+            {
+              reg[i] = alloc(dim);
+              int k = 0;
+              for (int j : in)
+                for (int l = 0; l < steps[j]->Dimension(); l++, k++)
+                  {
+                    Operand a = operand(j, l);
+                    if (a.reg != -1)
+                      emit (OP_COPY, reg[i]+k, a.reg);
+                    else
+                      emit (OP_CONST, reg[i]+k, -1, -1, a.val);
+                  }
+              release(i);
+            }
+
+          else
+            {
+              ForeignStep fs { cf, dim };
+              for (int j : in)
+                {
+                  fs.input_reg.Append (materialize (j));
+                  fs.input_dim.Append (steps[j]->Dimension());
+                }
+              reg[i] = alloc(dim);
+              emit (OP_STEP, reg[i], foreign.Size());
+              foreign.Append (move(fs));
+              release(i);
+            }
+        }
+
+      result_dim = steps.Last()->Dimension();
+      if (isconst.Last())
+        result_val = constval.Last();
+      else
+        result_reg = reg.Last();
+    }
+
+    size_t NumInstructions() const { return code.Size(); }
+    int NumRegisters() const { return nregs; }
+    
+    // some steps are evaluated by their own Evaluate, which we can only call for SIMD
+    bool CallsSteps() const { return foreign.Size() > 0; }
+
+    template <typename MIR, typename T, ORDERING ORD>
+    void Evaluate (const MIR & ir, BareSliceMatrix<T,ORD> values) const
+    {
+      size_t np = ir.Size();
+      if (result_reg == -1)
+        {
+          values.AddSize(result_dim, np) = T(result_val);
+          return;
+        }
+
+      ArrayMem<T,500> hmem(nregs*np);
+      FlatMatrix<T> regs(nregs, np, hmem.Data());
+
+      for (auto & instr : code)
+        {
+          T * dst = &regs(instr.dst, 0);
+          T * a = (instr.a >= 0 && instr.op != OP_COORD && instr.op != OP_STEP) ? &regs(instr.a, 0) : nullptr;
+          T * b = (instr.b >= 0) ? &regs(instr.b, 0) : nullptr;
+          T c = instr.c;
+          
+          auto unary = [&] (auto func)
+            { for (size_t i = 0; i < np; i++) dst[i] = func(a[i]); };
+          auto binary = [&] (auto func)
+            { for (size_t i = 0; i < np; i++) dst[i] = func(a[i], b[i]); };
+
+          switch (instr.op)
+            {
+            case OP_CONST: for (size_t i = 0; i < np; i++) dst[i] = c; break;
+            case OP_COORD:
+              {
+                if (instr.a >= ir.DimSpace())
+                  for (size_t i = 0; i < np; i++) dst[i] = T(0.0);
+                else
+                  {
+                    auto points = ir.GetPoints();
+                    for (size_t i = 0; i < np; i++) dst[i] = points(i, instr.a);
+                  }
+                break;
+              }
+            case OP_COPY: unary ([] (T x) { return x; }); break;
+            case OP_ADD: binary ([] (T x, T y) { return x+y; }); break;
+            case OP_SUB: binary ([] (T x, T y) { return x-y; }); break;
+            case OP_MUL: binary ([] (T x, T y) { return x*y; }); break;
+            case OP_DIV: binary ([] (T x, T y) { return x/y; }); break;
+            case OP_FMA: for (size_t i = 0; i < np; i++) dst[i] += a[i]*b[i]; break;
+            case OP_POW: binary ([] (T x, T y) { return pow(x,y); }); break;
+            case OP_ATAN2: binary ([] (T x, T y) { return atan2(x,y); }); break;
+            case OP_ADDC: unary ([c] (T x) { return x+c; }); break;
+            case OP_MULC: unary ([c] (T x) { return c*x; }); break;
+            case OP_CSUB: unary ([c] (T x) { return c-x; }); break;
+            case OP_CDIV: unary ([c] (T x) { return c/x; }); break;
+            case OP_POWC: unary ([c] (T x) { return pow(x,c); }); break;
+            case OP_SIN: unary ([] (T x) { return sin(x); }); break;
+            case OP_COS: unary ([] (T x) { return cos(x); }); break;
+            case OP_TAN: unary ([] (T x) { return tan(x); }); break;
+            case OP_SINH: unary ([] (T x) { return sinh(x); }); break;
+            case OP_COSH: unary ([] (T x) { return cosh(x); }); break;
+            case OP_EXP: unary ([] (T x) { return exp(x); }); break;
+            case OP_LOG: unary ([] (T x) { return log(x); }); break;
+            case OP_ATAN: unary ([] (T x) { return atan(x); }); break;
+            case OP_ACOS: unary ([] (T x) { return acos(x); }); break;
+            case OP_ASIN: unary ([] (T x) { return asin(x); }); break;
+            case OP_SQRT: unary ([] (T x) { return sqrt(x); }); break;
+            case OP_FLOOR: unary ([] (T x) { return floor(x); }); break;
+            case OP_CEIL: unary ([] (T x) { return ceil(x); }); break;
+            case OP_STEP:
+              {
+                if constexpr (ORD == RowMajor)
+                  {
+                    auto & fs = foreign[instr.a];
+                    ArrayMem<BareSliceMatrix<T>,20> in(fs.input_reg.Size());
+                    for (size_t j = 0; j < in.Size(); j++)
+                      new (&in[j]) BareSliceMatrix<T> (np, &regs(fs.input_reg[j], 0), DummySize(fs.input_dim[j], np));
+                    fs.cf -> Evaluate (ir, in, BareSliceMatrix<T> (np, dst, DummySize(fs.dim, np)));
+                  }
+                else
+                  throw Exception ("CFBytecode: step evaluation needs row-major layout");
+                break;
+              }
+            }
+        }
+
+      for (int k = 0; k < result_dim; k++)
+        for (size_t i = 0; i < np; i++)
+          values(k, i) = regs(result_reg+k, i);
+    }
+  };
+
+
   // ///////////////////////////// Compiled CF /////////////////////////
 class CompiledCoefficientFunction : public CoefficientFunction //, public std::enable_shared_from_this<CompiledCoefficientFunction>
   {
@@ -6002,6 +6548,9 @@ class CompiledCoefficientFunction : public CoefficientFunction //, public std::e
     lib_function_complex compiled_function_complex = nullptr;
     lib_function_simd_complex compiled_function_simd_complex = nullptr;
 
+    // used as long as there is no compiled library
+    unique_ptr<CFBytecode> bytecode;
+
   public:
     CompiledCoefficientFunction() = default;
     CompiledCoefficientFunction (shared_ptr<CoefficientFunction> acf)
@@ -6044,6 +6593,16 @@ class CompiledCoefficientFunction : public CoefficientFunction //, public std::e
          });
       cout << IM(3) << "inputs = " << endl << inputs << endl;
 
+      BuildBytecode();
+    }
+
+    void BuildBytecode()
+    {
+      for (bool c : is_complex)
+        if (c) return;
+      bytecode = make_unique<CFBytecode> (steps, inputs);
+      cout << IM(3) << "bytecode: " << bytecode->NumInstructions() << " instructions, "
+           << bytecode->NumRegisters() << " registers" << endl;
     }
 
 
@@ -6067,6 +6626,9 @@ class CompiledCoefficientFunction : public CoefficientFunction //, public std::e
             ost << endl;
           }
       }
+    if (bytecode)
+      ost << "bytecode: " << bytecode->NumInstructions() << " instructions, "
+          << bytecode->NumRegisters() << " registers" << endl;
     /*
     for (auto cf : steps)
       ost << cf -> GetDescription() << endl;
@@ -6125,6 +6687,7 @@ class CompiledCoefficientFunction : public CoefficientFunction //, public std::e
                      inputs.Add (mypos, steps.Pos(incf.get()));
                  }
              });
+          BuildBytecode();
         }
     }
 
@@ -6255,15 +6818,23 @@ class CompiledCoefficientFunction : public CoefficientFunction //, public std::e
         string file_code = top_code + s.str();
         std::vector<string> codes;
         codes.push_back(file_code);
+        // pointer values change from run to run, they go into an uncached object
         if(pointer_code.size()) {
           pointer_code = "extern \"C\" {\n" + pointer_code;
           pointer_code += "}\n";
-          codes.push_back(pointer_code);
         }
 
         auto self = dynamic_pointer_cast<CompiledCoefficientFunction>(shared_from_this());
-        auto compile_func = [self, codes, link_flags, maxderiv] () {
-              self->library = CompileCode( codes, link_flags );
+        auto compile_func = [self, codes, pointer_code, link_flags, maxderiv, wait] () {
+              try {
+                self->library = CompileCode( codes, link_flags, pointer_code );
+              } catch (const std::exception &e) {
+                // the caller asked for the compiled code, so report the failure to it;
+                // a background compilation can only report, the bytecode stays in use
+                if (wait) throw;
+                cerr << "Compilation of CoefficientFunction failed: " << e.what() << endl;
+                return;
+              }
               if(self->cf->IsComplex())
               {
                   self->compiled_function_simd_complex = self->library->GetFunction<lib_function_simd_complex>("CompiledEvaluateSIMD");
@@ -6422,6 +6993,12 @@ class CompiledCoefficientFunction : public CoefficientFunction //, public std::e
         return;
       }
 
+      if (bytecode && !bytecode->CallsSteps() && !ir.IsComplex())
+        {
+          bytecode->Evaluate (ir, Trans(values));
+          return;
+        }
+
       T_Evaluate (ir, Trans(values));
       return;
 
@@ -6634,6 +7211,12 @@ class CompiledCoefficientFunction : public CoefficientFunction //, public std::e
         return;
       }
 
+      if (bytecode)
+        {
+          bytecode->Evaluate (ir, values);
+          return;
+        }
+
       T_Evaluate (ir, values);
       return;
 
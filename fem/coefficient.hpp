@@ -740,6 +740,7 @@ namespace ngfem
     
     virtual double EvaluateConst () const override { return val[0]; }
     double operator[] (int i) const { return val[i]; }
+    void SetValue (int i, double aval) { val[i] = aval; }
 
     virtual void GenerateCode(Code &code, FlatArray<int> inputs, int index) const override;
     virtual void DoArchive (Archive & archive) override
@@ -1731,6 +1732,15 @@ INLINE shared_ptr<CoefficientFunction> BinaryOpCF(shared_ptr<CoefficientFunction
   shared_ptr<CoefficientFunction> TangentialVectorCF (int dim);
   NGS_DLL_HEADER
   shared_ptr<CoefficientFunction> JacobianMatrixCF (int dims, int dimr);
+
+  /// cf depends on the element only via the mapped points and the element index,
+  /// so it may be evaluated for points of several elements at once
+  NGS_DLL_HEADER
+  bool IsPointwiseCF (const CoefficientFunction & cf);
+  /// polynomial degree of cf in the values of Parameter- and DomainConstantCFs,
+  /// which are collected in params. -1 if the dependence is not known
+  NGS_DLL_HEADER
+  int ParameterDegree (const CoefficientFunction & cf, Array<CoefficientFunction*> & params);
   NGS_DLL_HEADER
   shared_ptr<CoefficientFunction> WeingartenCF (int dim);
 
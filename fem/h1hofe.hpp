@@ -131,6 +131,27 @@ namespace ngfem
       order = ho;
     }
 
+    using BASE::Evaluate;
+    using BASE::AddTrans;
+    using BASE::EvaluateGrad;
+    using BASE::AddGradTrans;
+
+    // sum factorization for quads and hexes with tensor product rules
+    virtual void Evaluate (const SIMD_IntegrationRule & ir,
+                           BareSliceVector<> coefs,
+                           BareVector<SIMD<double>> values) const override;
+
+    virtual void AddTrans (const SIMD_IntegrationRule & ir,
+                           BareVector<SIMD<double>> values,
+                           BareSliceVector<> coefs) const override;
+
+    virtual void EvaluateGrad (const SIMD_BaseMappedIntegrationRule & ir,
+                               BareSliceVector<> coefs,
+                               BareSliceMatrix<SIMD<double>> values) const override;
+
+    virtual void AddGradTrans (const SIMD_BaseMappedIntegrationRule & ir,
+                               BareSliceMatrix<SIMD<double>> values,
+                               BareSliceVector<> coefs) const override;
 
   };
 
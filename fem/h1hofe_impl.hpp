@@ -8,6 +8,7 @@
 /*********************************************************************/
 
 #include "recursive_pol_tet.hpp"
+#include "sumfactorization.hpp"
 
 namespace ngfem
 {
@@ -37,7 +38,30 @@ namespace ngfem
     
     void CalcDualShape2 (const BaseMappedIntegrationPoint & mip, SliceVector<> shape) const
     { throw Exception ("dual shape not implemented, H1Ho"); }
-    
+
+    /// 1D factors of the shape functions, quads and hexes only
+    void GetTensorFactors (SumFactorization<DIM> & sf) const;
+
+    /*
+      1D factor by key = type + 8 k:
+      type 0: 1-t, type 1: t, 
+      type 2/3: t(1-t) EdgeOrthoPol_k(xi),  type 4/5: t(1-t) QuadOrthoPol_k(xi),
+      with xi = 2t-1 for even, and xi = 1-2t for odd types
+    */
+    template <typename Tx>
+    static Tx EvalTensorFactor (int key, Tx t)
+    {
+      int type = key % 8, k = key / 8;
+      if (type == 0) return 1-t;
+      if (type == 1) return t;
+      Tx xi = (type % 2 == 0) ? 2*t-1 : 1-2*t;
+      ArrayMem<Tx,20> pol(k+1);
+      if (type < 4)
+        EdgeOrthoPol::EvalMult (k, xi, t*(1-t), pol);
+      else
+        QuadOrthoPol::EvalMult (k, xi, t*(1-t), pol);
+      return pol[k];
+    }
   };
 
 
@@ -232,6 +256,45 @@ namespace ngfem
       }
   }
 
+  template<>
+  inline void H1HighOrderFE_Shape<ET_QUAD> :: GetTensorFactors (SumFactorization<2> & sf) const
+  {
+    static const int vc[4][2] = { { 0, 0 }, { 1, 0 }, { 1, 1 }, { 0, 1 } };
+    auto dir = [&] (int v0, int v1) { return (vc[v0][0] != vc[v1][0]) ? 0 : 1; };
+
+    for (int i = 0; i < N_VERTEX; i++)
+      sf.AddDof (INT<2> (vc[i][0], vc[i][1]));
+
+    for (int i = 0; i < N_EDGE; i++)
+      {
+        INT<2> e = GetVertexOrientedEdge (i);
+        int d = dir (e[0], e[1]);
+        INT<2> keys (vc[e[0]][0], vc[e[0]][1]);
+        for (int k = 0; k < order_edge[i]-1; k++)
+          {
+            keys[d] = 8*k + ((vc[e[1]][d] > vc[e[0]][d]) ? 2 : 3);
+            sf.AddDof (keys);
+          }
+      }
+
+    INT<2> p = order_face[0];
+    if (p[0] >= 2 && p[1] >= 2)
+      {
+        INT<4> f = GetVertexOrientedFace (0);
+        int d1 = dir (f[0], f[1]), d2 = dir (f[0], f[3]);
+        int t1 = (vc[f[0]][d1] > vc[f[1]][d1]) ? 4 : 5;
+        int t2 = (vc[f[0]][d2] > vc[f[3]][d2]) ? 4 : 5;
+        INT<2> keys;
+        for (int k = 0; k < p[0]-1; k++)
+          for (int j = 0; j < p[1]-1; j++)
+            {
+              keys[d1] = 8*k + t1;
+              keys[d2] = 8*j + t2;
+              sf.AddDof (keys);
+            }
+      }
+  }
+
   template<>
   inline void H1HighOrderFE_Shape<ET_QUAD> ::CalcDualShape2 (const BaseMappedIntegrationPoint & mip, SliceVector<> shape) const
   {
@@ -594,6 +657,60 @@ namespace ngfem
       }
   }
 
+  template<>
+  inline void H1HighOrderFE_Shape<ET_HEX> :: GetTensorFactors (SumFactorization<3> & sf) const
+  {
+    static const int vc[8][3] = { { 0, 0, 0 }, { 1, 0, 0 }, { 1, 1, 0 }, { 0, 1, 0 },
+                                  { 0, 0, 1 }, { 1, 0, 1 }, { 1, 1, 1 }, { 0, 1, 1 } };
+    auto dir = [&] (int v0, int v1)
+      {
+        for (int d = 0; d < 2; d++)
+          if (vc[v0][d] != vc[v1][d]) return d;
+        return 2;
+      };
+    
+    for (int i = 0; i < N_VERTEX; i++)
+      sf.AddDof (INT<3> (vc[i][0], vc[i][1], vc[i][2]));
+
+    for (int i = 0; i < N_EDGE; i++)
+      {
+        INT<2> e = GetVertexOrientedEdge (i);
+        int d = dir (e[0], e[1]);
+        INT<3> keys (vc[e[0]][0], vc[e[0]][1], vc[e[0]][2]);
+        for (int k = 0; k < order_edge[i]-1; k++)
+          {
+            keys[d] = 8*k + ((vc[e[1]][d] > vc[e[0]][d]) ? 2 : 3);
+            sf.AddDof (keys);
+          }
+      }
+
+    for (int i = 0; i < N_FACE; i++)
+      if (order_face[i][0] >= 2 && order_face[i][1] >= 2)
+        {
+          INT<2> p = order_face[i];
+          INT<4> f = GetVertexOrientedFace (i);
+          int d1 = dir (f[0], f[1]), d2 = dir (f[0], f[3]);
+          int t1 = (vc[f[0]][d1] > vc[f[1]][d1]) ? 4 : 5;
+          int t2 = (vc[f[0]][d2] > vc[f[3]][d2]) ? 4 : 5;
+          INT<3> keys (vc[f[0]][0], vc[f[0]][1], vc[f[0]][2]);
+          for (int k = 0; k < p[0]-1; k++)
+            for (int j = 0; j < p[1]-1; j++)
+              {
+                keys[d1] = 8*k + t1;
+                keys[d2] = 8*j + t2;
+                sf.AddDof (keys);
+              }
+        }
+
+    INT<3> p = order_cell[0];
+    if (p[0] >= 2 && p[1] >= 2 && p[2] >= 2)
+      for (int i = 0; i < p[0]-1; i++)
+        for (int j = 0; j < p[1]-1; j++)
+          for (int k = 0; k < p[2]-1; k++)
+            sf.AddDof (INT<3> (8*i+4, 8*j+4, 8*k+4));
+  }
+
+
   /* ******************************** Pyramid  ************************************ */
 
   template<> template<typename Tx, typename TFA>  
@@ -725,6 +842,93 @@ namespace ngfem
       }
   }
 
+
+
+  /* ************************ sum factorization ************************ */
+
+  template <ELEMENT_TYPE ET, class SHAPES, class BASE>
+  void H1HighOrderFE<ET,SHAPES,BASE> :: 
+  Evaluate (const SIMD_IntegrationRule & ir, BareSliceVector<> coefs,
+            BareVector<SIMD<double>> values) const
+  {
+    if constexpr (ET == ET_QUAD || ET == ET_HEX)
+      {
+        if (SumFactorization<DIM>::IsApplicable (ir))
+          {
+            SumFactorization<DIM> sf;
+            static_cast<const SHAPES&> (*this).GetTensorFactors (sf);
+            sf.Tabulate (ir, [] (int key, auto t) { return SHAPES::EvalTensorFactor (key, t); });
+            sf.Evaluate (coefs, values);
+            return;
+          }
+      }
+    BASE::Evaluate (ir, coefs, values);
+  }
+
+  template <ELEMENT_TYPE ET, class SHAPES, class BASE>
+  void H1HighOrderFE<ET,SHAPES,BASE> :: 
+  AddTrans (const SIMD_IntegrationRule & ir, BareVector<SIMD<double>> values,
+            BareSliceVector<> coefs) const
+  {
+    if constexpr (ET == ET_QUAD || ET == ET_HEX)
+      {
+        if (SumFactorization<DIM>::IsApplicable (ir))
+          {
+            SumFactorization<DIM> sf;
+            static_cast<const SHAPES&> (*this).GetTensorFactors (sf);
+            sf.Tabulate (ir, [] (int key, auto t) { return SHAPES::EvalTensorFactor (key, t); });
+            sf.AddTrans (values, coefs);
+            return;
+          }
+      }
+    BASE::AddTrans (ir, values, coefs);
+  }
+
+  template <ELEMENT_TYPE ET, class SHAPES, class BASE>
+  void H1HighOrderFE<ET,SHAPES,BASE> :: 
+  EvaluateGrad (const SIMD_BaseMappedIntegrationRule & bmir, BareSliceVector<> coefs,
+                BareSliceMatrix<SIMD<double>> values) const
+  {
+    if constexpr (ET == ET_QUAD || ET == ET_HEX)
+      {
+        if (bmir.DimSpace() == DIM && SumFactorization<DIM>::IsApplicable (bmir.IR()))
+          {
+            SumFactorization<DIM> sf;
+            static_cast<const SHAPES&> (*this).GetTensorFactors (sf);
+            sf.Tabulate (bmir.IR(), [] (int key, auto t) { return SHAPES::EvalTensorFactor (key, t); });
+            sf.EvaluateGrad (coefs, values);
+            bmir.TransformGradient (values);
+            return;
+          }
+      }
+    BASE::EvaluateGrad (bmir, coefs, values);
+  }
+
+  template <ELEMENT_TYPE ET, class SHAPES, class BASE>
+  void H1HighOrderFE<ET,SHAPES,BASE> :: 
+  AddGradTrans (const SIMD_BaseMappedIntegrationRule & bmir,
+                BareSliceMatrix<SIMD<double>> values,
+                BareSliceVector<> coefs) const
+  {
+    if constexpr (ET == ET_QUAD || ET == ET_HEX)
+      {
+        if (bmir.DimSpace() == DIM && SumFactorization<DIM>::IsApplicable (bmir.IR()))
+          {
+            SumFactorization<DIM> sf;
+            static_cast<const SHAPES&> (*this).GetTensorFactors (sf);
+            sf.Tabulate (bmir.IR(), [] (int key, auto t) { return SHAPES::EvalTensorFactor (key, t); });
+
+            STACK_ARRAY(SIMD<double>, mem, DIM*bmir.Size());
+            FlatMatrix<SIMD<double>> refgrad(DIM, bmir.Size(), mem);
+            refgrad = values.AddSize(DIM, bmir.Size());
+            bmir.TransformGradientTrans (SliceMatrix<SIMD<double>> (refgrad));
+            sf.AddGradTrans (SliceMatrix<SIMD<double>> (refgrad), coefs);
+            return;
+          }
+      }
+    BASE::AddGradTrans (bmir, values, coefs);
+  }
+
 }
 
 #endif
@@ -332,7 +332,21 @@ namespace ngfem
                             LocalHeap & lh) const;
     
 
-    
+    /**
+       Computes the element matrices of a batch of elements sharing
+       the finite element fel, one element per SIMD lane.
+       Adds to elmats[i]. Returns false if the integrator does not
+       support batched evaluation for these elements, then nothing is added.
+    */
+    virtual bool
+      CalcElementMatrixBatch (const FiniteElement & fel,
+                              FlatArray<const ElementTransformation*> trafos,
+                              FlatArray<FlatMatrix<double>> elmats,
+                              LocalHeap & lh) const
+    { return false; }
+
+
+
     virtual void
     CalcElementMatrixIndependent (const FiniteElement & bfel_master,
                                   const FiniteElement & bfel_master_element,				    
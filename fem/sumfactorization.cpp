@@ -0,0 +1,273 @@
+/*********************************************************************/
+/* File:   sumfactorization.cpp                                      */
+/*********************************************************************/
+
+#include <fem.hpp>
+#include "sumfactorization.hpp"
+
+namespace ngfem
+{
+
+  template <int DIM>
+  void SumFactorization<DIM> :: Finalize ()
+  {
+    size_t ny = keys[1].Size(), nz = keys[2].Size();
+
+    // number the used (iz,iy) pairs, ordered by iz
+    ArrayMem<int,256> pairnr(ny*nz);
+    pairnr = -1;
+    for (auto & d : dofs)
+      pairnr[d[2]*ny+d[1]] = 0;
+
+    int npairs = 0;
+    pairy.SetSize0();
+    firstpair.SetSize (nz+1);
+    for (size_t iz = 0; iz < nz; iz++)
+      {
+        firstpair[iz] = npairs;
+        for (size_t iy = 0; iy < ny; iy++)
+          if (pairnr[iz*ny+iy] != -1)
+            {
+              pairnr[iz*ny+iy] = npairs++;
+              pairy.Append (iy);
+            }
+      }
+    firstpair[nz] = npairs;
+
+    // sort dofs by pairs
+    firstdof.SetSize (npairs+1);
+    firstdof = 0;
+    for (auto & d : dofs)
+      firstdof[pairnr[d[2]*ny+d[1]]+1]++;
+    for (int i = 0; i < npairs; i++)
+      firstdof[i+1] += firstdof[i];
+
+    ArrayMem<int,64> cnt(npairs);
+    for (int i = 0; i < npairs; i++)
+      cnt[i] = firstdof[i];
+    perm.SetSize (dofs.Size());
+    for (size_t i = 0; i < dofs.Size(); i++)
+      perm[cnt[pairnr[dofs[i][2]*ny+dofs[i][1]]]++] = i;
+  }
+
+
+  template <int DIM>
+  void SumFactorization<DIM> ::
+  Evaluate (BareSliceVector<> coefs, BareVector<SIMD<double>> values) const
+  {
+    static Timer t("SumFactorization::Evaluate");
+    ThreadRegionTimer reg(t, TaskManager::GetThreadId());
+
+    size_t npairs = pairy.Size(), nz = keys[2].Size();
+    size_t nqxy = nq[0]*nq[1];
+    FlatMatrix<> tabx = Tab(0);
+    FlatMatrix<> yp = YP();
+
+    // contract x
+    ArrayMem<double,512> mem1(npairs*nq[0]);
+    FlatMatrix<> t1(npairs, nq[0], mem1.Data());
+    for (size_t pair = 0; pair < npairs; pair++)
+      {
+        auto row = t1.Row(pair);
+        row = 0.0;
+        for (int i = firstdof[pair]; i < firstdof[pair+1]; i++)
+          row += coefs(perm[i]) * tabx.Row(dofs[perm[i]][0]);
+      }
+
+    // contract y
+    ArrayMem<double,2048> mem2(nz*nqxy);
+    FlatMatrix<> t2(nz, nqxy, mem2.Data());
+    for (size_t iz = 0; iz < nz; iz++)
+      {
+        FlatMatrix<> t2z(nq[0], nq[1], &t2(iz,0));
+        IntRange r(firstpair[iz], firstpair[iz+1]);
+        if (r.Size())
+          t2z = Trans(t1.Rows(r)) * yp.Rows(r);
+        else
+          t2z = 0.0;
+      }
+
+    // contract z
+    FlatMatrix<> vals(nqxy, nq[2], &values(0)[0]);
+    vals = Trans(t2) * Tab(2);
+
+    for (size_t i = nqxy*nq[2]; i < nsimd*SIMD<double>::Size(); i++)
+      (&values(0)[0])[i] = 0.0;
+
+    NgProfiler::AddThreadFlops (t, TaskManager::GetThreadId(),
+                                dofs.Size()*nq[0] + npairs*nqxy + nz*nqxy*nq[2]);
+  }
+
+
+  template <int DIM>
+  void SumFactorization<DIM> ::
+  AddTrans (BareVector<SIMD<double>> values, BareSliceVector<> coefs) const
+  {
+    static Timer t("SumFactorization::AddTrans");
+    ThreadRegionTimer reg(t, TaskManager::GetThreadId());
+
+    size_t npairs = pairy.Size(), nz = keys[2].Size();
+    size_t nqxy = nq[0]*nq[1];
+    FlatMatrix<> tabx = Tab(0);
+    FlatMatrix<> yp = YP();
+
+    FlatMatrix<> vals(nqxy, nq[2], &values(0)[0]);
+    ArrayMem<double,2048> mem2(nz*nqxy);
+    FlatMatrix<> t2(nz, nqxy, mem2.Data());
+    t2 = Tab(2) * Trans(vals);
+
+    ArrayMem<double,512> mem1(npairs*nq[0]);
+    FlatMatrix<> t1(npairs, nq[0], mem1.Data());
+    for (size_t iz = 0; iz < nz; iz++)
+      {
+        FlatMatrix<> t2z(nq[0], nq[1], &t2(iz,0));
+        IntRange r(firstpair[iz], firstpair[iz+1]);
+        if (r.Size())
+          t1.Rows(r) = yp.Rows(r) * Trans(t2z);
+      }
+
+    for (size_t pair = 0; pair < npairs; pair++)
+      for (int i = firstdof[pair]; i < firstdof[pair+1]; i++)
+        coefs(perm[i]) += InnerProduct (t1.Row(pair), tabx.Row(dofs[perm[i]][0]));
+
+    NgProfiler::AddThreadFlops (t, TaskManager::GetThreadId(),
+                                dofs.Size()*nq[0] + npairs*nqxy + nz*nqxy*nq[2]);
+  }
+
+
+  template <int DIM>
+  void SumFactorization<DIM> ::
+  EvaluateGrad (BareSliceVector<> coefs, BareSliceMatrix<SIMD<double>> values) const
+  {
+    static Timer t("SumFactorization::EvaluateGrad");
+    ThreadRegionTimer reg(t, TaskManager::GetThreadId());
+
+    size_t npairs = pairy.Size(), nz = keys[2].Size();
+    size_t nqxy = nq[0]*nq[1];
+    FlatMatrix<> tabx = Tab(0), dtabx = DTab(0);
+    FlatMatrix<> yp = YP(), dyp = DYP();
+
+    // contract x, with and without derivative
+    ArrayMem<double,1024> mem1(2*npairs*nq[0]);
+    FlatMatrix<> t1(npairs, nq[0], mem1.Data());
+    FlatMatrix<> t1x(npairs, nq[0], mem1.Data()+npairs*nq[0]);
+    for (size_t pair = 0; pair < npairs; pair++)
+      {
+        auto row = t1.Row(pair);
+        auto rowx = t1x.Row(pair);
+        row = 0.0;
+        rowx = 0.0;
+        for (int i = firstdof[pair]; i < firstdof[pair+1]; i++)
+          {
+            double c = coefs(perm[i]);
+            int ix = dofs[perm[i]][0];
+            row += c * tabx.Row(ix);
+            rowx += c * dtabx.Row(ix);
+          }
+      }
+
+    // contract y
+    ArrayMem<double,4096> mem2(3*nz*nqxy);
+    FlatMatrix<> t2(nz, nqxy, mem2.Data());
+    FlatMatrix<> t2x(nz, nqxy, mem2.Data()+nz*nqxy);
+    FlatMatrix<> t2y(nz, nqxy, mem2.Data()+2*nz*nqxy);
+    for (size_t iz = 0; iz < nz; iz++)
+      {
+        FlatMatrix<> t2z(nq[0], nq[1], &t2(iz,0));
+        FlatMatrix<> t2xz(nq[0], nq[1], &t2x(iz,0));
+        FlatMatrix<> t2yz(nq[0], nq[1], &t2y(iz,0));
+        IntRange r(firstpair[iz], firstpair[iz+1]);
+        if (r.Size())
+          {
+            t2z = Trans(t1.Rows(r)) * yp.Rows(r);
+            t2xz = Trans(t1x.Rows(r)) * yp.Rows(r);
+            t2yz = Trans(t1.Rows(r)) * dyp.Rows(r);
+          }
+        else
+          {
+            t2z = 0.0;
+            t2xz = 0.0;
+            t2yz = 0.0;
+          }
+      }
+
+    // contract z
+    FlatMatrix<> gradx(nqxy, nq[2], &values(0,0)[0]);
+    FlatMatrix<> grady(nqxy, nq[2], &values(1,0)[0]);
+    gradx = Trans(t2x) * Tab(2);
+    grady = Trans(t2y) * Tab(2);
+    if (DIM == 3)
+      {
+        FlatMatrix<> gradz(nqxy, nq[2], &values(2,0)[0]);
+        gradz = Trans(t2) * DTab(2);
+      }
+
+    for (int d = 0; d < DIM; d++)
+      for (size_t i = nqxy*nq[2]; i < nsimd*SIMD<double>::Size(); i++)
+        (&values(d,0)[0])[i] = 0.0;
+
+    NgProfiler::AddThreadFlops (t, TaskManager::GetThreadId(),
+                                2*dofs.Size()*nq[0] + 3*npairs*nqxy + DIM*nz*nqxy*nq[2]);
+  }
+
+
+  template <int DIM>
+  void SumFactorization<DIM> ::
+  AddGradTrans (BareSliceMatrix<SIMD<double>> values, BareSliceVector<> coefs) const
+  {
+    static Timer t("SumFactorization::AddGradTrans");
+    ThreadRegionTimer reg(t, TaskManager::GetThreadId());
+
+    size_t npairs = pairy.Size(), nz = keys[2].Size();
+    size_t nqxy = nq[0]*nq[1];
+    FlatMatrix<> tabx = Tab(0), dtabx = DTab(0);
+    FlatMatrix<> yp = YP(), dyp = DYP();
+
+    // contract z
+    ArrayMem<double,4096> mem2(3*nz*nqxy);
+    FlatMatrix<> t2x(nz, nqxy, mem2.Data());
+    FlatMatrix<> t2y(nz, nqxy, mem2.Data()+nz*nqxy);
+    FlatMatrix<> t2z(nz, nqxy, mem2.Data()+2*nz*nqxy);
+    t2x = Tab(2) * Trans(FlatMatrix<> (nqxy, nq[2], &values(0,0)[0]));
+    t2y = Tab(2) * Trans(FlatMatrix<> (nqxy, nq[2], &values(1,0)[0]));
+    if (DIM == 3)
+      t2z = DTab(2) * Trans(FlatMatrix<> (nqxy, nq[2], &values(2,0)[0]));
+
+    // contract y
+    ArrayMem<double,1536> mem1(3*npairs*nq[0]);
+    FlatMatrix<> t1(npairs, nq[0], mem1.Data());
+    FlatMatrix<> t1x(npairs, nq[0], mem1.Data()+npairs*nq[0]);
+    FlatMatrix<> tmp(npairs, nq[0], mem1.Data()+2*npairs*nq[0]);
+    for (size_t iz = 0; iz < nz; iz++)
+      {
+        IntRange r(firstpair[iz], firstpair[iz+1]);
+        if (!r.Size()) continue;
+        FlatMatrix<> t2xz(nq[0], nq[1], &t2x(iz,0));
+        FlatMatrix<> t2yz(nq[0], nq[1], &t2y(iz,0));
+        t1x.Rows(r) = yp.Rows(r) * Trans(t2xz);
+        t1.Rows(r) = dyp.Rows(r) * Trans(t2yz);
+        if (DIM == 3)
+          {
+            FlatMatrix<> t2zz(nq[0], nq[1], &t2z(iz,0));
+            tmp.Rows(r) = yp.Rows(r) * Trans(t2zz);
+            t1.Rows(r) += tmp.Rows(r);
+          }
+      }
+
+    // contract x
+    for (size_t pair = 0; pair < npairs; pair++)
+      for (int i = firstdof[pair]; i < firstdof[pair+1]; i++)
+        {
+          int ix = dofs[perm[i]][0];
+          coefs(perm[i]) += InnerProduct (t1.Row(pair), tabx.Row(ix))
+            + InnerProduct (t1x.Row(pair), dtabx.Row(ix));
+        }
+
+    NgProfiler::AddThreadFlops (t, TaskManager::GetThreadId(),
+                                2*dofs.Size()*nq[0] + 3*npairs*nqxy + DIM*nz*nqxy*nq[2]);
+  }
+
+
+  template class SumFactorization<2>;
+  template class SumFactorization<3>;
+}
@@ -0,0 +1,204 @@
+#ifndef FILE_SUMFACTORIZATION
+#define FILE_SUMFACTORIZATION
+
+/*********************************************************************/
+/* File:   sumfactorization.hpp                                      */
+/*********************************************************************/
+
+namespace ngfem
+{
+
+  /**
+     Sum factorization for tensor product elements (quads and hexes).
+
+     Every shape function is a product of 1D factors,
+       phi_i(x,y,z) = f^x_{ix(i)}(x) f^y_{iy(i)}(y) f^z_{iz(i)}(z),
+     the element provides the factors of every dof by integer keys.
+     For a tensor product integration rule evaluation and transposed
+     evaluation are performed direction by direction, which needs
+     O(p^(DIM+1)) operations instead of O(p^(2 DIM)).
+
+     2D elements are treated as 3D elements with a constant z-factor.
+     Gradients are computed on the reference element.
+  */
+
+  /// 1D factors tabulated at the points of a 1D rule, reused over elements
+  struct TensorFactorCache
+  {
+    Array<double> x;                     // points of the 1D rule
+    Array<int> row;                      // row of a key, -1 if not evaluated
+    Array<double> val, dval;             // values and derivatives per row
+  };
+
+  template <int DIM>
+  class NGS_DLL_HEADER SumFactorization
+  {
+    ArrayMem<int,32> keys[3];            // 1D factor keys per direction
+    ArrayMem<INT<3>,128> dofs;           // factor numbers per dof
+
+    ArrayMem<int,128> perm;              // dofs sorted by (iz,iy)-pairs
+    ArrayMem<int,64> firstdof;           // dof range of a pair
+    ArrayMem<int,64> pairy;              // y-factor of a pair
+    ArrayMem<int,32> firstpair;          // pair range of a z-factor
+
+    size_t nq[3];                        // 1D integration points
+    size_t nsimd;                        // size of the SIMD rule
+    ArrayMem<double,1024> mem_tab;
+    double * ptab[3], * pdtab[3];        // factors and derivatives at points
+    double * pyp, * pdyp;                // y-factors gathered per pair
+
+  public:
+    SumFactorization ()
+    {
+      if (DIM == 2) keys[2].Append (0);
+    }
+
+    /// tensor product rule with more than one point per direction
+    static bool IsApplicable (const SIMD_IntegrationRule & ir)
+    {
+      if (!ir.IsTP()) return false;
+      size_t nip = ir.GetIRX().GetNIP() * ir.GetIRY().GetNIP();
+      if (ir.GetIRX().GetNIP() < 2 || ir.GetIRY().GetNIP() < 2) return false;
+      if (DIM == 3)
+        {
+          if (ir.GetIRZ().GetNIP() < 2) return false;
+          nip *= ir.GetIRZ().GetNIP();
+        }
+      return nip == ir.GetNIP();
+    }
+
+    /// next dof, given by the keys of its 1D factors
+    void AddDof (INT<DIM> dkeys)
+    {
+      INT<3> nrs(0,0,0);
+      for (int d = 0; d < DIM; d++)
+        {
+          int pos = keys[d].Pos(dkeys[d]);
+          if (pos == -1)
+            {
+              pos = keys[d].Size();
+              keys[d].Append (dkeys[d]);
+            }
+          nrs[d] = pos;
+        }
+      dofs.Append (nrs);
+    }
+
+    /// evaluates the 1D factors at the integration points,
+    /// eval1d (key, AutoDiff<1> t) returns the factor with derivative.
+    /// Factor values are cached per thread and 1D rule.
+    template <typename FUNC>
+    void Tabulate (const SIMD_IntegrationRule & ir, FUNC eval1d);
+
+    void Evaluate (BareSliceVector<> coefs, BareVector<SIMD<double>> values) const;
+    void AddTrans (BareVector<SIMD<double>> values, BareSliceVector<> coefs) const;
+
+    /// reference gradient, DIM rows
+    void EvaluateGrad (BareSliceVector<> coefs, BareSliceMatrix<SIMD<double>> values) const;
+    void AddGradTrans (BareSliceMatrix<SIMD<double>> values, BareSliceVector<> coefs) const;
+
+  private:
+    void Finalize ();
+    FlatMatrix<> Tab (int d) const { return FlatMatrix<> (keys[d].Size(), nq[d], ptab[d]); }
+    FlatMatrix<> DTab (int d) const { return FlatMatrix<> (keys[d].Size(), nq[d], pdtab[d]); }
+    FlatMatrix<> YP () const { return FlatMatrix<> (pairy.Size(), nq[1], pyp); }
+    FlatMatrix<> DYP () const { return FlatMatrix<> (pairy.Size(), nq[1], pdyp); }
+  };
+
+
+
+  template <int DIM> template <typename FUNC>
+  void SumFactorization<DIM> :: Tabulate (const SIMD_IntegrationRule & ir, FUNC eval1d)
+  {
+    Finalize();
+
+    constexpr int NCACHE = 4;
+    static thread_local TensorFactorCache cache[NCACHE];
+    static thread_local int next = 0;
+
+    const SIMD_IntegrationRule * irs[3] =
+      { &ir.GetIRX(), &ir.GetIRY(), (DIM == 3) ? &ir.GetIRZ() : nullptr };
+    nsimd = ir.Size();
+
+    size_t size = 2 * pairy.Size() * irs[1]->GetNIP();
+    for (int d = 0; d < 3; d++)
+      {
+        nq[d] = (d < DIM) ? irs[d]->GetNIP() : 1;
+        size += 2 * keys[d].Size() * nq[d];
+      }
+    mem_tab.SetSize (size);
+
+    double * p = mem_tab.Data();
+    for (int d = 0; d < 3; d++)
+      {
+        ptab[d] = p;  p += keys[d].Size() * nq[d];
+        pdtab[d] = p; p += keys[d].Size() * nq[d];
+        FlatMatrix<> tab = Tab(d), dtab = DTab(d);
+        if (d >= DIM)
+          {
+            tab = 1.0;
+            dtab = 0.0;
+            continue;
+          }
+        constexpr size_t SW = SIMD<double>::Size();
+        auto point = [&] (size_t j) { return (*irs[d])[j/SW](0)[j%SW]; };
+
+        // find the rule in the cache, or replace the oldest entry
+        TensorFactorCache * c = nullptr;
+        for (auto & ci : cache)
+          if (ci.x.Size() == nq[d])
+            {
+              bool same = true;
+              for (size_t j = 0; j < nq[d]; j++)
+                if (ci.x[j] != point(j)) same = false;
+              if (same) { c = &ci; break; }
+            }
+        if (!c)
+          {
+            c = &cache[next];
+            next = (next+1) % NCACHE;
+            c->x.SetSize (nq[d]);
+            for (size_t j = 0; j < nq[d]; j++)
+              c->x[j] = point(j);
+            c->row.SetSize0();
+            c->val.SetSize0();
+            c->dval.SetSize0();
+          }
+
+        for (size_t k = 0; k < keys[d].Size(); k++)
+          {
+            int key = keys[d][k];
+            while (c->row.Size() <= size_t(key))
+              c->row.Append (-1);
+            if (c->row[key] == -1)
+              {
+                c->row[key] = c->val.Size() / nq[d];
+                for (size_t j = 0; j < nq[d]; j++)
+                  {
+                    AutoDiff<1> f = eval1d (key, AutoDiff<1> (c->x[j], 0));
+                    c->val.Append (f.Value());
+                    c->dval.Append (f.DValue(0));
+                  }
+              }
+            size_t first = c->row[key] * nq[d];
+            for (size_t j = 0; j < nq[d]; j++)
+              {
+                tab(k,j) = c->val[first+j];
+                dtab(k,j) = c->dval[first+j];
+              }
+          }
+      }
+
+    pyp = p;  p += pairy.Size() * nq[1];
+    pdyp = p;
+    FlatMatrix<> yp = YP(), dyp = DYP();
+    for (size_t i = 0; i < pairy.Size(); i++)
+      {
+        yp.Row(i) = Tab(1).Row(pairy[i]);
+        dyp.Row(i) = DTab(1).Row(pairy[i]);
+      }
+  }
+
+}
+
+#endif
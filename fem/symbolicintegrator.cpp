@@ -1091,6 +1091,7 @@ namespace ngfem
               cout << IM(3) << "integrand has an Interpolation Operator" << endl;
             }
         });
+    pointwise_cf = IsPointwiseCF (*cf);
 
     for (auto proxy : trial_proxies)
       if (!proxy->Evaluator()->SupportsVB(vb))
@@ -1871,6 +1872,193 @@ namespace ngfem
   }
 
 
+  // the SIMD lanes hold the same reference point mapped by different affine elements
+  template <int D>
+  static SIMD_BaseMappedIntegrationRule &
+  MapIntegrationRuleBatch (const SIMD_IntegrationRule & bir,
+                           FlatArray<const ElementTransformation*> trafos,
+                           LocalHeap & lh)
+  {
+    constexpr size_t SW = SIMD<double>::Size();
+    auto & mir = *new (lh) SIMD_MappedIntegrationRule<D,D> (bir, *trafos[0], -1, lh);
+
+    // unused lanes repeat the last element
+    Vec<D> p0[SW];
+    Mat<D,D> jac[SW];
+    IntegrationPoint ip0(0,0,0,0);
+    for (size_t lane = 0; lane < SW; lane++)
+      trafos[min2(lane, trafos.Size()-1)] -> CalcPointJacobian (ip0, p0[lane], jac[lane]);
+
+    for (size_t i = 0; i < bir.Size(); i++)
+      {
+        for (int j = 0; j < D; j++)
+          {
+            mir[i].Point()(j) = [&] (int lane)
+              {
+                double sum = p0[lane](j);
+                for (int k = 0; k < D; k++)
+                  sum += jac[lane](j,k) * bir[i](k)[lane];
+                return sum;
+              };
+            for (int k = 0; k < D; k++)
+              mir[i].Jacobian()(j,k) = [&] (int lane) { return jac[lane](j,k); };
+          }
+        mir[i].Compute();
+      }
+    return mir;
+  }
+  
+  bool SymbolicBilinearFormIntegrator ::
+  CalcElementMatrixBatch (const FiniteElement & fel,
+                          FlatArray<const ElementTransformation*> trafos,
+                          FlatArray<FlatMatrix<double>> elmats,
+                          LocalHeap & lh) const
+  {
+    constexpr size_t SW = SIMD<double>::Size();
+    auto et = fel.ElementType();
+    
+    if (vb != VOL || element_vb != VOL || has_interpolate || !simd_evaluate || !pointwise_cf)
+      return false;
+    if (cf->IsComplex() || fel.ComplexShapes() || typeid(fel) == typeid(const MixedFiniteElement&))
+      return false;
+    if (et != ET_SEGM && et != ET_TRIG && et != ET_TET)
+      return false;
+    if (trafos.Size() == 0 || trafos.Size() > SW)
+      return false;
+    int dim = trafos[0]->SpaceDim();
+    if (dim != ElementTopology::GetSpaceDim(et))
+      return false;
+    for (auto trafo : trafos)
+      if (trafo->IsCurvedElement() || trafo->IsComplex() ||
+          trafo->GetElementIndex() != trafos[0]->GetElementIndex())
+        return false;
+
+    static Timer t("SymbolicBFI::CalcElementMatrixBatch", 2);
+    ThreadRegionTimer reg(t, TaskManager::GetThreadId());
+    HeapReset hr(lh);
+    
+    try
+      {
+        const IntegrationRule & ir = GetIntegrationRule (fel, lh);
+        size_t nip = ir.Size();
+        SIMD_IntegrationRule bir(nip*SW, lh);
+        for (size_t i = 0; i < nip; i++)
+          bir[i] = [&] (int lane) { return ir[i]; };
+
+        SIMD_BaseMappedIntegrationRule * pmir = nullptr;
+        switch (dim)
+          {
+          case 1: pmir = &MapIntegrationRuleBatch<1> (bir, trafos, lh); break;
+          case 2: pmir = &MapIntegrationRuleBatch<2> (bir, trafos, lh); break;
+          default: pmir = &MapIntegrationRuleBatch<3> (bir, trafos, lh); break;
+          }
+        SIMD_BaseMappedIntegrationRule & mir = *pmir;
+
+        auto save_userdata = trafos[0]->PushUserData();
+        ProxyUserData ud;
+        const_cast<ElementTransformation&>(*trafos[0]).userdata = &ud;
+
+        size_t ndof = fel.GetNDof();
+        FlatMatrix<SIMD<double>> belmat(ndof, ndof, lh);
+        belmat = SIMD<double>(0.0);
+        
+        int k1 = 0;
+        int k1nr = 0;
+        for (auto proxy1 : trial_proxies)
+          {
+            int l1 = 0;
+            int l1nr = 0;
+            for (auto proxy2 : test_proxies)
+              {
+                size_t dim_proxy1 = proxy1->Dimension();
+                size_t dim_proxy2 = proxy2->Dimension();
+                size_t tt_pair = l1nr*trial_proxies.Size()+k1nr;
+                
+                if (nonzeros_proxies(tt_pair))
+                  {
+                    HeapReset hr(lh);
+                    bool samediffop = same_diffops(tt_pair);
+                    bool symmetric = samediffop && diagonal_proxies(tt_pair);
+
+                    FlatMatrix<SIMD<double>> proxyvalues(dim_proxy1*dim_proxy2, nip, lh);
+                    for (size_t k = 0, kk = 0; k < dim_proxy1; k++)
+                      for (size_t l = 0; l < dim_proxy2; l++, kk++)
+                        if (nonzeros(l1+l, k1+k))
+                          {
+                            ud.trialfunction = proxy1;
+                            ud.trial_comp = k;
+                            ud.testfunction = proxy2;
+                            ud.test_comp = l;
+                            cf -> Evaluate (mir, proxyvalues.Rows(kk,kk+1));
+                          }
+
+                    FlatVector<SIMD<double>> weights(nip, lh);
+                    for (size_t i = 0; i < nip; i++)
+                      weights(i) = mir[i].GetWeight();
+
+                    IntRange r1 = proxy1->Evaluator()->UsedDofs(fel);
+                    IntRange r2 = proxy2->Evaluator()->UsedDofs(fel);
+
+                    FlatMatrix<SIMD<double>> bbmat1(ndof*dim_proxy1, nip, lh);
+                    FlatMatrix<SIMD<double>> bdbmat1(ndof*dim_proxy2, nip, lh);
+                    FlatMatrix<SIMD<double>> bbmat2 = samediffop ?
+                      bbmat1 : FlatMatrix<SIMD<double>>(ndof*dim_proxy2, nip, lh);
+                    FlatMatrix<SIMD<double>> hbdbmat1(ndof, dim_proxy2*nip, bdbmat1.Data());
+                    FlatMatrix<SIMD<double>> hbbmat2(ndof, dim_proxy2*nip, bbmat2.Data());
+
+                    proxy1->Evaluator()->CalcMatrix(fel, mir, bbmat1);
+                    if (!samediffop)
+                      proxy2->Evaluator()->CalcMatrix(fel, mir, bbmat2);
+
+                    hbdbmat1.Rows(r1) = 0.0;
+                    for (size_t j = 0; j < dim_proxy2; j++)
+                      for (size_t k = 0; k < dim_proxy1; k++)
+                        if (nonzeros(l1+j, k1+k))
+                          {
+                            auto proxyvalues_jk = proxyvalues.Row(k*dim_proxy2+j);
+                            auto bbmat1_k = bbmat1.RowSlice(k, dim_proxy1).Rows(r1);
+                            auto bdbmat1_j = bdbmat1.RowSlice(j, dim_proxy2).Rows(r1);
+                            for (size_t i = 0; i < nip; i++)
+                              bdbmat1_j.Col(i).Range(0,r1.Size()) += proxyvalues_jk(i)*weights(i) * bbmat1_k.Col(i);
+                          }
+
+                    // no horizontal sums, every lane accumulates its own element matrix
+                    size_t nq = hbbmat2.Width();
+                    for (size_t i : r2)
+                      for (size_t j : r1)
+                        {
+                          if (symmetric && j > i) break;
+                          SIMD<double> sum(0.0);
+                          for (size_t q = 0; q < nq; q++)
+                            sum += hbbmat2(i,q) * hbdbmat1(j,q);
+                          belmat(i,j) += sum;
+                          if (symmetric && j < i)
+                            belmat(j,i) += sum;
+                        }
+                    NgProfiler::AddThreadFlops (t, TaskManager::GetThreadId(),
+                                                SW*2*r2.Size()*r1.Size()*nq);
+                  }
+                l1 += proxy2->Dimension();
+                l1nr++;
+              }
+            k1 += proxy1->Dimension();
+            k1nr++;
+          }
+
+        for (size_t lane = 0; lane < elmats.Size(); lane++)
+          for (size_t i = 0; i < ndof; i++)
+            for (size_t j = 0; j < ndof; j++)
+              elmats[lane](i,j) += belmat(i,j)[lane];
+        return true;
+      }
+    catch (ExceptionNOSIMD e)
+      {
+        cout << IM(6) << e.What() << endl
+             << "no batched evaluation" << endl;
+        return false;
+      }
+  }
+
   
 
   template <typename SCAL, typename SCAL_SHAPES, typename SCAL_RES>
@@ -647,6 +647,7 @@ public:
     int trial_difforder, test_difforder;
     bool is_symmetric;
     bool has_interpolate; // is there an interpolate in the expression tree ? 
+    bool pointwise_cf;    // can cf be evaluated for several elements at once ?
   public:
     NGS_DLL_HEADER SymbolicBilinearFormIntegrator (shared_ptr<CoefficientFunction> acf, VorB avb,
                                                    VorB aelement_boundary);
@@ -690,6 +691,11 @@ public:
                           bool & symmetric_so_far,                          
                           LocalHeap & lh) const override;    
 
+    NGS_DLL_HEADER virtual bool
+    CalcElementMatrixBatch (const FiniteElement & fel,
+                            FlatArray<const ElementTransformation*> trafos,
+                            FlatArray<FlatMatrix<double>> elmats,
+                            LocalHeap & lh) const override;
     
     template <typename SCAL, typename SCAL_SHAPES, typename SCAL_RES>
     void T_CalcElementMatrixAdd (const FiniteElement & fel,
@@ -821,6 +827,8 @@ public:
   public:
     NGS_DLL_HEADER SymbolicFacetBilinearFormIntegrator (shared_ptr<CoefficientFunction> acf, VorB avb, bool aelement_boundary);
 
+    const auto & GetCoefficientFunction() { return cf; }
+
     virtual VorB VB() const { return vb; }
     virtual bool BoundaryForm() const { return vb == BND; }
     virtual xbool IsSymmetric() const { return maybe; } 
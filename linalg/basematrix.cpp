@@ -181,6 +181,19 @@ namespace ngla
       MultAdd (alpha[i], *x[i], *y[i]);
   }
 
+  void BaseMatrix :: MultAddInterleaved (double s, SliceMatrix<double> x, SliceMatrix<double> y) const
+  {
+    auto hx = CreateRowVector();
+    auto hy = CreateColVector();
+    for (size_t j = 0; j < x.Width(); j++)
+      {
+        hx.FVDouble() = x.Col(j);
+        hy = 0.0;
+        MultAdd (s, hx, hy);
+        y.Col(j) += hy.FVDouble();
+      }
+  }
+
 
   
    // to split mat x vec for symmetric matrices
@@ -313,6 +326,16 @@ namespace ngla
     return "";
   }
 
+  string GetOrderingName (ORDERINGTYPE type)
+  {
+    switch (type)
+      {
+      case MINIMUM_DEGREE:     return "mindegree";
+      case NESTED_DISSECTION:  return "nesteddissection";
+      }
+    return "";
+  }
+
 
   BaseMatrix::OperatorInfo BaseMatrix :: GetOperatorInfo () const
   {
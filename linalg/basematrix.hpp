@@ -16,6 +16,10 @@ namespace ngla
   enum INVERSETYPE { PARDISO, PARDISOSPD, SPARSECHOLESKY, SUPERLU, SUPERLU_DIST, MUMPS, MASTERINVERSE, UMFPACK };
   extern string GetInverseName (INVERSETYPE type);
 
+  // fill-reducing ordering used by the sparse direct solver
+  enum ORDERINGTYPE { MINIMUM_DEGREE, NESTED_DISSECTION };
+  extern string GetOrderingName (ORDERINGTYPE type);
+
   /**
      The base for all matrices in the linalg.
   */
@@ -77,6 +81,8 @@ namespace ngla
     { return dynamic_pointer_cast<T> (shared_from_this()); }
     /// whatever it means ... e.g. refactor sparse factorization
     virtual void Update() { ; } 
+    /// does Update() recompute from the (modified) matrix values ?
+    virtual bool SupportsUpdate() const { return false; }
     /// creates matrix of same type
     virtual shared_ptr<BaseMatrix> CreateMatrix () const;
     /// creates a matching vector, size = width
@@ -105,6 +111,8 @@ namespace ngla
 
     /// y += alpha M x
     virtual void MultAdd (FlatVector<double> alpha, const MultiVector & x, MultiVector & y) const;
+    /// y += s M x for real vectors stored row-interleaved, x(i,j) is entry i of vector j
+    virtual void MultAddInterleaved (double s, SliceMatrix<double> x, SliceMatrix<double> y) const;
     
     /**
        to split mat x vec for symmetric matrices
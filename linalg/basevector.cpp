@@ -962,6 +962,14 @@ namespace ngla
       return mv2;
     }
 
+    unique_ptr<MultiVector> SubSet(const Array<int> & indices) const override
+    {
+      auto mv2 = make_unique<BaseVectorPtrMV>(refvec, 0);
+      for (auto i : indices)
+        mv2->vecs.Append (vecs[i]);
+      return mv2;
+    }
+
     void SetScalar (double s) override
     {
       static Timer t("BaseVector-MV :: SetScalar");
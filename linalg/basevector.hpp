@@ -1124,6 +1124,32 @@ namespace ngla
     // return InnerProduct( v2.FVComplex(), Conj(v1.FVComplex()) );
   }
 
+
+  /**
+     Several inner products with one global reduction.
+     Add computes the local contributions, Start issues a single
+     non-blocking AllReduce, and Wait returns the global values.
+     Work between Start and Wait hides the reduction latency.
+   */
+  template <class SCAL>
+  class NGS_DLL_HEADER FusedInnerProducts
+  {
+    Array<SCAL> values;
+    shared_ptr<ParallelDofs> pardofs;
+    MPI_Request request;
+    bool started = false;
+  public:
+    ~FusedInnerProducts () { Reset(); }
+    /// local part of (v1,v2), v1 is conjugated if requested. Returns the index of the value
+    int Add (const BaseVector & v1, const BaseVector & v2, bool conjugate = false);
+    ///
+    void Start ();
+    ///
+    FlatArray<SCAL> Wait ();
+    /// waits for a pending reduction and clears all values
+    void Reset ();
+  };
+
   ///
   inline double L2Norm (const BaseVector & v)
   {
@@ -30,6 +30,87 @@ namespace ngla
   { ; }
 
 
+  void BaseBlockJacobiPrecond ::
+  ComputeBlockColoring (const MatrixGraph & graph, size_t width)
+  {
+    *testout << "block coloring";
+
+    static Timer tcol("BlockJacobi-coloring");
+    tcol.Start();
+
+    size_t nblocks = blocktable->Size();
+    Array<int> coloring(nblocks);
+    coloring = -1;
+
+    int maxcolor = 0;
+    int basecol = 0;
+    Array<unsigned int> mask(width);
+    size_t found = 0;
+
+    do
+      {
+        mask = 0;
+        
+        for (auto i : Range(nblocks))
+          {
+            if (coloring[i] >= 0) continue;
+
+            unsigned check = 0;
+	    for (int d : (*blocktable)[i] )              
+              check |= mask[d];
+            
+            if (check != UINT_MAX) // 0xFFFFFFFF)
+              {
+                found++;
+                unsigned checkbit = 1;
+                int color = basecol;
+                while (check & checkbit)
+                  {
+                    color++;
+                    checkbit *= 2;
+                  }
+
+                coloring[i] = color;
+                if (color > maxcolor) maxcolor = color;
+                
+                for (int d : (*blocktable)[i] )
+                  for(auto coupling : graph.GetRowIndices(d))
+                    mask[coupling] |= checkbit;
+              }
+          }
+        basecol += 8*sizeof(unsigned int); // 32;
+      }
+    while (found < nblocks);
+    tcol.Stop();    
+
+    TableCreator<int> creator(maxcolor+1);
+    for ( ; !creator.Done(); creator++)
+      for (size_t i = 0; i < nblocks; i++)
+          creator.Add (coloring[i], i);
+    block_coloring = creator.MoveTable();
+
+    cout << IM(4) << " using " << maxcolor+1 << " colors" << endl;
+
+    // calc balancing:
+
+    color_balance.SetSize (block_coloring.Size());
+
+    for (auto c : Range (block_coloring))
+      {
+        color_balance[c].Calc (block_coloring[c].Size(),
+                               [&] (size_t bi)
+                               {
+                                 int costs = 0;
+                                 size_t blocknr = block_coloring[c][bi];
+
+                                 for (auto d : (*blocktable)[blocknr])
+                                   costs += graph.GetRowIndices(d).Size();
+                                 return costs;
+                               });
+      }
+  }
+
+
   int BaseBlockJacobiPrecond ::
   Reorder (FlatArray<int> block, const MatrixGraph & graph,
 	   FlatArray<int> block_inv,
@@ -497,82 +578,7 @@ namespace ngla
        } );
 
     cout << IM(3) << "\rBuilding block " << blocktable->Size() << "/" << blocktable->Size() << flush;
-    *testout << "block coloring";
-
-    static Timer tcol("BlockJacobi-coloring");
-    tcol.Start();
-
-    size_t nblocks = blocktable->Size();
-    Array<int> coloring(nblocks);
-    coloring = -1;
-
-    int maxcolor = 0;
-    int basecol = 0;
-    Array<unsigned int> mask(mat.Width());
-    size_t found = 0;
-
-    do
-      {
-        mask = 0;
-        
-        for (auto i : Range(nblocks))
-          {
-            if (coloring[i] >= 0) continue;
-
-            unsigned check = 0;
-	    for (int d : (*blocktable)[i] )              
-              check |= mask[d];
-            
-            if (check != UINT_MAX) // 0xFFFFFFFF)
-              {
-                found++;
-                unsigned checkbit = 1;
-                int color = basecol;
-                while (check & checkbit)
-                  {
-                    color++;
-                    checkbit *= 2;
-                  }
-
-                coloring[i] = color;
-                if (color > maxcolor) maxcolor = color;
-                
-                for (int d : (*blocktable)[i] )
-                  for(auto coupling : mat.GetRowIndices(d))
-                    mask[coupling] |= checkbit;
-              }
-          }
-        basecol += 8*sizeof(unsigned int); // 32;
-      }
-    while (found < nblocks);
-    tcol.Stop();    
-
-    TableCreator<int> creator(maxcolor+1);
-    for ( ; !creator.Done(); creator++)
-      for (size_t i = 0; i < nblocks; i++)
-          creator.Add (coloring[i], i);
-    block_coloring = creator.MoveTable();
-
-    cout << IM(4) << " using " << maxcolor+1 << " colors" << endl;
-
-    // calc balancing:
-
-    color_balance.SetSize (block_coloring.Size());
-
-    for (auto c : Range (block_coloring))
-      {
-        color_balance[c].Calc (block_coloring[c].Size(),
-                               [&] (size_t bi)
-                               {
-                                 int costs = 0;
-                                 size_t blocknr = block_coloring[c][bi];
-
-                                 for (auto d : (*blocktable)[blocknr])
-                                   costs += mat.GetRowIndices(d).Size();
-                                 return costs;
-                               });
-
-      }
+    ComputeBlockColoring (mat, mat.Width());
 
     cout << IM(3) << "\rBlockJacobi Preconditioner built" << endl;
   }
@@ -630,6 +636,76 @@ namespace ngla
   }
 
 
+  template <class TM, class TV_ROW, class TV_COL>
+  void BlockJacobiPrecond<TM, TV_ROW, TV_COL> ::
+  MultAdd (FlatVector<double> alpha, const MultiVector & x, MultiVector & y) const 
+  {
+    if constexpr (!is_same<TM,double>::value || !is_same<TVX,double>::value)
+      BaseMatrix::MultAdd (alpha, x, y);
+    else
+      {
+        static Timer timer("BlockJacobi::MultAdd - MultiVector");
+        RegionTimer reg (timer);
+
+        size_t k = alpha.Size();
+        for (size_t j = 0; j < k; j++)
+          {
+            x[j]->Cumulate();
+            y[j]->Cumulate();
+          }
+
+        Matrix<double> hx(mat.Width(), k), hy(mat.Height(), k);
+        x.CopyToInterleaved (hx);
+        hy = 0.0;
+        MultAddInterleaved (1, hx, hy);
+        y.AddFromInterleaved (alpha, hy);
+      }
+  }
+
+
+  template <class TM, class TV_ROW, class TV_COL>
+  void BlockJacobiPrecond<TM, TV_ROW, TV_COL> ::
+  MultAddInterleaved (double s, SliceMatrix<double> x, SliceMatrix<double> y) const 
+  {
+    if constexpr (!is_same<TM,double>::value || !is_same<TVX,double>::value)
+      BaseMatrix::MultAddInterleaved (s, x, y);
+    else
+      {
+        static Timer timer("BlockJacobi::MultAddInterleaved");
+        RegionTimer reg (timer);
+
+        size_t k = x.Width();
+        for (int c : Range(block_coloring))        
+          {
+            ParallelForRange
+              (color_balance[c],  [&] (IntRange r) 
+               {
+                 Matrix<double> hxmax(maxbs, k);
+                 Matrix<double> hymax(maxbs, k);
+                 
+                 for (int i : block_coloring[c].Range(r))
+                   {
+                     FlatArray<int> block = (*blocktable)[i];
+                     size_t bs = block.Size();
+                     if (!bs) continue;
+                     
+                     FlatMatrix<double> hx = hxmax.Rows(0,bs); 
+                     FlatMatrix<double> hy = hymax.Rows(0,bs); 
+                     
+                     for (size_t j = 0; j < bs; j++)
+                       hx.Row(j) = x.Row(block[j]);
+                     
+                     hy = invdiag[i] * hx;
+                     
+                     for (size_t j = 0; j < bs; j++)
+                       y.Row(block[j]) += s * hy.Row(j);
+                   }
+               });
+          }
+      }
+  }
+
+
   template <class TM, class TV_ROW, class TV_COL>
   void BlockJacobiPrecond<TM, TV_ROW, TV_COL> ::
   MultTransAdd (TSCAL s, const BaseVector & x, BaseVector & y) const 
@@ -849,6 +925,221 @@ namespace ngla
 
 
 
+  BlockJacobiPrecondFloat ::
+  BlockJacobiPrecondFloat (const SparseMatrixFloat & amat, 
+                           shared_ptr<Table<int>> ablocktable)
+    : BaseBlockJacobiPrecond(ablocktable), mat(amat)
+  {
+    static Timer t("BlockJacobiPrecondFloat ctor"); RegionTimer reg(t);
+    cout << IM(3) << "BlockJacobi Preconditioner (float), constructor called, #blocks = " << blocktable->Size() << endl;
+
+    nze = 
+      ParallelReduce (blocktable->Size(),
+                      [&] (size_t i)
+                      {
+                        size_t nze = 0;
+                        for (auto row : (*blocktable)[i])
+                          nze += amat.GetRowIndices(row).Size();
+                        return nze;
+                      },
+                      [] (size_t a, size_t b) { return a+b; },
+                      size_t(0));
+
+    firstinv.SetSize (blocktable->Size()+1);
+    firstinv[0] = 0;
+    for (auto i : Range (*blocktable))
+      firstinv[i+1] = firstinv[i] + sqr ((*blocktable)[i].Size());
+    bigmem.SetSize (firstinv.Last());
+
+    // get and invert the diagonal blocks in double, store them in float
+    ParallelFor (blocktable->Size(), [&] (size_t i)
+                 {
+                   auto blocki = (*blocktable)[i];
+                   QuickSort (blocki);
+                   size_t bs = blocki.Size();
+                   if (!bs) return;
+                   
+                   Matrix<double> blockmat(bs);
+                   for (size_t j = 0; j < bs; j++)
+                     for (size_t k = 0; k < bs; k++)
+                       blockmat(j,k) = mat(blocki[j], blocki[k]);
+                   CalcInverse (blockmat);
+
+                   float * pinv = bigmem.Data() + firstinv[i];
+                   for (size_t j = 0; j < bs; j++)
+                     for (size_t k = 0; k < bs; k++)
+                       pinv[j*bs+k] = blockmat(j,k);
+                 });
+
+    ComputeBlockColoring (mat, mat.Width());
+    cout << IM(3) << "\rBlockJacobi Preconditioner (float) built" << endl;
+  }
+
+
+  void BlockJacobiPrecondFloat ::
+  ApplyBlock (size_t i, FlatVector<double> hx, FlatVector<double> hy, bool trans) const
+  {
+    size_t bs = hx.Size();
+    const float * pinv = bigmem.Data() + firstinv[i];
+    if (!trans)
+      for (size_t j = 0; j < bs; j++, pinv += bs)
+        {
+          double sum = 0;
+          for (size_t k = 0; k < bs; k++)
+            sum += double(pinv[k]) * hx(k);
+          hy(j) = sum;
+        }
+    else
+      {
+        hy = 0.0;
+        for (size_t j = 0; j < bs; j++, pinv += bs)
+          {
+            double hxj = hx(j);
+            for (size_t k = 0; k < bs; k++)
+              hy(k) += double(pinv[k]) * hxj;
+          }
+      }
+  }
+
+  
+  void BlockJacobiPrecondFloat ::
+  MultAdd (double s, const BaseVector & x, BaseVector & y) const 
+  {
+    static Timer timer("BlockJacobiFloat::MultAdd");
+    RegionTimer reg (timer);
+    
+    x.Cumulate();
+    y.Cumulate();
+
+    FlatVector<double> fx = x.FVDouble();
+    FlatVector<double> fy = y.FVDouble();
+
+    for (int c : Range(block_coloring))        
+      {
+        ParallelForRange
+          (color_balance[c],  [&] (IntRange r) 
+           {
+             VectorMem<100> hxmax(maxbs);
+             VectorMem<100> hymax(maxbs);
+             
+             for (size_t i : block_coloring[c].Range(r))
+               {
+                 FlatArray<int> block = (*blocktable)[i];
+                 size_t bs = block.Size();
+                 if (!bs) continue;
+                 
+                 FlatVector<double> hx = hxmax.Range(0,bs); 
+                 FlatVector<double> hy = hymax.Range(0,bs); 
+                 
+                 for (size_t j = 0; j < bs; j++)
+                   hx(j) = fx(block[j]);
+                 ApplyBlock (i, hx, hy);
+                 fy(block) += s * hy;
+               }
+           });
+      }
+  }
+
+  
+  void BlockJacobiPrecondFloat ::
+  MultTransAdd (double s, const BaseVector & x, BaseVector & y) const 
+  {
+    static Timer timer("BlockJacobiFloat::MultTransAdd");
+    RegionTimer reg (timer);
+    
+    x.Cumulate();
+    y.Cumulate();
+
+    FlatVector<double> fx = x.FVDouble();
+    FlatVector<double> fy = y.FVDouble();
+
+    for (int c : Range(block_coloring))        
+      {
+        ParallelForRange
+          (color_balance[c],  [&] (IntRange r) 
+           {
+             VectorMem<100> hxmax(maxbs);
+             VectorMem<100> hymax(maxbs);
+             
+             for (size_t i : block_coloring[c].Range(r))
+               {
+                 FlatArray<int> block = (*blocktable)[i];
+                 size_t bs = block.Size();
+                 if (!bs) continue;
+                 
+                 FlatVector<double> hx = hxmax.Range(0,bs); 
+                 FlatVector<double> hy = hymax.Range(0,bs); 
+                 
+                 for (size_t j = 0; j < bs; j++)
+                   hx(j) = fx(block[j]);
+                 ApplyBlock (i, hx, hy, true);
+                 fy(block) += s * hy;
+               }
+           });
+      }
+  }
+
+
+  void BlockJacobiPrecondFloat ::
+  SmoothBlocks (FlatVector<double> fx, FlatVector<double> fb, bool backward) const
+  {
+    for (int cc = 0; cc < block_coloring.Size(); cc++)
+      {
+        int c = backward ? block_coloring.Size()-1-cc : cc;
+        ParallelForRange
+          (color_balance[c], [&] (IntRange r)
+           {
+             VectorMem<100> hxmax(maxbs);
+             VectorMem<100> hymax(maxbs);
+             
+             for (size_t i : block_coloring[c].Range(r))
+               {
+                 FlatArray<int> block = (*blocktable)[i];
+                 size_t bs = block.Size();
+                 if (!bs) continue;
+                 
+                 FlatVector<double> hx = hxmax.Range(0,bs); 
+                 FlatVector<double> hy = hymax.Range(0,bs); 
+                 
+                 for (size_t j = 0; j < bs; j++)
+                   {
+                     auto jj = block[j];
+                     hx(j) = fb(jj) - mat.RowTimesVector (jj, fx);
+                   }
+
+                 ApplyBlock (i, hx, hy);
+                 fx(block) += hy;
+               }
+           });
+      }
+  }
+
+  
+  void BlockJacobiPrecondFloat ::
+  GSSmooth (BaseVector & x, const BaseVector & b, int steps) const 
+  {
+    static Timer timer ("BlockJacobiPrecondFloat::GSSmooth");
+    RegionTimer reg(timer);
+    timer.AddFlops (nze);
+
+    for (int k = 0; k < steps; k++)
+      SmoothBlocks (x.FVDouble(), b.FVDouble(), false);
+  }
+
+  void BlockJacobiPrecondFloat ::
+  GSSmoothBack (BaseVector & x, const BaseVector & b, int steps) const 
+  {
+    static Timer timer ("BlockJacobiPrecondFloat::GSSmoothBack");
+    RegionTimer reg(timer);
+    timer.AddFlops (nze);
+
+    for (int k = 0; k < steps; k++)
+      SmoothBlocks (x.FVDouble(), b.FVDouble(), true);
+  }
+
+
+
+
   ///
   template <class TM, class TV>
   BlockJacobiPrecondSymmetric<TM,TV> ::
@@ -880,6 +1171,15 @@ namespace ngla
     for (int i = 0; i < NBLOCKS; i++)
       memneed[i] = 0;
 
+    if (mat.GetOrderingType() != MINIMUM_DEGREE)
+      {
+        sparse_blockmat.SetSize(n);
+        sparse_inv.SetSize(n);
+        for (size_t i = 0; i < n; i++)
+          if ((*blocktable)[i].Size() > sparse_blocksize)
+            ComputeSparseBlockFactor (i);
+      }
+    
     {
       LocalHeap lh (20000 + 5*sizeof(int)*maxbs, "blockjacobi-heap"); 
       Array<int> block_inv(amat.Height());
@@ -890,6 +1190,14 @@ namespace ngla
 	  int bs = (*blocktable)[i].Size();
 	  
 	  if (!bs) continue;
+
+          if (sparse_inv.Size() && sparse_inv[i])
+            {
+              blocksize[i] = bs;
+              blockbw[i] = 0;
+              blockstart[i] = 0;
+              continue;
+            }
 	  
 	  blockbw[i] = Reorder ((*blocktable)[i], mat, block_inv, lh);
 	  blocksize[i] = bs;
@@ -926,6 +1234,7 @@ namespace ngla
                         int bs = (*blocktable)[i].Size();
                         
                         if (!bs) return;
+                        if (sparse_inv.Size() && sparse_inv[i]) return;
                         int bw = blockbw[i];
                         
                         try
@@ -1069,6 +1378,63 @@ namespace ngla
   } 
 
 
+  template <class TM, class TV>
+  void BlockJacobiPrecondSymmetric<TM,TV> :: 
+  ComputeSparseBlockFactor (int i)
+  {
+    FlatArray<int> block = (*blocktable)[i];
+    int bs = block.Size();
+
+    Array<int> block_inv(mat.Height());
+    block_inv = -1;
+    for (int j = 0; j < bs; j++)
+      block_inv[block[j]] = j;
+
+    // lower triangular part in block numbering
+    Array<int> cnt(bs);
+    cnt = 0;
+    for (int j = 0; j < bs; j++)
+      for (auto col : mat.GetRowIndices(block[j]))
+        if (block_inv[col] != -1)
+          cnt[max2 (j, block_inv[col])]++;
+
+    auto blockmat = make_shared<SparseMatrixSymmetric<TM,TV>> (cnt);
+    for (int j = 0; j < bs; j++)
+      {
+        auto cols = mat.GetRowIndices(block[j]);
+        auto vals = mat.GetRowValues(block[j]);
+        for (size_t k = 0; k < cols.Size(); k++)
+          {
+            int lc = block_inv[cols[k]];
+            if (lc == -1) continue;
+            if (lc <= j)
+              (*blockmat)(j, lc) = vals[k];
+            else
+              (*blockmat)(lc, j) = Trans (vals[k]);
+          }
+      }
+
+    blockmat->SetInverseType (SPARSECHOLESKY);
+    blockmat->SetOrderingType (mat.GetOrderingType());
+    sparse_blockmat[i] = blockmat;
+    sparse_inv[i] = blockmat->InverseMatrix();
+  }
+
+
+  template <class TM, class TV>
+  void BlockJacobiPrecondSymmetric<TM,TV> :: 
+  ApplyBlockInverse (int i, FlatVector<TVX> di, FlatVector<TVX> wi) const
+  {
+    if (sparse_inv.Size() && sparse_inv[i])
+      {
+        VFlatVector<TVX> vdi(di), vwi(wi);
+        sparse_inv[i]->Mult (vdi, vwi);
+      }
+    else
+      InvDiag(i).Mult (di, wi);
+  }
+
+
 
 
 
@@ -1099,7 +1465,7 @@ namespace ngla
 	for (int j = 0; j < bs; j++)
 	  hx(j) = fx((*blocktable)[i][j]);
 	
-	InvDiag(i).Mult (hx, hy);
+	ApplyBlockInverse (i, hx, hy);
 
 	for (int j = 0; j < bs; j++)
 	  fy((*blocktable)[i][j]) += s * hy(j);
@@ -1138,10 +1504,7 @@ namespace ngla
       
       for (int k = 1; k <= steps; k++)
         for (size_t c = 0; c < block_coloring.Size(); c++)
-          ParallelFor (color_balance[c], [&] (int bi)
-                       {
-                         SmoothBlock (block_coloring[c][bi], fx, fy);
-                       });
+          SmoothColor (c, fx, fy);
     
     else
       
@@ -1166,10 +1529,7 @@ namespace ngla
     if (task_manager)
       
       for (size_t c = 0; c < block_coloring.Size(); c++)
-        ParallelFor (color_balance[c], [&] (int bi)
-                     {
-                       SmoothBlock (block_coloring[c][bi], fx, fy);
-                     });
+        SmoothColor (c, fx, fy);
     
     else
 
@@ -1237,10 +1597,7 @@ namespace ngla
     if (task_manager)
       
       for (int c = block_coloring.Size()-1; c >= 0; c--)
-        ParallelFor (color_balance[c], [&] (int bi)
-                     {
-                       SmoothBlock (block_coloring[c][bi], fx, /* fb, */ fy);
-                     });
+        SmoothColor (c, fx, fy);
     else
 
       for (int i = blocktable->Size()-1; i >= 0; i--)
@@ -1250,6 +1607,25 @@ namespace ngla
 
 
 
+  template <class TM, class TV>
+  void BlockJacobiPrecondSymmetric<TM,TV> :: 
+  SmoothColor (size_t c, FlatVector<TVX> & x, FlatVector<TVX> & y) const
+  {
+    // sparse block solves run parallel tasks on their own,
+    // they follow the dense blocks of the color one by one
+    ParallelFor (color_balance[c], [&] (int bi)
+                 {
+                   int i = block_coloring[c][bi];
+                   if (!sparse_inv.Size() || !sparse_inv[i])
+                     SmoothBlock (i, x, y);
+                 });
+    if (sparse_inv.Size())
+      for (int i : block_coloring[c])
+        if (sparse_inv[i])
+          SmoothBlock (i, x, y);
+  }
+
+
   template <class TM, class TV>
   void BlockJacobiPrecondSymmetric<TM,TV> :: 
   SmoothBlock (int i, 
@@ -1267,8 +1643,8 @@ namespace ngla
     // di = P_i (y - L x)
     for (int j = 0; j < bs; j++)
       di(j) = y(row[j]) - mat.RowTimesVectorNoDiag (row[j], x);
-    if (!lowmem)
-      InvDiag(i).Mult (di, wi);
+    if (!lowmem || (sparse_inv.Size() && sparse_inv[i]))
+      ApplyBlockInverse (i, di, wi);
     else
       {
 	int bw = blockbw[i];
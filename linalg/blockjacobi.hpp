@@ -62,6 +62,9 @@ namespace ngla
     }
 
 
+    /// colors the blocks such that blocks of one color do not couple via the graph
+    void ComputeBlockColoring (const MatrixGraph & graph, size_t width);
+
     /// reorders block entries for band-width minimization
     int Reorder (FlatArray<int> block, const MatrixGraph & graph,
 		 FlatArray<int> usedflags,        // in and out: array of -1, size = graph.size
@@ -141,6 +144,10 @@ namespace ngla
     
     ///
     void MultAdd (TSCAL s, const BaseVector & x, BaseVector & y) const override;
+    /// every inverse block is applied to all vectors at once
+    void MultAdd (FlatVector<double> alpha, const MultiVector & x, MultiVector & y) const override;
+    ///
+    void MultAddInterleaved (double s, SliceMatrix<double> x, SliceMatrix<double> y) const override;
 
     ///
     void MultTransAdd (TSCAL s, const BaseVector & x, BaseVector & y) const override;
@@ -186,6 +193,61 @@ namespace ngla
 
 
 
+  /**
+     A block-Jacobi preconditioner with inverted diagonal blocks 
+     stored in single precision. Block applications accumulate in double.
+  */
+  class NGS_DLL_HEADER BlockJacobiPrecondFloat : virtual public BaseBlockJacobiPrecond,
+                                                 virtual public S_BaseMatrix<double>
+  {
+  protected:
+    /// a reference to the matrix
+    const SparseMatrixFloat & mat;
+    /// first entry of inverse block i in bigmem
+    Array<size_t> firstinv;
+    /// the data for the inverses, row-major
+    Array<float> bigmem;
+
+  public:
+    BlockJacobiPrecondFloat (const SparseMatrixFloat & amat, 
+                             shared_ptr<Table<int>> ablocktable);
+
+    int VHeight() const override { return mat.Height(); }
+    int VWidth() const override { return mat.Width(); }
+
+    AutoVector CreateRowVector() const override { return mat.CreateColVector(); }
+    AutoVector CreateColVector() const override { return mat.CreateRowVector(); }
+    
+    void MultAdd (double s, const BaseVector & x, BaseVector & y) const override;
+    void MultTransAdd (double s, const BaseVector & x, BaseVector & y) const override;
+
+    void GSSmooth (BaseVector & x, const BaseVector & b,
+                   int steps = 1) const override;
+
+    void GSSmoothBack (BaseVector & x, const BaseVector & b,
+                       int steps = 1) const override;
+  
+    void GSSmoothResiduum (BaseVector & x, const BaseVector & b,
+                           BaseVector & res, int steps = 1) const  override
+    {
+      GSSmooth (x, b, 1);
+      res = b - mat * x;
+    }
+
+    Array<MemoryUsage> GetMemoryUsage () const override
+    {
+      return { MemoryUsage ("BlockJacFloat", bigmem.Size()*sizeof(float), blocktable->Size()) };
+    }
+
+  protected:
+    /// hy = inv_i * hx, or Trans(inv_i) * hx 
+    void ApplyBlock (size_t i, FlatVector<double> hx, FlatVector<double> hy, bool trans = false) const;
+    void SmoothBlocks (FlatVector<double> fx, FlatVector<double> fb, bool backward) const;
+  };
+
+
+
+
   /* **************** SYMMETRIC ****************** */
 
 
@@ -206,6 +268,11 @@ namespace ngla
     Array<int> blockstart, blocksize, blockbw;
     Array<TM> data[NBLOCKS];
 
+    // with a fill-reducing ordering requested by the matrix, 
+    // large blocks are factored by sparse cholesky instead of band cholesky
+    static constexpr size_t sparse_blocksize = 1000;
+    Array<shared_ptr<BaseSparseMatrix>> sparse_blockmat;
+    Array<shared_ptr<BaseMatrix>> sparse_inv;
 
     bool lowmem;
   public:
@@ -233,6 +300,12 @@ namespace ngla
     }
 
     void ComputeBlockFactor (FlatArray<int> block, int bw, FlatBandCholeskyFactors<TM> & inv) const;
+
+    /// the block as sparse matrix, and its sparse cholesky factor
+    void ComputeSparseBlockFactor (int i);
+
+    /// wi = A_i^{-1} di
+    void ApplyBlockInverse (int i, FlatVector<TVX> di, FlatVector<TVX> wi) const;
   
     ///
     void MultAdd (TSCAL s, const BaseVector & x, BaseVector & y) const override;
@@ -281,6 +354,9 @@ namespace ngla
 		      FlatVector<TVX> & x,
 		      // const FlatVector<TVX> & b,
 		      FlatVector<TVX> & y) const;
+
+    /// smooth all blocks of color c
+    void SmoothColor (size_t c, FlatVector<TVX> & x, FlatVector<TVX> & y) const;
  
 
     ///
@@ -253,6 +253,893 @@ namespace ngla
   }
 
 
+
+  // local part of the inner product S_InnerProduct<IPTYPE> (v1, v2)
+  template <class IPTYPE>
+  inline int S_AddInnerProduct (FusedInnerProducts<typename SCAL_TRAIT<IPTYPE>::SCAL> & ips,
+                                const BaseVector & v1, const BaseVector & v2)
+  {
+    if constexpr (is_same<IPTYPE,ComplexConjugate2>::value)
+      return ips.Add (v2, v1, true);
+    return ips.Add (v1, v2, is_same<IPTYPE,ComplexConjugate>::value);
+  }
+
+  // conjugate, if the inner product of IPTYPE conjugates the first argument
+  template <class IPTYPE, typename SCAL>
+  inline SCAL S_Conj (SCAL v)
+  {
+    if constexpr (is_same<IPTYPE,ComplexConjugate>::value)
+      return Conj(v);
+    return v;
+  }
+
+
+  template <class IPTYPE>
+  void PipelinedCGSolver<IPTYPE> :: Mult (const BaseVector & f, BaseVector & x) const
+  {
+    static Timer timer ("Pipelined CG solver");
+    RegionTimer reg (timer);
+
+    try
+      {
+	// Ghysels, Vanroose: Hiding global synchronization latency 
+	// in the preconditioned Conjugate Gradient algorithm, Alg. 4
+	if(sh)
+	  sh->SetThreadPercentage(0);
+
+        auto r = f.CreateVector();    // residual
+        auto u = x.CreateVector();    // C r
+        auto w = f.CreateVector();    // A u
+        auto m = x.CreateVector();    // C w
+        auto n = f.CreateVector();    // A m
+        auto p = x.CreateVector();    // search direction
+        auto s = f.CreateVector();    // A p
+        auto q = x.CreateVector();    // C s
+        auto z = f.CreateVector();    // A q
+
+	if (initialize)
+	  {
+	    x = 0.0;
+	    r = f;
+	  }
+	else
+	  {
+	    r = f - (*a) * x;
+	  }
+
+	if (c)
+	  u = (*c) * r;
+	else
+	  u = r;
+        w = (*a) * u;
+
+        FusedInnerProducts<SCAL> ips;
+	SCAL gamma, gamma_old = 0.0, delta, al = 0.0, be = 0.0;
+	double err = 0, lwstart = 0, lerr = 0;
+	int it = 0;
+
+	while (true)
+	  {
+            ips.Reset();
+            S_AddInnerProduct<IPTYPE> (ips, u, r);
+            S_AddInnerProduct<IPTYPE> (ips, u, w);
+            ips.Start();
+
+            // overlaps with the reduction
+            if (c)
+              m = (*c) * w;
+            else
+              m = w;
+            n = (*a) * m;
+
+            FlatArray<SCAL> ip = ips.Wait();
+            gamma = ip[0];
+            delta = ip[1];
+
+	    if (printrates) cout << IM(1) << it << " " << sqrt (Abs (gamma)) << endl;
+            if (it == 0)
+              {
+                err = stop_absolute ? prec * prec : prec * prec * Abs (gamma);
+                lwstart = log(Abs(gamma));
+                lerr = log(err);
+              }
+            else if (sh)
+	      sh->SetThreadPercentage(100.*max2(double(it)/double(maxsteps),
+						(lwstart-log(Abs(gamma)))/(lwstart-lerr)));
+
+            if (Abs(gamma) <= err || it >= maxsteps || (sh && sh->ShouldTerminate()))
+              break;
+
+            SCAL denom = delta;
+            if (it > 0)
+              {
+                be = gamma / gamma_old;
+                denom = delta - be * gamma / al;
+              }
+            if (denom == 0.0) break;
+            al = gamma / denom;
+
+            if (it == 0)
+              {
+                z = n;
+                q = m;
+                s = w;
+                p = u;
+              }
+            else
+              {
+                z *= be; z += n;
+                q *= be; q += m;
+                s *= be; s += w;
+                p *= be; p += u;
+              }
+
+            x += al * p;
+            r -= al * s;
+            u -= al * q;
+            w -= al * z;
+
+            gamma_old = gamma;
+            it++;
+	  }
+
+	const_cast<int&> (steps) = it;
+      }
+
+    catch (Exception & e)
+      {
+	e.Append ("in caught in PipelinedCGSolver::Mult\n");
+	throw;
+      }
+  }
+
+
+
+  template <class IPTYPE>
+  void SStepCGSolver<IPTYPE> :: Mult (const BaseVector & f, BaseVector & x) const
+  {
+    static Timer timer ("s-step CG solver");
+    RegionTimer reg (timer);
+
+    try
+      {
+	// Chronopoulos, Gear: s-step iterative methods for symmetric linear systems.
+        // The block R = [C r, (CA) C r, ...] is A-orthogonalized against the previous
+        // directions P_old:  P = R - P_old B,  B = W_old^{-1} (P_old, A R),
+        // then  x += P a,  a = W^{-1} (P, r)  with  W = (P, A P) = (R, A R) - B^* (P_old, A R).
+	if(sh)
+	  sh->SetThreadPercentage(0);
+
+        auto r = f.CreateVector();
+        // two banks, alternating between current block and previous directions
+        Array<AutoVector> pv[2], apv[2];
+        for (int k = 0; k < 2; k++)
+          {
+            pv[k].SetSize(s);
+            apv[k].SetSize(s);
+            for (int j = 0; j < s; j++)
+              {
+                pv[k][j].AssignPointer (x.CreateVector());
+                apv[k][j].AssignPointer (f.CreateVector());
+              }
+          }
+
+        Matrix<SCAL> gram(s), wmat(s), winv(s), cmat(s), bmat(s);
+        Vector<SCAL> rhs(s), coef(s);
+
+	if (initialize)
+	  {
+	    x = 0.0;
+	    r = f;
+	  }
+	else
+	  {
+	    r = f - (*a) * x;
+	  }
+
+        FusedInnerProducts<SCAL> ips;
+	double err = 0, lwstart = 0, lerr = 0;
+	int it = 0, cur = 0;
+
+	while (true)
+	  {
+            auto & rv = pv[cur];
+            auto & arv = apv[cur];
+            auto & pold = pv[1-cur];
+            auto & apold = apv[1-cur];
+
+            for (int j = 0; j < s; j++)
+              {
+                const BaseVector & src = (j == 0) ? *r : *arv[j-1];
+                if (c)
+                  rv[j] = (*c) * src;
+                else
+                  rv[j] = src;
+                arv[j] = (*a) * rv[j];
+              }
+
+            ips.Reset();
+            for (int i = 0; i < s; i++)
+              for (int j = 0; j < s; j++)
+                S_AddInnerProduct<IPTYPE> (ips, rv[i], arv[j]);
+            for (int i = 0; i < s; i++)
+              S_AddInnerProduct<IPTYPE> (ips, rv[i], r);
+            if (it > 0)
+              for (int i = 0; i < s; i++)
+                for (int j = 0; j < s; j++)
+                  S_AddInnerProduct<IPTYPE> (ips, apold[i], rv[j]);
+            ips.Start();
+            FlatArray<SCAL> ip = ips.Wait();
+
+            for (int i = 0; i < s; i++)
+              {
+                for (int j = 0; j < s; j++)
+                  gram(i,j) = ip[i*s+j];
+                rhs(i) = ip[s*s+i];
+              }
+
+            // rhs(0) = (C r, r)
+	    if (printrates) cout << IM(1) << it << " " << sqrt (Abs (rhs(0))) << endl;
+            if (it == 0)
+              {
+                err = stop_absolute ? prec * prec : prec * prec * Abs (rhs(0));
+                lwstart = log(Abs(rhs(0)));
+                lerr = log(err);
+              }
+            else if (sh)
+	      sh->SetThreadPercentage(100.*max2(double(it)/double(maxsteps),
+						(lwstart-log(Abs(rhs(0))))/(lwstart-lerr)));
+
+            if (Abs(rhs(0)) <= err || it >= maxsteps || (sh && sh->ShouldTerminate()))
+              break;
+
+            if (it == 0)
+              wmat = gram;
+            else
+              {
+                for (int i = 0; i < s; i++)
+                  for (int j = 0; j < s; j++)
+                    cmat(i,j) = ip[s*s+s+i*s+j];
+                bmat = winv * cmat;
+
+                for (int i = 0; i < s; i++)
+                  for (int j = 0; j < s; j++)
+                    {
+                      SCAL sum = gram(i,j);
+                      for (int k = 0; k < s; k++)
+                        sum -= S_Conj<IPTYPE>(bmat(k,i)) * cmat(k,j);
+                      wmat(i,j) = sum;
+                    }
+
+                for (int j = 0; j < s; j++)
+                  for (int i = 0; i < s; i++)
+                    {
+                      rv[j] -= bmat(i,j) * *pold[i];
+                      arv[j] -= bmat(i,j) * *apold[i];
+                    }
+              }
+
+            winv = wmat;
+            CalcInverse (winv);
+            coef = winv * rhs;
+
+            for (int j = 0; j < s; j++)
+              {
+                x += coef(j) * *rv[j];
+                r -= coef(j) * *arv[j];
+              }
+
+            cur = 1-cur;
+            it += s;
+	  }
+
+	const_cast<int&> (steps) = it;
+      }
+
+    catch (Exception & e)
+      {
+	e.Append ("in caught in SStepCGSolver::Mult\n");
+	throw;
+      }
+  }
+
+
+
+  template <class IPTYPE>
+  void SStepGMRESSolver<IPTYPE> :: Mult (const BaseVector & f, BaseVector & x) const
+  {
+    static Timer timer ("s-step GMRES solver");
+    RegionTimer reg (timer);
+
+    try
+      {
+        // Hoemmen: Communication-avoiding Krylov subspace methods, CA-GMRES without restart.
+        // V_0 = q_n, V_i = (CA)^i q_n are orthonormalized against q_0..q_n,
+        //   V_i = sum_k coefs(k,i) q_k,
+        // and  CA V_{i-1} = V_i  gives the Hessenberg column of q_{n+i-1}
+        auto r = f.CreateVector();
+        auto hv = f.CreateVector();
+
+        int maxdim = max2(maxsteps, 1);
+        Array<AutoVector> q(maxdim+1), v(s);
+        for (int j = 0; j < s; j++)
+          v[j].AssignPointer (x.CreateVector());
+
+        Matrix<SCAL> h(maxdim+1, maxdim), hr(maxdim+1, maxdim);
+        Matrix<SCAL> coefs(maxdim+1, s+1), rmat(s);
+        Vector<SCAL> g(maxdim+1), si(maxdim);
+        Vector<double> ci(maxdim);
+        h = SCAL(0.0);
+        g = SCAL(0.0);
+
+	if (initialize)
+	  {
+	    x = 0.0;
+	    r = f;
+	  }
+	else
+	  {
+	    r = f - (*a) * x;
+	  }
+
+	if (c)
+          {
+            hv = (*c) * r;
+            r = hv;
+          }
+
+        FusedInnerProducts<SCAL> ips;
+        ips.Add (r, r, true);
+        ips.Start();
+        double norm = sqrt (Abs (ips.Wait()[0]));
+
+	if (printrates) cout << IM(1) << "0 " << norm << endl;
+	double err = stop_absolute ? prec : prec * norm;
+
+        int n = 0;   // number of Hessenberg columns
+        if (norm > 0)
+          {
+            q[0].AssignPointer (x.CreateVector());
+            q[0] = (1.0/norm) * r;
+            g(0) = norm;
+          }
+        
+        bool done = (norm <= err);
+        while (!done && n < maxdim && !(sh && sh->ShouldTerminate()))
+          {
+            int sb = min2(s, maxdim - n);
+            for (int i = 0; i < sb; i++)
+              {
+                hv = (*a) * ((i == 0) ? *q[n] : *v[i-1]);
+                if (c)
+                  v[i] = (*c) * hv;
+                else
+                  v[i] = hv;
+              }
+
+            // one reduction for (Q, V) and (V, V)
+            ips.Reset();
+            for (int j = 0; j < sb; j++)
+              for (int k = 0; k <= n; k++)
+                ips.Add (q[k], v[j], true);
+            for (int i = 0; i < sb; i++)
+              for (int j = i; j < sb; j++)
+                ips.Add (v[i], v[j], true);
+            ips.Start();
+            FlatArray<SCAL> ip = ips.Wait();
+
+            coefs = SCAL(0.0);
+            coefs(n,0) = 1.0;
+            for (int j = 0; j < sb; j++)
+              for (int k = 0; k <= n; k++)
+                coefs(k,j+1) = ip[j*(n+1)+k];
+
+            // Cholesky-QR of the projected block, stops at rank deficiency
+            int nvec = sb;
+            size_t first = sb*(n+1);
+            for (int j = 0; j < sb && nvec == sb; j++)
+              {
+                for (int i = 0; i <= j; i++)
+                  {
+                    // (V_i, V_j) projected
+                    SCAL sum = ip[first + i*sb - i*(i-1)/2 + (j-i)];
+                    for (int k = 0; k <= n; k++)
+                      sum -= Conj(coefs(k,i+1)) * coefs(k,j+1);
+                    for (int l = 0; l < i; l++)
+                      sum -= Conj(rmat(l,i)) * rmat(l,j);
+                    if (i < j)
+                      rmat(i,j) = sum / rmat(i,i);
+                    else
+                      {
+                        double diag = std::real(sum);
+                        double vnorm = std::real(ip[first + j*sb - j*(j-1)/2]);
+                        if (diag <= 1e-14 * vnorm)
+                          {
+                            rmat(j,j) = 0.0;
+                            nvec = j;
+                          }
+                        else
+                          rmat(j,j) = sqrt(diag);
+                      }
+                  }
+                for (int l = 0; l <= j; l++)
+                  coefs(n+1+l,j+1) = rmat(l,j);
+              }
+
+            for (int j = 0; j < nvec; j++)
+              {
+                q[n+1+j].AssignPointer (x.CreateVector());
+                q[n+1+j] = *v[j];
+                for (int k = 0; k <= n; k++)
+                  q[n+1+j] -= coefs(k,j+1) * *q[k];
+                for (int l = 0; l < j; l++)
+                  q[n+1+j] -= rmat(l,j) * *q[n+1+l];
+                q[n+1+j] *= 1.0 / rmat(j,j);
+              }
+
+            // Hessenberg columns, the last one closes an invariant subspace
+            int ncols = min2(nvec+1, sb);
+            int n0 = n;
+            for (int i = 1; i <= ncols; i++)
+              {
+                int col = n0+i-1;
+                for (int k = 0; k <= col+1; k++)
+                  h(k,col) = coefs(k,i);
+                for (int k = 0; k < col; k++)
+                  if (coefs(k,i-1) != 0.0)
+                    for (int l = 0; l <= k+1; l++)
+                      h(l,col) -= coefs(k,i-1) * h(l,k);
+                for (int l = 0; l <= col+1; l++)
+                  h(l,col) /= coefs(col,i-1);
+
+                // least squares by Givens rotations
+                for (int l = 0; l <= col+1; l++)
+                  hr(l,col) = h(l,col);
+                for (int l = 0; l < col; l++)
+                  {
+                    SCAL h1 = hr(l,col), h2 = hr(l+1,col);
+                    hr(l,col) = ci(l) * h1 + si(l) * h2;
+                    hr(l+1,col) = -Conj(si(l)) * h1 + ci(l) * h2;
+                  }
+                SCAL h1 = hr(col,col), h2 = hr(col+1,col);
+                double nrm = sqrt (sqr(Abs(h1)) + sqr(Abs(h2)));
+                if (Abs(h1) == 0)
+                  {
+                    ci(col) = 0;
+                    si(col) = 1.0;
+                    hr(col,col) = h2;
+                  }
+                else
+                  {
+                    SCAL phase = h1 / Abs(h1);
+                    ci(col) = Abs(h1) / nrm;
+                    si(col) = phase * Conj(h2) / nrm;
+                    hr(col,col) = phase * nrm;
+                  }
+                hr(col+1,col) = 0.0;
+                g(col+1) = -Conj(si(col)) * g(col);
+                g(col) = ci(col) * g(col);
+
+                n = col+1;
+                norm = Abs(g(col+1));
+                if (printrates) cout << IM(1) << n << " " << norm << endl;
+                if (norm <= err || coefs(col+1,i) == 0.0)
+                  {
+                    done = true;
+                    break;
+                  }
+              }
+            if (nvec < sb) done = true;
+          }
+
+        // x += Q y,  with  R y = g
+        Vector<SCAL> y(n);
+        for (int i = n-1; i >= 0; i--)
+          {
+            SCAL sum = g(i);
+            for (int j = i+1; j < n; j++)
+              sum -= hr(i,j) * y(j);
+            y(i) = sum / hr(i,i);
+          }
+        for (int i = 0; i < n; i++)
+          x += y(i) * *q[i];
+
+	const_cast<int&> (steps) = n;
+      }
+
+    catch (Exception & e)
+      {
+	e.Append ("in caught in SStepGMRESSolver::Mult\n");
+	throw;
+      }
+  }
+
+
+  // X^* Y for the inner product of IPTYPE, M(i,j) = (y_j, x_i)
+  template <class IPTYPE>
+  inline Matrix<typename SCAL_TRAIT<IPTYPE>::SCAL>
+  S_BlockInnerProduct (const MultiVector & x, const MultiVector & y)
+  {
+    if constexpr (is_same<IPTYPE,double>::value)
+      return x.InnerProductD (y);
+    else if constexpr (is_same<IPTYPE,Complex>::value)
+      return x.InnerProductC (y, false);
+    else
+      return Conj (x.InnerProductC (y, true));
+  }
+
+  // zz = C rr, or a copy without preconditioner
+  inline void S_BlockPrecond (const BaseMatrix * c, const MultiVector & rr, MultiVector & zz)
+  {
+    if (c)
+      {
+        Vector<double> ones(rr.Size());
+        ones = 1;
+        zz = 0.0;
+        c->MultAdd (ones, rr, zz);
+      }
+    else
+      zz = rr;
+  }
+
+
+  template <class IPTYPE>
+  void BlockCGSolver<IPTYPE> :: Solve (const MultiVector & f, MultiVector & x) const
+  {
+    static Timer timer ("block CG solver");
+    RegionTimer reg (timer);
+
+    try
+      {
+        // O'Leary: The block conjugate gradient algorithm and related methods.
+        //   alpha = (P^* A P)^{-1} (Z^* R),  X += P alpha,  R -= A P alpha,  Z = C R
+        //   beta = (Z^* R)_old^{-1} (Z^* R),  P = Z + P beta
+	if(sh)
+	  sh->SetThreadPercentage(0);
+
+        size_t k = f.Size();
+        auto r = f.RefVec()->CreateMultiVector(k);
+        auto z = x.RefVec()->CreateMultiVector(k);
+
+        *r = f;
+        if (initialize)
+          x = 0.0;
+        else
+          {
+            Vector<double> mones(k);
+            mones = -1;
+            a->MultAdd (mones, x, *r);
+          }
+        S_BlockPrecond (c.get(), *r, *z);
+
+        Vector<double> err(k);
+        Matrix<SCAL> rho0 = S_BlockInnerProduct<IPTYPE> (*z, *r);
+        for (size_t i = 0; i < k; i++)
+          err(i) = stop_absolute ? prec * prec : prec * prec * Abs (rho0(i,i));
+
+        Array<int> active(k);
+        for (size_t i = 0; i < k; i++)
+          active[i] = i;
+
+	int it = 0;
+        while (active.Size() && it < maxsteps && !(sh && sh->ShouldTerminate()))
+          {
+            // (re)start with the right-hand sides not converged yet
+            size_t na = active.Size();
+            auto xa = x.SubSet (active);
+            auto ra = r->SubSet (active);
+            auto za = z->SubSet (active);
+            auto p = x.RefVec()->CreateMultiVector(na);
+            auto pn = x.RefVec()->CreateMultiVector(na);
+            auto q = f.RefVec()->CreateMultiVector(na);
+            Vector<double> ones(na);
+            ones = 1;
+
+            Matrix<SCAL> rho = S_BlockInnerProduct<IPTYPE> (*za, *ra);
+            Matrix<SCAL> rhonew(na), g(na), alpha(na), beta(na);
+            *p = *za;
+
+            while (true)
+              {
+                *q = 0.0;
+                a->MultAdd (ones, *p, *q);
+                g = S_BlockInnerProduct<IPTYPE> (*p, *q);
+                CalcInverse (g);
+                alpha = g * rho;
+                xa->Add (*p, alpha);
+                alpha *= -1;
+                ra->Add (*q, alpha);
+
+                S_BlockPrecond (c.get(), *ra, *za);
+                rhonew = S_BlockInnerProduct<IPTYPE> (*za, *ra);
+                it++;
+
+                double maxres = 0;
+                Array<int> remaining;
+                for (size_t i = 0; i < na; i++)
+                  {
+                    maxres = max2 (maxres, Abs (rhonew(i,i)));
+                    if (Abs (rhonew(i,i)) > err(active[i]))
+                      remaining.Append (active[i]);
+                  }
+                if (printrates) cout << IM(1) << it << " " << sqrt (maxres) << endl;
+                if (sh)
+                  sh->SetThreadPercentage(100.*double(it)/double(maxsteps));
+
+                if (remaining.Size() < na || it >= maxsteps || (sh && sh->ShouldTerminate()))
+                  {
+                    active = std::move(remaining);
+                    break;
+                  }
+
+                CalcInverse (rho);
+                beta = rho * rhonew;
+                *pn = *za;
+                pn->Add (*p, beta);
+                swap (p, pn);
+                rho = rhonew;
+              }
+          }
+
+	const_cast<int&> (steps) = it;
+      }
+
+    catch (Exception & e)
+      {
+	e.Append ("in caught in BlockCGSolver::Solve\n");
+	throw;
+      }
+  }
+
+  template <class IPTYPE>
+  void BlockCGSolver<IPTYPE> :: Mult (const BaseVector & f, BaseVector & u) const
+  {
+    auto fm = f.CreateMultiVector(1);
+    auto um = u.CreateMultiVector(1);
+    *(*fm)[0] = f;
+    *(*um)[0] = u;
+    Solve (*fm, *um);
+    u = *(*um)[0];
+  }
+
+  template <class IPTYPE>
+  void BlockCGSolver<IPTYPE> :: MultAdd (FlatVector<double> alpha, const MultiVector & x, MultiVector & y) const
+  {
+    auto sol = y.RefVec()->CreateMultiVector(x.Size());
+    *sol = 0.0;
+    Solve (x, *sol);
+    for (size_t i = 0; i < alpha.Size(); i++)
+      *y[i] += alpha(i) * *(*sol)[i];
+  }
+
+
+
+  template <class IPTYPE>
+  void BlockGMRESSolver<IPTYPE> :: Solve (const MultiVector & f, MultiVector & x) const
+  {
+    static Timer timer ("block GMRES solver");
+    RegionTimer reg (timer);
+
+    try
+      {
+        // minimizes |C (F - A X)| over the block Krylov space:
+        //   C R_0 = V_0 S,   C A V_j = sum_{i <= j+1} V_i H_ij,
+        // the block Hessenberg matrix is reduced to triangular form by Givens rotations
+        typedef typename conditional<is_same<SCAL,double>::value, double, ComplexConjugate>::type HIP;
+        
+	if(sh)
+	  sh->SetThreadPercentage(0);
+
+        size_t k = f.Size();
+        Vector<double> ones(k);
+        ones = 1;
+
+        auto tmp = f.RefVec()->CreateMultiVector(k);
+        *tmp = f;
+        if (initialize)
+          x = 0.0;
+        else
+          {
+            Vector<double> mones(k);
+            mones = -1;
+            a->MultAdd (mones, x, *tmp);
+          }
+
+        // orthonormalizes the vectors of w, a vector with a remainder below
+        // 1e-12 of its original norm is linearly dependent and dropped (deflation):
+        //   w_j = sum_l w_kept[l] R(l,j)
+        auto orthogonalize = [] (MultiVector & w, FlatVector<double> norm0, Array<int> & kept)
+          {
+            size_t m = w.Size();
+            Matrix<SCAL> r(m, m);
+            r = SCAL(0.0);
+            kept.SetSize0();
+            for (size_t j = 0; j < m; j++)
+              {
+                for (int pass = 0; pass < 2; pass++)
+                  for (size_t l = 0; l < kept.Size(); l++)
+                    {
+                      SCAL ip = S_InnerProduct<HIP> (*w[j], *w[kept[l]]);
+                      r(l,j) += ip;
+                      w[j]->Add (-ip, *w[kept[l]]);
+                    }
+                double norm = w[j]->L2Norm();
+                if (norm == 0 || norm <= 1e-12 * norm0(j)) continue;
+                r(kept.Size(), j) = norm;
+                *w[j] *= 1.0 / norm;
+                kept.Append (j);
+              }
+            return Matrix<SCAL> (r.Rows(0, kept.Size()));
+          };
+        auto norms = [] (MultiVector & w)
+          {
+            Vector<double> nrm(w.Size());
+            for (size_t j = 0; j < w.Size(); j++)
+              nrm(j) = w[j]->L2Norm();
+            return nrm;
+          };
+
+        // Krylov blocks V_j, block j has the rows (and columns) first[j] <= i < first[j+1].
+        // Blocks shrink if the Krylov space loses rank, zero or linearly
+        // dependent right hand sides start with a smaller block.
+        Array<unique_ptr<MultiVector>> v;
+        Array<size_t> first;
+        Array<int> kept;
+        auto w0 = x.RefVec()->CreateMultiVector(k);
+        S_BlockPrecond (c.get(), *tmp, *w0);
+        Matrix<SCAL> s0 = orthogonalize (*w0, norms(*w0), kept);
+        v.Append (w0->SubSet (kept));
+        first.Append (0);
+        first.Append (kept.Size());
+
+        Vector<double> err(k);
+        for (size_t i = 0; i < k; i++)
+          err(i) = stop_absolute ? prec : prec * L2Norm (s0.Col(i));
+
+        Matrix<SCAL> g((maxsteps+1)*k, k);
+        g = SCAL(0.0);
+        g.Rows(0, kept.Size()) = s0;
+
+        Array<Matrix<SCAL>> hcols;
+        Array<size_t> rotrow;
+        Array<SCAL> rotc, rots;
+
+        auto rotate = [] (SliceMatrix<SCAL> m, size_t row, SCAL c, SCAL s)
+          {
+            for (size_t col = 0; col < m.Width(); col++)
+              {
+                SCAL h1 = m(row-1,col), h2 = m(row,col);
+                m(row-1,col) = c*h1 + s*h2;
+                m(row,col) = -Conj(s)*h1 + c*h2;
+              }
+          };
+        
+        int n = 0;
+        while (kept.Size() && n < maxsteps && !(sh && sh->ShouldTerminate()))
+          {
+            size_t kn = v[n]->Size();
+            auto av = f.RefVec()->CreateMultiVector(kn);
+            *av = 0.0;
+            a->MultAdd (ones.Range(0, kn), *v[n], *av);
+            auto w = x.RefVec()->CreateMultiVector(kn);
+            S_BlockPrecond (c.get(), *av, *w);
+            Vector<double> wnorm = norms(*w);
+
+            size_t rows = first[n+1];
+            Matrix<SCAL> hj(rows+kn, kn);
+            hj = SCAL(0.0);
+            for (int i = 0; i <= n; i++)
+              {
+                Matrix<SCAL> hij = S_BlockInnerProduct<HIP> (*v[i], *w);
+                hj.Rows(first[i], first[i+1]) = hij;
+                hij *= -1;
+                w->Add (*v[i], hij);
+              }
+            Matrix<SCAL> rn = orthogonalize (*w, wnorm, kept);
+            size_t kn1 = kept.Size();
+            hj.Rows(rows, rows+kn1) = rn;
+            if (kn1)
+              v.Append (w->SubSet (kept));
+            first.Append (rows+kn1);
+
+            for (size_t i = 0; i < rotrow.Size(); i++)
+              rotate (hj, rotrow[i], rotc[i], rots[i]);
+
+            // eliminate below the diagonal, column by column from the bottom
+            for (size_t col = 0; col < kn; col++)
+              for (size_t row = rows+min(col+1, kn1)-1; row > first[n]+col; row--)
+                {
+                  SCAL h1 = hj(row-1,col), h2 = hj(row,col);
+                  double a1 = Abs(h1), a2 = Abs(h2);
+                  SCAL cs = 1, sn = 0;
+                  if (a1 == 0)
+                    { cs = 0; sn = 1; }
+                  else if (a2 != 0)
+                    {
+                      double nrm = sqrt (a1*a1+a2*a2);
+                      cs = a1 / nrm;
+                      sn = (h1/a1) * Conj(h2) / nrm;
+                    }
+                  rotate (hj, row, cs, sn);
+                  rotate (g, row, cs, sn);
+                  rotrow.Append (row);
+                  rotc.Append (cs);
+                  rots.Append (sn);
+                }
+            hcols.Append (std::move(hj));
+            n++;
+
+            // residuals of the least squares problems,
+            // they vanish if the Krylov space became invariant
+            bool conv = true;
+            double maxres = 0;
+            for (size_t i = 0; i < k; i++)
+              {
+                double res = L2Norm (g.Rows(rows, rows+kn1).Col(i));
+                maxres = max2 (maxres, res);
+                if (res > err(i)) conv = false;
+              }
+            if (printrates) cout << IM(1) << n << " " << maxres << endl;
+            if (sh)
+              sh->SetThreadPercentage(100.*double(n)/double(maxsteps));
+            if (conv) break;
+          }
+
+        // back substitution with the triangular factor
+        size_t nc = first[n];
+        Array<int> blocknr(nc);
+        for (int j = 0; j < n; j++)
+          for (size_t i = first[j]; i < first[j+1]; i++)
+            blocknr[i] = j;
+        auto h = [&] (size_t i, size_t l) { return hcols[blocknr[l]](i, l-first[blocknr[l]]); };
+
+        Matrix<SCAL> y = g.Rows(0, nc);
+        for (int i = int(nc)-1; i >= 0; i--)
+          for (size_t col = 0; col < k; col++)
+            {
+              SCAL sum = y(i,col);
+              for (size_t l = i+1; l < nc; l++)
+                sum -= h(i,l) * y(l,col);
+              y(i,col) = sum / h(i,i);
+            }
+        for (int j = 0; j < n; j++)
+          {
+            Matrix<SCAL> yj = y.Rows(first[j], first[j+1]);
+            x.Add (*v[j], yj);
+          }
+
+	const_cast<int&> (steps) = n;
+      }
+
+    catch (Exception & e)
+      {
+	e.Append ("in caught in BlockGMRESSolver::Solve\n");
+	throw;
+      }
+  }
+
+  template <class IPTYPE>
+  void BlockGMRESSolver<IPTYPE> :: Mult (const BaseVector & f, BaseVector & u) const
+  {
+    auto fm = f.CreateMultiVector(1);
+    auto um = u.CreateMultiVector(1);
+    *(*fm)[0] = f;
+    *(*um)[0] = u;
+    Solve (*fm, *um);
+    u = *(*um)[0];
+  }
+
+  template <class IPTYPE>
+  void BlockGMRESSolver<IPTYPE> :: MultAdd (FlatVector<double> alpha, const MultiVector & x, MultiVector & y) const
+  {
+    auto sol = y.RefVec()->CreateMultiVector(x.Size());
+    *sol = 0.0;
+    Solve (x, *sol);
+    for (size_t i = 0; i < alpha.Size(); i++)
+      *y[i] += alpha(i) * *(*sol)[i];
+  }
+
+
   template <class IPTYPE>
   void CGSolver<IPTYPE> :: MultiMultSeed (const BaseVector & f, BaseVector & u, const int dim) const
   {
@@ -1319,6 +2206,20 @@ void QMRSolver<SCAL> :: Mult (const BaseVector & b, BaseVector & x) const
   template class CGSolver<Complex>;
   template class CGSolver<ComplexConjugate>;
   template class CGSolver<ComplexConjugate2>;
+  template class PipelinedCGSolver<double>;
+  template class PipelinedCGSolver<Complex>;
+  template class PipelinedCGSolver<ComplexConjugate>;
+  template class PipelinedCGSolver<ComplexConjugate2>;
+  template class SStepCGSolver<double>;
+  template class SStepCGSolver<Complex>;
+  template class SStepCGSolver<ComplexConjugate>;
+  template class SStepGMRESSolver<double>;
+  template class SStepGMRESSolver<Complex>;
+  template class BlockCGSolver<double>;
+  template class BlockCGSolver<Complex>;
+  template class BlockCGSolver<ComplexConjugate>;
+  template class BlockGMRESSolver<double>;
+  template class BlockGMRESSolver<Complex>;
   template class BiCGStabSolver<double>;
   template class BiCGStabSolver<Complex>;
   template class BiCGStabSolver<ComplexConjugate>;
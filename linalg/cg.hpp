@@ -128,6 +128,155 @@ namespace ngla
   };
 
 
+  /**
+     Pipelined conjugate gradient solver (Ghysels, Vanroose).
+     Both inner products of an iteration are reduced together,
+     the reduction overlaps with the preconditioner and the matrix-vector product.
+     Needs 4 more vectors than CG.
+  */
+  template <class IPTYPE>
+  class NGS_DLL_HEADER PipelinedCGSolver : public KrylovSpaceSolver
+  {
+  public:
+    typedef typename SCAL_TRAIT<IPTYPE>::SCAL SCAL;
+    ///
+    PipelinedCGSolver ()
+      : KrylovSpaceSolver () { ; }
+    ///
+    PipelinedCGSolver (shared_ptr<BaseMatrix> aa)
+      : KrylovSpaceSolver (aa) { ; }
+    ///
+    PipelinedCGSolver (shared_ptr<BaseMatrix> aa, shared_ptr<BaseMatrix> ac)
+      : KrylovSpaceSolver (aa, ac) { ; }
+
+    ///
+    virtual void Mult (const BaseVector & v, BaseVector & prod) const;
+  };
+
+
+  /**
+     s-step conjugate gradient solver.
+     Builds s preconditioned Krylov vectors at once and A-orthogonalizes
+     the block against the previous one. All inner products of the s steps
+     are combined into one global reduction.
+     Monomial basis, small s (up to 5) recommended.
+  */
+  template <class IPTYPE>
+  class NGS_DLL_HEADER SStepCGSolver : public KrylovSpaceSolver
+  {
+    int s = 4;
+  public:
+    typedef typename SCAL_TRAIT<IPTYPE>::SCAL SCAL;
+    ///
+    SStepCGSolver ()
+      : KrylovSpaceSolver () { ; }
+    ///
+    SStepCGSolver (shared_ptr<BaseMatrix> aa)
+      : KrylovSpaceSolver (aa) { ; }
+    ///
+    SStepCGSolver (shared_ptr<BaseMatrix> aa, shared_ptr<BaseMatrix> ac)
+      : KrylovSpaceSolver (aa, ac) { ; }
+
+    ///
+    void SetS (int as) { s = max2(as, 1); }
+    int GetS () const { return s; }
+    ///
+    virtual void Mult (const BaseVector & v, BaseVector & prod) const;
+  };
+
+
+  /**
+     s-step (communication avoiding) GMRES solver.
+     Blocks of s monomial Krylov vectors are orthonormalized by
+     block Gram-Schmidt and Cholesky-QR with one global reduction,
+     the Hessenberg matrix is recovered from the basis coefficients.
+  */
+  template <class IPTYPE>
+  class NGS_DLL_HEADER SStepGMRESSolver : public KrylovSpaceSolver
+  {
+    int s = 4;
+  public:
+    typedef typename SCAL_TRAIT<IPTYPE>::SCAL SCAL;
+    ///
+    SStepGMRESSolver ()
+      : KrylovSpaceSolver () { ; }
+    ///
+    SStepGMRESSolver (shared_ptr<BaseMatrix> aa)
+      : KrylovSpaceSolver (aa) { ; }
+    ///
+    SStepGMRESSolver (shared_ptr<BaseMatrix> aa, shared_ptr<BaseMatrix> ac)
+      : KrylovSpaceSolver (aa, ac) { ; }
+
+    ///
+    void SetS (int as) { s = max2(as, 1); }
+    int GetS () const { return s; }
+    ///
+    virtual void Mult (const BaseVector & v, BaseVector & prod) const;
+  };
+
+
+  /**
+     Block conjugate gradient solver (O'Leary) for several right-hand sides
+     with the same matrix. Matrix and preconditioner are applied to the
+     whole MultiVector, the search spaces are coupled by small dense systems.
+     Converged right-hand sides are removed, the iteration is restarted 
+     with the remaining ones.
+  */
+  template <class IPTYPE>
+  class NGS_DLL_HEADER BlockCGSolver : public KrylovSpaceSolver
+  {
+  public:
+    typedef typename SCAL_TRAIT<IPTYPE>::SCAL SCAL;
+    ///
+    BlockCGSolver ()
+      : KrylovSpaceSolver () { ; }
+    ///
+    BlockCGSolver (shared_ptr<BaseMatrix> aa)
+      : KrylovSpaceSolver (aa) { ; }
+    ///
+    BlockCGSolver (shared_ptr<BaseMatrix> aa, shared_ptr<BaseMatrix> ac)
+      : KrylovSpaceSolver (aa, ac) { ; }
+
+    using BaseMatrix::MultAdd;
+    /// solves for all right-hand sides at once
+    void Solve (const MultiVector & f, MultiVector & u) const;
+    ///
+    virtual void Mult (const BaseVector & v, BaseVector & prod) const override;
+    ///
+    virtual void MultAdd (FlatVector<double> alpha, const MultiVector & x, MultiVector & y) const override;
+  };
+
+
+  /**
+     Block GMRES solver for several right-hand sides with the same matrix.
+     Block Arnoldi with Gram-Schmidt, the block Hessenberg matrix is 
+     reduced by Givens rotations. Left preconditioning, no restart.
+  */
+  template <class IPTYPE>
+  class NGS_DLL_HEADER BlockGMRESSolver : public KrylovSpaceSolver
+  {
+  public:
+    typedef typename SCAL_TRAIT<IPTYPE>::SCAL SCAL;
+    ///
+    BlockGMRESSolver ()
+      : KrylovSpaceSolver () { ; }
+    ///
+    BlockGMRESSolver (shared_ptr<BaseMatrix> aa)
+      : KrylovSpaceSolver (aa) { ; }
+    ///
+    BlockGMRESSolver (shared_ptr<BaseMatrix> aa, shared_ptr<BaseMatrix> ac)
+      : KrylovSpaceSolver (aa, ac) { ; }
+
+    using BaseMatrix::MultAdd;
+    /// solves for all right-hand sides at once
+    void Solve (const MultiVector & f, MultiVector & u) const;
+    ///
+    virtual void Mult (const BaseVector & v, BaseVector & prod) const override;
+    ///
+    virtual void MultAdd (FlatVector<double> alpha, const MultiVector & x, MultiVector & y) const override;
+  };
+
+
   /// The BiCGStab solver
   template <class IPTYPE>
   class NGS_DLL_HEADER BiCGStabSolver : public KrylovSpaceSolver
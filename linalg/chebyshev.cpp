@@ -78,4 +78,97 @@ namespace ngla
 	  }
       }
   }
+
+
+
+  double EstimateLamMax (const BaseMatrix & a, const BaseMatrix & c, int steps)
+  {
+    static Timer t("EstimateLamMax");
+    RegionTimer reg(t);
+
+    auto r = a.CreateColVector();
+    auto z = a.CreateColVector();
+    auto p = a.CreateColVector();
+    auto w = a.CreateColVector();
+
+    r.SetRandom();
+    r.SetParallelStatus (DISTRIBUTED);
+    z = c * r;
+    p = z;
+    double rz = InnerProduct (r, z);
+
+    Array<double> alpha, beta;
+    for (int j = 0; j < steps && rz > 0; j++)
+      {
+        w = a * p;
+        double pw = InnerProduct (p, w);
+        if (pw <= 0) break;
+        alpha.Append (rz / pw);
+        r -= alpha.Last() * w;
+        z = c * r;
+        double rznew = InnerProduct (r, z);
+        beta.Append (rznew / rz);
+        p *= beta.Last();
+        p += z;
+        rz = rznew;
+      }
+
+    // Lanczos matrix from cg coefficients
+    size_t m = alpha.Size();
+    if (m == 0) return 1;
+    Matrix<> tri(m, m), evecs(m, m);
+    Vector<> lami(m);
+    tri = 0.0;
+    for (size_t j = 0; j < m; j++)
+      {
+        tri(j,j) = 1/alpha[j];
+        if (j > 0) tri(j,j) += beta[j-1]/alpha[j-1];
+        if (j+1 < m) tri(j,j+1) = tri(j+1,j) = sqrt(beta[j])/alpha[j];
+      }
+    CalcEigenSystem (tri, lami, evecs);
+    double lmax = lami(0);
+    for (size_t j = 1; j < m; j++)
+      lmax = max (lmax, lami(j));
+    return lmax;
+  }
+
+
+  ChebyshevSmoothing :: ChebyshevSmoothing (shared_ptr<BaseMatrix> aa, shared_ptr<BaseMatrix> ac,
+                                            double ratio, int lanczossteps)
+    : a(aa), c(ac)
+  {
+    // Lanczos approaches lmax from below
+    lmax = 1.1 * EstimateLamMax (*a, *c, lanczossteps);
+    lmin = ratio * lmax;
+  }
+
+  void ChebyshevSmoothing :: Smooth (BaseVector & u, const BaseVector & f, int degree) const
+  {
+    static Timer t("ChebyshevSmoothing");
+    RegionTimer reg(t);
+
+    double theta = 0.5 * (lmax+lmin);
+    double delta = 0.5 * (lmax-lmin);
+    double sigma = theta / delta;
+    double rho = 1 / sigma;
+
+    auto r = f.CreateVector();
+    auto d = f.CreateVector();
+    auto w = f.CreateVector();
+
+    r = f - (*a) * u;
+    w = (*c) * r;
+    d = (1/theta) * w;
+    for (int k = 1; k <= degree; k++)
+      {
+        u += d;
+        if (k == degree) break;
+        a->MultAdd (-1, d, r);
+        w = (*c) * r;
+        double rhonew = 1 / (2*sigma - rho);
+        d *= rhonew * rho;
+        d += (2*rhonew/delta) * w;
+        rho = rhonew;
+      }
+  }
 }
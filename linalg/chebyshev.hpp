@@ -36,6 +36,34 @@ namespace ngla
     AutoVector CreateColVector () const override { return a->CreateRowVector(); }
   };
 
+
+  /**
+     Estimates the largest eigenvalue of c*a by steps iterations
+     of preconditioned Lanczos (coefficients taken from pcg).
+     a and c must be symmetric positive (semi-)definite.
+  */
+  NGS_DLL_HEADER double EstimateLamMax (const BaseMatrix & a, const BaseMatrix & c, int steps = 10);
+  
+
+  /**
+     Chebyshev polynomial smoothing for c*a.
+     Damps the eigenvalues in [ratio*lmax, lmax]. Needs only
+     matrix-vector products, so no coloring is needed.
+     lmax is estimated by Lanczos at construction.
+  */
+  class NGS_DLL_HEADER ChebyshevSmoothing
+  {
+    shared_ptr<BaseMatrix> a, c;
+    double lmin, lmax;
+  public:
+    ChebyshevSmoothing (shared_ptr<BaseMatrix> aa, shared_ptr<BaseMatrix> ac,
+                        double ratio = 0.3, int lanczossteps = 10);
+    ///
+    double GetLamMax () const { return lmax; }
+    /// polynomial of given degree, needs degree matrix-vector products
+    void Smooth (BaseVector & u, const BaseVector & f, int degree) const;
+  };
+
 }
 
 #endif
@@ -294,6 +294,93 @@ namespace ngla
 
 
 
+
+  JacobiPrecondFloat ::
+  JacobiPrecondFloat (const SparseMatrixFloat & amat, 
+                      shared_ptr<BitArray> ainner, bool use_par)
+    : mat(amat), inner(ainner)
+  { 
+    static Timer t("JacobiprecondFloat::ctor"); RegionTimer r(t);
+    SetParallelDofs (mat.GetParallelDofs());
+
+    height = mat.Height();
+
+    // reduce and invert in double, store in float
+    Array<double> diag(height);
+    ParallelFor (height, [&](size_t i)
+		 {
+		   if (!inner || inner->Test(i))
+		     diag[i] = mat(i,i);
+                   else
+                     diag[i] = 0.0;
+		 });
+    
+    if (paralleldofs!=nullptr && use_par)
+      AllReduceDofData (diag, MPI_SUM, paralleldofs);  
+
+    invdiag.SetSize (height);
+    ParallelFor (height, [&](size_t i)
+		 {
+		   if ((!inner || inner->Test(i)) && diag[i] != 0.0)
+		     invdiag[i] = 1.0 / diag[i];
+                   else
+                     invdiag[i] = 0.0f;
+		 });
+  }
+
+  void JacobiPrecondFloat ::
+  MultAdd (double s, const BaseVector & x, BaseVector & y) const 
+  {
+    static Timer t("JacobiPrecondFloat::MultAdd");
+    RegionTimer reg(t);
+
+    x.Cumulate();
+    y.Cumulate();
+
+    FlatVector<double> fx = x.FVDouble();
+    FlatVector<double> fy = y.FVDouble();
+
+    // invdiag is 0 for non-inner dofs
+    ParallelForRange (height,
+                      [fx, fy, s, this] (IntRange r)
+                      {
+                        for (auto i : r)
+                          fy(i) += s * (double(this->invdiag[i]) * fx(i));
+                      });
+  }
+
+  void JacobiPrecondFloat ::
+  GSSmooth (BaseVector & x, const BaseVector & b) const 
+  {
+    static Timer timer("JacobiPrecondFloat::GSSmooth");
+    RegionTimer reg (timer);
+    timer.AddFlops (mat.NZE());
+
+    FlatVector<double> fx = x.FVDouble();
+    FlatVector<double> fb = b.FVDouble();
+
+    for (int i = 0; i < height; i++)
+      if (!this->inner || this->inner->Test(i))
+        fx(i) += double(invdiag[i]) * (fb(i) - mat.RowTimesVector (i, fx));
+  }
+
+  void JacobiPrecondFloat ::
+  GSSmoothBack (BaseVector & x, const BaseVector & b) const 
+  {
+    static Timer timer("JacobiPrecondFloat::GSSmoothBack");
+    RegionTimer reg (timer);
+    timer.AddFlops (mat.NZE());
+
+    FlatVector<double> fx = x.FVDouble();
+    FlatVector<double> fb = b.FVDouble();
+
+    for (int i = height-1; i >= 0; i--)
+      if (!this->inner || this->inner->Test(i))
+        fx(i) += double(invdiag[i]) * (fb(i) - mat.RowTimesVector (i, fx));
+  }
+
+
+
   template class JacobiPrecond<double>;
   template class JacobiPrecond<Complex>;
   template class JacobiPrecond<double, Complex, Complex>;
@@ -112,6 +112,49 @@ namespace ngla
 				    int forward = 1) const;
   };
 
+
+
+  /// A Jacobi preconditioner with inverse diagonal stored in single precision
+  class NGS_DLL_HEADER JacobiPrecondFloat : virtual public BaseJacobiPrecond,
+                                            virtual public S_BaseMatrix<double>
+  {
+  protected:
+    const SparseMatrixFloat & mat;
+    ///
+    shared_ptr<BitArray> inner;
+    ///
+    int height;
+    ///
+    Array<float> invdiag;
+  public:
+    ///
+    JacobiPrecondFloat (const SparseMatrixFloat & amat, 
+                        shared_ptr<BitArray> ainner = nullptr, bool use_par = true);
+
+    int VHeight() const override { return height; }
+    int VWidth() const override { return height; }
+  
+    ///
+    void MultAdd (double s, const BaseVector & x, BaseVector & y) const override;
+
+    void MultTransAdd (double s, const BaseVector & x, BaseVector & y) const override
+    { MultAdd (s, x, y); }
+    ///
+    AutoVector CreateRowVector() const override { return mat.CreateColVector(); }
+    AutoVector CreateColVector() const override { return mat.CreateRowVector(); }
+    ///
+    void GSSmooth (BaseVector & x, const BaseVector & b) const override;
+
+    /// computes partial residual y
+    void GSSmooth (BaseVector & x, const BaseVector & b, BaseVector & y) const override
+    {
+      GSSmooth (x, b);
+    }
+
+    ///
+    void GSSmoothBack (BaseVector & x, const BaseVector & b) const override;
+  };
+
 }
 
 
@@ -47,6 +47,7 @@ namespace ngla
 #include "chebyshev.hpp"
 #include "eigen.hpp"
 #include "arnoldi.hpp"
+#include "lobpcg.hpp"
 
 #include "cuda_linalg.hpp"
 #endif
@@ -0,0 +1,256 @@
+/**************************************************************************/
+/* File:   lobpcg.cpp                                                     */
+/**************************************************************************/
+
+/* 
+
+LOBPCG Eigenvalue Solver (A. Knyazev)
+  
+*/ 
+
+#include <la.hpp>
+
+namespace ngla
+{
+
+  Vector<double> LOBPCG :: Calc (MultiVector & evecs, bool initialize) const
+  {
+#ifndef LAPACK
+    throw Exception ("LOBPCG needs LAPACK");
+#else
+    static Timer t("LOBPCG");
+    static Timer tmat("LOBPCG - apply matrices");
+    static Timer trr("LOBPCG - Rayleigh-Ritz");
+    static Timer tup("LOBPCG - update");
+    RegionTimer reg(t);
+    
+    size_t k = evecs.Size();
+    auto refvec = evecs.RefVec();
+    if (refvec->IsComplex())
+      throw Exception ("LOBPCG: complex vectors not supported");
+
+    Vector<double> ones(k);
+    ones = 1.0;
+    
+    // y = mat * x, identity if mat is not set
+    auto apply = [&] (shared_ptr<BaseMatrix> mat, const MultiVector & x, MultiVector & y)
+      {
+        RegionTimer reg(tmat);
+        if (mat)
+          {
+            y = 0.0;
+            mat->MultAdd (ones.Range(0, x.Size()), x, y);
+          }
+        else
+          y = x;
+      };
+    
+    unique_ptr<Projector> proj;
+    if (freedofs)
+      proj = make_unique<Projector> (freedofs, true);
+    auto project = [&] (MultiVector & x)
+      {
+        if (proj)
+          for (size_t i = 0; i < x.Size(); i++)
+            proj->Project (*x[i]);
+      };
+
+    // eigenvectors, search directions and previous directions,
+    // together with their A- and B-images
+    unique_ptr<MultiVector> X[3], W[3], P[3], Xn[3], Pn[3];
+    for (int l = 0; l < 3; l++)
+      {
+        X[l] = refvec->CreateMultiVector(k);
+        W[l] = refvec->CreateMultiVector(k);
+        P[l] = refvec->CreateMultiVector(k);
+        Xn[l] = refvec->CreateMultiVector(k);
+        Pn[l] = refvec->CreateMultiVector(k);
+      }
+    auto R = refvec->CreateMultiVector(k);
+
+    if (initialize)
+      {
+        for (size_t i = 0; i < k; i++)
+          {
+            (*R)[i]->SetRandom();
+            (*R)[i]->SetParallelStatus (DISTRIBUTED);
+          }
+        project (*R);
+        apply (pre, *R, *X[0]);
+        project (*X[0]);
+      }
+    else
+      *X[0] = evecs;
+
+    apply (a, *X[0], *X[1]);
+    apply (b, *X[0], *X[2]);
+
+    Vector<double> lam(k);
+    
+    /*
+      Rayleigh-Ritz for the basis S[0] = [X, W, P] with images S[1] = A S[0] 
+      and S[2] = B S[0]. Jacobi scaling of the Gram matrices keeps LAPACK 
+      away from trouble as long as possible.
+      coefs(:,j) are the coefficients of the j-th Ritz vector.
+    */
+    auto rayleigh_ritz = [&] (FlatArray<Array<MultiVector*>> S, Matrix<> & coefs) -> int
+      {
+        RegionTimer reg(trr);
+        Array<size_t> first(S[0].Size()+1);
+        first[0] = 0;
+        for (size_t i = 0; i < S[0].Size(); i++)
+          first[i+1] = first[i] + S[0][i]->Size();
+        size_t n = first.Last();
+        
+        Matrix<> ga(n,n), gb(n,n);
+        for (size_t i = 0; i < S[0].Size(); i++)
+          for (size_t j = i; j < S[0].Size(); j++)
+            {
+              IntRange ri(first[i], first[i+1]), rj(first[j], first[j+1]);
+              ga.Rows(ri).Cols(rj) = S[0][i]->InnerProductD (*S[1][j]);
+              gb.Rows(ri).Cols(rj) = S[0][i]->InnerProductD (*S[2][j]);
+              if (i != j)
+                {
+                  ga.Rows(rj).Cols(ri) = Trans (ga.Rows(ri).Cols(rj));
+                  gb.Rows(rj).Cols(ri) = Trans (gb.Rows(ri).Cols(rj));
+                }
+            }
+
+        Vector<> d(n);
+        for (size_t i = 0; i < n; i++)
+          d(i) = (gb(i,i) > 0) ? 1.0/sqrt(gb(i,i)) : 1.0;
+        for (size_t i = 0; i < n; i++)
+          for (size_t j = 0; j < i; j++)
+            {
+              ga(i,j) = ga(j,i) = 0.5 * (ga(i,j)+ga(j,i)) * d(i)*d(j);
+              gb(i,j) = gb(j,i) = 0.5 * (gb(i,j)+gb(j,i)) * d(i)*d(j);
+            }
+        for (size_t i = 0; i < n; i++)
+          {
+            ga(i,i) *= d(i)*d(i);
+            gb(i,i) *= d(i)*d(i);
+          }
+        
+        // eigenvectors are returned in the rows of ga, ascending eigenvalues
+        Vector<> hlam(n);
+        int info = LapackGHEPEPairs (n, ga.Data(), gb.Data(), hlam.Data());
+        if (info) return info;
+
+        coefs.SetSize (n, k);
+        for (size_t i = 0; i < n; i++)
+          for (size_t j = 0; j < k; j++)
+            coefs(i,j) = d(i) * ga(j,i);
+        lam = hlam.Range(0, k);
+        return 0;
+      };
+
+    Array<Array<MultiVector*>> S(3);
+    Matrix<> coefs;
+
+    // initial Rayleigh-Ritz makes X B-orthonormal
+    for (int l = 0; l < 3; l++)
+      S[l].Append (X[l].get());
+    if (rayleigh_ritz (S, coefs))
+      throw Exception ("LOBPCG: initial vectors are linearly dependent");
+    for (int l = 0; l < 3; l++)
+      {
+        *Xn[l] = 0.0;
+        Xn[l]->Add (*X[l], coefs);
+        swap (X[l], Xn[l]);
+      }
+
+    Array<int> active;
+    bool usep = false;
+    Vector<double> relres(k);
+    Matrix<> mlam(k,k);
+    
+    for (steps = 0; ; steps++)
+      {
+        // residuals R = AX - BX lam, all norms with one reduction
+        *R = *X[1];
+        mlam = 0.0;
+        for (size_t i = 0; i < k; i++)
+          mlam(i,i) = -lam(i);
+        R->Add (*X[2], mlam);
+        project (*R);
+        
+        FusedInnerProducts<double> ips;
+        for (size_t i = 0; i < k; i++)
+          {
+            ips.Add (*(*R)[i], *(*R)[i]);
+            ips.Add (*(*X[2])[i], *(*X[2])[i]);
+          }
+        ips.Start();
+        auto vals = ips.Wait();
+
+        // soft locking: only unconverged vectors get new directions
+        active.SetSize0();
+        for (size_t i = 0; i < k; i++)
+          {
+            relres(i) = sqrt(vals[2*i]) / (max(fabs(lam(i)), 1e-300) * sqrt(vals[2*i+1]));
+            if (relres(i) > prec)
+              active.Append (i);
+          }
+        
+        if (printrates)
+          cout << IM(1) << "LOBPCG it = " << steps << ", active = " << active.Size()
+               << ", lam = " << lam << ", err = " << relres << endl;
+        
+        if (active.Size() == 0 || steps >= maxsteps)
+          break;
+
+        unique_ptr<MultiVector> Wa[3], Pa[3];
+        for (int l = 0; l < 3; l++)
+          {
+            Wa[l] = W[l]->SubSet(active);
+            Pa[l] = P[l]->SubSet(active);
+          }
+        auto Ra = R->SubSet(active);
+        apply (pre, *Ra, *Wa[0]);
+        project (*Wa[0]);
+        apply (a, *Wa[0], *Wa[1]);
+        apply (b, *Wa[0], *Wa[2]);
+        
+        // restart without P if the basis got too ill-conditioned
+        int info = 1;
+        for (bool withp : { true, false })
+          {
+            if (withp && !usep) continue;
+            for (int l = 0; l < 3; l++)
+              {
+                S[l].SetSize0();
+                S[l].Append (X[l].get());
+                S[l].Append (Wa[l].get());
+                if (withp)
+                  S[l].Append (Pa[l].get());
+              }
+            info = rayleigh_ritz (S, coefs);
+            usep = withp;
+            if (!info) break;
+          }
+        if (info)
+          throw Exception ("LOBPCG: Rayleigh-Ritz failed, info = " + ToString(info));
+
+        // P = W Cw + P Cp,  X = X Cx + P
+        RegionTimer regup(tup);
+        size_t na = active.Size();
+        for (int l = 0; l < 3; l++)
+          {
+            *Pn[l] = 0.0;
+            Pn[l]->Add (*Wa[l], coefs.Rows(k, k+na));
+            if (usep)
+              Pn[l]->Add (*Pa[l], coefs.Rows(k+na, k+2*na));
+            *Xn[l] = *Pn[l];
+            Xn[l]->Add (*X[l], coefs.Rows(0, k));
+            swap (X[l], Xn[l]);
+            swap (P[l], Pn[l]);
+          }
+        usep = true;
+      }
+
+    evecs = *X[0];
+    return lam;
+#endif
+  }
+  
+}
@@ -0,0 +1,52 @@
+#ifndef FILE_LOBPCG
+#define FILE_LOBPCG
+
+
+/**************************************************************************/
+/* File:   lobpcg.hpp                                                     */
+/**************************************************************************/
+
+namespace ngla
+{
+  /**
+     LOBPCG Eigenvalue Solver.
+
+     Computes the smallest eigenvalues of the generalized evp
+     
+     A x = lam B x
+
+     A and B must be real symmetric, B positive definite.
+     pre should approximate the inverse of A. 
+     Converged eigenvectors are soft-locked: they stay in the
+     Rayleigh-Ritz basis, but their search directions are dropped.
+   */
+
+  class NGS_DLL_HEADER LOBPCG
+  {
+    shared_ptr<BaseMatrix> a;
+    shared_ptr<BaseMatrix> b;
+    shared_ptr<BaseMatrix> pre;
+    shared_ptr<BitArray> freedofs;
+    double prec = 1e-8;
+    int maxsteps = 200;
+    bool printrates = false;
+    mutable int steps = 0;
+
+  public:
+    LOBPCG (shared_ptr<BaseMatrix> aa, shared_ptr<BaseMatrix> ab,
+            shared_ptr<BaseMatrix> apre = nullptr, shared_ptr<BitArray> afreedofs = nullptr)
+      : a(aa), b(ab), pre(apre), freedofs(afreedofs)
+    { ; }
+
+    void SetPrecision (double aprec) { prec = aprec; }
+    void SetMaxSteps (int amaxsteps) { maxsteps = amaxsteps; }
+    void SetPrintRates (bool aprintrates = true) { printrates = aprintrates; }
+    int GetSteps () const { return steps; }
+
+    /// returns the eigenvalues in ascending order, evecs are B-orthonormal.
+    /// starts from random vectors if initialize is set, otherwise from evecs
+    Vector<double> Calc (MultiVector & evecs, bool initialize = true) const;
+  };
+}
+
+#endif
@@ -20,6 +20,24 @@ namespace ngla {
   //   Expand (cnt);
   // }
   
+  template <typename TSCAL>
+  static shared_ptr<BaseVector> BlockColumn (shared_ptr<BaseVector> block, size_t size, size_t i)
+  {
+    TSCAL * data = static_cast<TSCAL*> (block->Memory()) + i*size;
+    // the column view keeps the block alive
+    return shared_ptr<BaseVector> (new S_BaseVectorPtr<TSCAL> (size, 1, data),
+                                   [block] (BaseVector * vec) { delete vec; });
+  }
+  
+  MultiVector :: MultiVector (size_t size, size_t cnt, bool is_complex)
+  {
+    refvec = CreateBaseVector(size, is_complex, 1);
+    shared_ptr<BaseVector> block = CreateBaseVector(size*cnt, is_complex, 1);
+    for (size_t i = 0; i < cnt; i++)
+      vecs.Append (is_complex ? BlockColumn<Complex> (block, size, i)
+                   : BlockColumn<double> (block, size, i));
+  }
+  
   // template <class T>
   // void MultiVector :: operator= (T v)
   // {
@@ -407,6 +425,34 @@ namespace ngla {
 
 
 
+  void MultiVector :: CopyToInterleaved (SliceMatrix<double> mat) const
+  {
+    static Timer t("MultiVector::CopyToInterleaved");
+    RegionTimer reg(t);
+
+    ParallelForRange
+      (mat.Height(), [&] (IntRange r)
+       {
+         for (size_t j = 0; j < vecs.Size(); j++)
+           mat.Rows(r).Col(j) = vecs[j]->FVDouble().Range(r);
+       });
+  }
+
+  void MultiVector :: AddFromInterleaved (FlatVector<double> alpha, SliceMatrix<double> mat)
+  {
+    static Timer t("MultiVector::AddFromInterleaved");
+    RegionTimer reg(t);
+
+    ParallelForRange
+      (mat.Height(), [&] (IntRange r)
+       {
+         for (size_t j = 0; j < vecs.Size(); j++)
+           vecs[j]->FVDouble().Range(r) += alpha(j) * mat.Rows(r).Col(j);
+       });
+  }
+
+  
+
   Vector<> MultiVector ::
   InnerProductD (const BaseVector & y) const
   {
@@ -44,11 +44,8 @@ namespace ngla {
     {
       Extend (cnt);
     }
-    MultiVector (size_t size, size_t cnt, bool is_complex)
-    {
-      refvec = CreateBaseVector(size, is_complex, 1);
-      Extend (cnt);
-    }
+    /// the cnt vectors share one block of memory, as columns of a size x cnt matrix
+    MultiVector (size_t size, size_t cnt, bool is_complex);
     MultiVector (const MultiVector & v) = default;
     MultiVector (MultiVector && v) = default;
     
@@ -118,6 +115,11 @@ namespace ngla {
     virtual Vector<> InnerProductD (const BaseVector & v2) const;
     virtual Vector<Complex> InnerProductC (const BaseVector & v2, bool conjugate = false) const;
 
+    /// row-interleaved copy of real vectors, mat(i,j) = (*vecs[j])(i)
+    void CopyToInterleaved (SliceMatrix<double> mat) const;
+    /// vecs[j] += alpha(j) * mat.Col(j)
+    void AddFromInterleaved (FlatVector<double> alpha, SliceMatrix<double> mat);
+
 
 
     virtual void AssignTo (FlatVector<double> s, class MultiVector & v) const override;
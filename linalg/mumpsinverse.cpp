@@ -44,6 +44,7 @@ namespace ngla
     symmetric = asymmetric;
     inner = ainner;
     cluster = acluster;
+    matrix = const_cast<SparseMatrix<TM,TV_ROW,TV_COL>&>(a).template SharedFromThis<BaseSparseMatrix>();
 
     auto pds = a.GetParallelDofs();
     if ( (pds != nullptr) && // if we are on an "only-me comm", take it
@@ -79,169 +80,12 @@ namespace ngla
     iscomplex = mat_traits<TM>::IS_COMPLEX;
 
 
-    int * colstart = 0;
-    int * counter = 0;
-    int * col_indices = 0, * row_indices = 0;
-    TSCAL * matrix = 0;
-
     if (id == 0)
       {
 	height = a.Height() * entrysize;
-	
-	int * colstart = new int[height+1];
-	int * counter = new int[height];
-	
-	for ( int i = 0; i < height; i++ ) 
-	  counter[i] = 0;
-
-	for ( int i = 0; i < height; i++ ) 
-	  colstart[i+1] = 0;
-	
-	if ( symmetric )
-	  {
-	    cout << "copy matrix symmetric" << endl;
-	    
-	    col_indices = new int[a.NZE() * entrysize * entrysize ];
-	    row_indices = new int[a.NZE() * entrysize * entrysize ];
-	    matrix = new TSCAL[a.NZE() * entrysize * entrysize ];      
-	    
-	    int ii = 0;
-	    for (int i = 0; i < a.Height(); i++ )
-	      {
-		FlatArray<int> rowind = a.GetRowIndices(i);
-
-		for (int j = 0; j < rowind.Size(); j++ )
-		  {
-		    int col = rowind[j];
-		    
-		    if (  (!inner && !cluster) ||
-			  (inner && (inner->Test(i) && inner->Test(col) ) ) ||
-			  (!inner && cluster &&
-			   ((*cluster)[i] == (*cluster)[col] 
-			    && (*cluster)[i] ))  )
-		      {
-			TM entry = a(i,col);
-			for (int l = 0; l < entrysize; l++ )
-			  for (int k = 0; k < entrysize; k++)
-			    {
-			      int rowi = i*entrysize+l+1;
-			      int coli = col*entrysize+k+1;
-			      TSCAL val = Access(entry,l,k);
-
-			      if (rowi >= coli)
-				{
-				  col_indices[ii] = coli;
-				  row_indices[ii] = rowi;
-				  matrix[ii] = val;
-				  ii++;
-				}
-			    }
-		      }
-		    else if (i == col)
-		      {
-			// in the case of 'inner' or 'cluster': 1 on the diagonal for
-			// unused dofs.
-			for (int l=0; l<entrysize; l++ )
-			  {
-			    col_indices[ii] = col*entrysize+l+1;
-			    row_indices[ii] = col*entrysize+l+1;
-			    matrix[ii] = 1;
-			    ii++;
-			  }
-		      }
-		  }
-	      }
-	    nze = ii;
-	  }
-	else
-	  {
-	    cout << "copy matrix non-symmetric" << endl;
-	    // --- transform matrix to compressed column storage format ---
-
-	    // 1.) build array 'colstart':
-	    // (a) get nr. of entries for each col
-	    for (int i = 0; i < a.Height(); i++ )
-	      {
-		for (int j = 0; j < a.GetRowIndices(i).Size(); j++ )
-		  {
-		    int col = a.GetRowIndices(i)[j];
-                
-		    if (  (!inner && !cluster) ||
-			  (inner && (inner->Test(i) && inner->Test(col) ) ) ||
-			  (!inner && cluster && 
-			   ((*cluster)[i] == (*cluster)[col] 
-			    && (*cluster)[i] ))  )
-		      {
-			for (int k=0; k<entrysize; k++ )
-			  colstart[col*entrysize+k+1] += entrysize;
-		      }
-		    else if ( i == col )
-		      {
-			for (int k=0; k<entrysize; k++ )
-			  colstart[col*entrysize+k+1] ++;
-		      }
-		  }
-	      }
-
-	    // (b) accumulate
-	    colstart[0] = 0;
-	    for (int i = 1; i <= height; i++ ) colstart[i] += colstart[i-1];
-	    nze = colstart[height];
-
-
-	    // 2.) build whole matrix:
-	    col_indices = new int[a.NZE() * entrysize * entrysize ];
-	    row_indices = new int[a.NZE() * entrysize * entrysize ];
-	    matrix = new TSCAL[a.NZE() * entrysize * entrysize ];      
-
-	    for (int i = 0; i < a.Height(); i++ )
-	      {
-		for (int j = 0; j<a.GetRowIndices(i).Size(); j++ )
-		  {
-		    int col = a.GetRowIndices(i)[j];
-
-		    if (  (!inner && !cluster) ||
-			  (inner && (inner->Test(i) && inner->Test(col) ) ) ||
-			  (!inner && cluster &&
-			   ((*cluster)[i] == (*cluster)[col] 
-			    && (*cluster)[i] ))  )
-		      {
-			TM entry = a(i,col);
-			for (int k = 0; k < entrysize; k++)
-			  for (int l = 0; l < entrysize; l++ )
-			    {
-			      row_indices[ colstart[col*entrysize+k]+
-					   counter[col*entrysize+k] ] = i*entrysize+l + 1;
-			      col_indices[ colstart[col*entrysize+k]+
-					   counter[col*entrysize+k] ] = col*entrysize+k + 1;
-			      matrix[ colstart[col*entrysize+k]+
-				      counter[col*entrysize+k] ] = Access(entry,l,k);
-			      counter[col*entrysize+k]++;
-			    }
-		      }
-		    else if (i == col)
-		      {
-			// in the case of 'inner' or 'cluster': 1 on the diagonal for
-			// unused dofs.
-			for (int l=0; l<entrysize; l++ )
-			  {
-			    col_indices[ colstart[col*entrysize+l]+
-					 counter[col*entrysize+l] ] = col*entrysize+l + 1;
-			    row_indices[ colstart[col*entrysize+l]+
-					 counter[col*entrysize+l] ] = col*entrysize+l + 1;
-			    matrix[ colstart[col*entrysize+l]+
-				    counter[col*entrysize+l] ] = 1;
-			    counter[col*entrysize+l]++;
-			  }
-		      }
-		  }
-	      }
-	  }
+        GetMumpsMatrix (a);
       }
 
-
-
-
     for (int i = 0; i < 40; i++)
       mumps_id.icntl[i] = 0;
 
@@ -259,8 +103,8 @@ namespace ngla
     /* Define the problem on the host */
     mumps_id.n   = height; 
     mumps_id.nz  = nze;
-    mumps_id.irn = row_indices;
-    mumps_id.jcn = col_indices;
+    mumps_id.irn = row_indices.Data();
+    mumps_id.jcn = col_indices.Data();
 
     /*
       if (id == 0)
@@ -302,27 +146,13 @@ namespace ngla
 
 
 
-    mumps_id.a   = (typename mumps_trait<TSCAL>::MUMPS_TSCAL*)matrix; 
-
-    mumps_id.job = JOB_FACTOR;
-    
     if (id == 0)
       cout << "factor ... " << flush;
 
-    MPI_Barrier (comm);
-
     timer_factor.Start();
-    mumps_trait<TSCAL>::MumpsFunction (&mumps_id);
+    Factor();
     timer_factor.Stop();
 
-    if (mumps_id.infog[0] != 0)
-      {
-	cout << " factorization done" << endl;
-	cout << "error-code = " << mumps_id.infog[0] << endl;
-	cout << "info(1) = " << mumps_id.info[0] << endl;
-	cout << "info(2) = " << mumps_id.info[1] << endl;
-      }
-
 
     /*
       if ( error != 0 )
@@ -337,16 +167,176 @@ namespace ngla
     
     if (id == 0)
       cout << " done " << endl;
-    delete [] colstart;
-    delete [] counter;
-    // delete [] rhs;    
+  }
 
 
-    delete [] col_indices;
-    delete [] row_indices;
-    delete [] matrix;
+  /*
+    copy the matrix to coordinate format, 1-based.
+    The order of entries depends only on the graph, so values can 
+    be refilled in place for a numeric refactorization.
+  */
+  template <class TM, class TV_ROW, class TV_COL>
+  void MumpsInverse<TM,TV_ROW,TV_COL> :: 
+  GetMumpsMatrix (const SparseMatrix<TM,TV_ROW,TV_COL> & a)
+  {
+    auto used = [&] (int i, int col)
+      {
+        return (!inner && !cluster) ||
+          (inner && (inner->Test(i) && inner->Test(col) ) ) ||
+          (!inner && cluster &&
+           ((*cluster)[i] == (*cluster)[col] && (*cluster)[i] ));
+      };
+
+    row_indices.SetSize (a.NZE() * entrysize * entrysize);
+    col_indices.SetSize (a.NZE() * entrysize * entrysize);
+    values.SetSize (a.NZE() * entrysize * entrysize);
+    
+    if ( symmetric )
+      {
+        int ii = 0;
+        for (int i = 0; i < a.Height(); i++ )
+          {
+            FlatArray<int> rowind = a.GetRowIndices(i);
+            FlatVector<TM> rowvals = a.GetRowValues(i);
+            
+            for (int j = 0; j < rowind.Size(); j++ )
+              {
+                int col = rowind[j];
+                if (used (i, col))
+                  {
+                    for (int l = 0; l < entrysize; l++ )
+                      for (int k = 0; k < entrysize; k++)
+                        {
+                          int rowi = i*entrysize+l+1;
+                          int coli = col*entrysize+k+1;
+                          if (rowi >= coli)
+                            {
+                              col_indices[ii] = coli;
+                              row_indices[ii] = rowi;
+                              values[ii] = Access(rowvals[j],l,k);
+                              ii++;
+                            }
+                        }
+                  }
+                else if (i == col)
+                  {
+                    // in the case of 'inner' or 'cluster': 1 on the diagonal for
+                    // unused dofs.
+                    for (int l=0; l<entrysize; l++ )
+                      {
+                        col_indices[ii] = col*entrysize+l+1;
+                        row_indices[ii] = col*entrysize+l+1;
+                        values[ii] = 1;
+                        ii++;
+                      }
+                  }
+              }
+          }
+        nze = ii;
+      }
+    else
+      {
+        // --- transform matrix to compressed column storage format ---
+        Array<int> colstart(height+1), counter(height);
+        colstart = 0;
+        counter = 0;
+
+        // 1.) build array 'colstart':
+        // (a) get nr. of entries for each col
+        for (int i = 0; i < a.Height(); i++ )
+          for (int col : a.GetRowIndices(i))
+            {
+              if (used (i, col))
+                {
+                  for (int k=0; k<entrysize; k++ )
+                    colstart[col*entrysize+k+1] += entrysize;
+                }
+              else if ( i == col )
+                {
+                  for (int k=0; k<entrysize; k++ )
+                    colstart[col*entrysize+k+1] ++;
+                }
+            }
+
+        // (b) accumulate
+        for (int i = 1; i <= height; i++ ) colstart[i] += colstart[i-1];
+        nze = colstart[height];
+
+        // 2.) build whole matrix:
+        for (int i = 0; i < a.Height(); i++ )
+          {
+            FlatArray<int> rowind = a.GetRowIndices(i);
+            FlatVector<TM> rowvals = a.GetRowValues(i);
+            for (int j = 0; j < rowind.Size(); j++ )
+              {
+                int col = rowind[j];
+                if (used (i, col))
+                  {
+                    for (int k = 0; k < entrysize; k++)
+                      for (int l = 0; l < entrysize; l++ )
+                        {
+                          int pos = colstart[col*entrysize+k] + counter[col*entrysize+k]++;
+                          row_indices[pos] = i*entrysize+l + 1;
+                          col_indices[pos] = col*entrysize+k + 1;
+                          values[pos] = Access(rowvals[j],l,k);
+                        }
+                  }
+                else if (i == col)
+                  {
+                    for (int l=0; l<entrysize; l++ )
+                      {
+                        int pos = colstart[col*entrysize+l] + counter[col*entrysize+l]++;
+                        col_indices[pos] = col*entrysize+l + 1;
+                        row_indices[pos] = col*entrysize+l + 1;
+                        values[pos] = 1;
+                      }
+                  }
+              }
+          }
+      }
+  }
+
+
+  template <class TM, class TV_ROW, class TV_COL>
+  void MumpsInverse<TM,TV_ROW,TV_COL> :: Factor ()
+  {
+    mumps_id.a   = (typename mumps_trait<TSCAL>::MUMPS_TSCAL*)values.Data(); 
+    mumps_id.job = JOB_FACTOR;
+
+    MPI_Barrier (comm);
+    mumps_trait<TSCAL>::MumpsFunction (&mumps_id);
+
+    if (mumps_id.infog[0] != 0)
+      {
+	cout << " factorization done" << endl;
+	cout << "error-code = " << mumps_id.infog[0] << endl;
+	cout << "info(1) = " << mumps_id.info[0] << endl;
+	cout << "info(2) = " << mumps_id.info[1] << endl;
+      }
+  }
+
+
+  template <class TM, class TV_ROW, class TV_COL>
+  void MumpsInverse<TM,TV_ROW,TV_COL> :: Update ()
+  {
+    static Timer t("Mumps Inverse - update");
+    RegionTimer reg(t);
+
+    auto spmat = matrix.lock();
+    if (!spmat)
+      throw Exception ("MumpsInverse::Update: matrix has been deleted");
+    if (comm.Rank() == 0)
+      {
+        auto & a = dynamic_cast<const SparseMatrix<TM,TV_ROW,TV_COL>&> (*spmat);
+        if (a.Height()*entrysize != height)
+          throw Exception ("MumpsInverse::Update: matrix size has changed");
+        GetMumpsMatrix (a);
+        if (nze != mumps_id.nz)
+          throw Exception ("MumpsInverse::Update: matrix graph has changed");
+      }
+    // ordering and symbolic analysis are kept in mumps_id
+    Factor();
   }
-  
   
 
   template <class TM, class TV_ROW, class TV_COL>
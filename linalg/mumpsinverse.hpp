@@ -67,9 +67,17 @@ namespace ngla
 
     shared_ptr<BitArray> inner;
     shared_ptr<const Array<int>> cluster;
+    weak_ptr<BaseSparseMatrix> matrix;
+
+    // matrix in coordinate format, kept for numeric refactorization
+    Array<int> row_indices, col_indices;
+    Array<TSCAL> values;
 
     NgMPI_Comm comm;
 
+    void GetMumpsMatrix (const SparseMatrix<TM,TV_ROW,TV_COL> & a);
+    void Factor ();
+
   public:
     ///
     MumpsInverse (const SparseMatrix<TM,TV_ROW,TV_COL> & a, 
@@ -89,6 +97,9 @@ namespace ngla
     virtual bool IsComplex() const { return iscomplex; }
     ///
     virtual void Mult (const BaseVector & x, BaseVector & y) const;
+    /// numeric factorization of the updated matrix, keeps the analysis phase
+    virtual void Update ();
+    virtual bool SupportsUpdate() const { return true; }
 
     ///
     virtual AutoVector CreateVector () const
@@ -796,4 +796,480 @@ namespace ngla
     list[nr].degree = 0;
   }
 
+
+
+
+  /*
+    Nested dissection ordering, multilevel bisection follows
+
+    Karypis, Kumar: A fast and high quality multilevel scheme for
+    partitioning irregular graphs, SIAM J. Sci. Comput. 20, 1998
+  */
+
+  namespace 
+  {
+    // compressed graph with vertex- and edge-weights
+    class NDGraph
+    {
+    public:
+      Array<size_t> firsti;
+      Array<int> adj;
+      Array<int> ewt;
+      Array<int> vwt;
+      // map from the finer graph to this graph
+      Array<int> cmap;
+
+      size_t Size() const { return vwt.Size(); }
+      auto Edges (size_t v) const { return Range(firsti[v], firsti[v+1]); }
+    };
+
+
+    // heavy edge matching
+    void Coarsen (const NDGraph & g, NDGraph & cg)
+    {
+      size_t n = g.Size();
+      Array<int> match(n);
+      match = -1;
+      for (size_t v = 0; v < n; v++)
+        {
+          if (match[v] != -1) continue;
+          int best = v, bestwt = -1;
+          for (auto e : g.Edges(v))
+            {
+              int w = g.adj[e];
+              if (match[w] == -1 && w != int(v) && g.ewt[e] > bestwt)
+                {
+                  best = w;
+                  bestwt = g.ewt[e];
+                }
+            }
+          match[v] = best;
+          match[best] = v;
+        }
+
+      auto & cmap = cg.cmap;
+      cmap.SetSize(n);
+      int nc = 0;
+      for (size_t v = 0; v < n; v++)
+        if (match[v] >= int(v))
+          {
+            cmap[v] = nc;
+            cmap[match[v]] = nc;
+            nc++;
+          }
+
+      cg.vwt.SetSize(nc);
+      cg.vwt = 0;
+      for (size_t v = 0; v < n; v++)
+        cg.vwt[cmap[v]] += g.vwt[v];
+      
+      // pos[cw]-1 is the position of coarse edge to cw, if not smaller than first
+      Array<size_t> pos(nc);
+      pos = size_t(0);
+      cg.firsti.SetSize(nc+1);
+      cg.adj.SetSize0();
+      cg.ewt.SetSize0();
+      for (size_t v = 0; v < n; v++)
+        if (match[v] >= int(v))
+          {
+            int c = cmap[v];
+            size_t first = cg.adj.Size();
+            cg.firsti[c] = first;
+            
+            auto add_edges = [&] (int fv)
+              {
+                for (auto e : g.Edges(fv))
+                  {
+                    int cw = cmap[g.adj[e]];
+                    if (cw == c) continue;
+                    if (pos[cw] > first)
+                      cg.ewt[pos[cw]-1] += g.ewt[e];
+                    else
+                      {
+                        cg.adj.Append (cw);
+                        cg.ewt.Append (g.ewt[e]);
+                        pos[cw] = cg.adj.Size();
+                      }
+                  }
+              };
+            add_edges (v);
+            if (match[v] != int(v))
+              add_edges (match[v]);
+          }
+      cg.firsti[nc] = cg.adj.Size();
+    }
+
+    
+    int EdgeCut (const NDGraph & g, FlatArray<int> where)
+    {
+      int cut = 0;
+      for (size_t v = 0; v < g.Size(); v++)
+        for (auto e : g.Edges(v))
+          if (where[g.adj[e]] != where[v])
+            cut += g.ewt[e];
+      return cut/2;
+    }
+
+    
+    // greedy graph growing from a few start vertices, keep the smallest cut
+    void InitialBisection (const NDGraph & g, Array<int> & where)
+    {
+      size_t n = g.Size();
+      int totalwt = 0;
+      for (auto w : g.vwt) totalwt += w;
+
+      Array<int> hwhere(n), queue(n);
+      int bestcut = numeric_limits<int>::max();
+      for (size_t trial = 0; trial < 4; trial++)
+        {
+          hwhere = 1;
+          queue.SetSize0();
+          int wt0 = 0;
+          size_t k = 0, scan = 0;
+          size_t start = (trial * n) / 4;
+          hwhere[start] = 0;
+          queue.Append (start);
+          wt0 += g.vwt[start];
+          
+          while (2*wt0 < totalwt)
+            {
+              if (k == queue.Size())
+                {
+                  // graph not connected, continue with some remaining vertex
+                  while (scan < n && hwhere[scan] == 0) scan++;
+                  if (scan == n) break;
+                  hwhere[scan] = 0;
+                  queue.Append (scan);
+                  wt0 += g.vwt[scan];
+                  continue;
+                }
+              int v = queue[k++];
+              for (auto e : g.Edges(v))
+                {
+                  int w = g.adj[e];
+                  if (hwhere[w] == 1 && 2*wt0 < totalwt)
+                    {
+                      hwhere[w] = 0;
+                      queue.Append (w);
+                      wt0 += g.vwt[w];
+                    }
+                }
+            }
+
+          int cut = EdgeCut (g, hwhere);
+          if (cut < bestcut)
+            {
+              bestcut = cut;
+              where = hwhere;
+            }
+        }
+    }
+
+
+    // greedy boundary refinement, moves with positive gain or improving balance
+    void Refine (const NDGraph & g, FlatArray<int> where, double imbalance = 0.05)
+    {
+      size_t n = g.Size();
+      int pwt[2] = { 0, 0 };
+      for (size_t v = 0; v < n; v++)
+        pwt[where[v]] += g.vwt[v];
+      int maxwt = int((0.5+imbalance) * (pwt[0]+pwt[1]));
+
+      for (int pass = 0; pass < 8; pass++)
+        {
+          size_t moved = 0;
+          for (size_t v = 0; v < n; v++)
+            {
+              int p = where[v], q = 1-p;
+              int in = 0, ext = 0;
+              for (auto e : g.Edges(v))
+                if (where[g.adj[e]] == p)
+                  in += g.ewt[e];
+                else
+                  ext += g.ewt[e];
+              if (ext == 0) continue;
+
+              int gain = ext-in;
+              int newwt = pwt[q]+g.vwt[v];
+              bool balance_improves = newwt < pwt[p];
+              if ( (gain > 0 && newwt <= maxwt) ||
+                   (gain == 0 && balance_improves) ||
+                   (pwt[p] > maxwt && balance_improves) )
+                {
+                  where[v] = q;
+                  pwt[p] -= g.vwt[v];
+                  pwt[q] += g.vwt[v];
+                  moved++;
+                }
+            }
+          if (moved == 0) break;
+        }
+    }
+
+    
+    void MultilevelBisection (const NDGraph & g, Array<int> & where)
+    {
+      Array<shared_ptr<NDGraph>> levels;
+      const NDGraph * cur = &g;
+      while (cur->Size() > 100)
+        {
+          auto cg = make_shared<NDGraph>();
+          Coarsen (*cur, *cg);
+          if (cg->Size() > 0.9 * cur->Size()) break;
+          levels.Append (cg);
+          cur = cg.get();
+        }
+
+      InitialBisection (*cur, where);
+      Refine (*cur, where);
+      
+      for (int l = levels.Size()-1; l >= 0; l--)
+        {
+          const NDGraph & fine = (l == 0) ? g : *levels[l-1];
+          FlatArray<int> cmap = levels[l]->cmap;
+          Array<int> fwhere(fine.Size());
+          for (size_t v = 0; v < fine.Size(); v++)
+            fwhere[v] = where[cmap[v]];
+          where = move(fwhere);
+          Refine (fine, where);
+        }
+    }
+  }
+
+  
+  NestedDissectionOrdering :: NestedDissectionOrdering (Table<int> && agraph)
+    : n(agraph.Size()), nused(0), graph(move(agraph)), used(n), stamp(0)
+  {
+    used = true;
+  }
+
+
+  void NestedDissectionOrdering :: Order ()
+  {
+    static Timer t("NestedDissectionOrdering::Order");
+    RegionTimer reg(t);
+
+    Array<int> verts;
+    for (int i = 0; i < n; i++)
+      if (used[i]) verts.Append(i);
+    nused = verts.Size();
+
+    mark.SetSize(n);
+    localnr.SetSize(n);
+    ParallelForRange (n, [&] (IntRange r)
+                      {
+                        mark.Range(r) = -1;
+                        localnr.Range(r) = -1;
+                      });
+
+    order.SetSize(nused);
+    Dissect (verts, order);
+    SymbolicFactorization ();
+  }
+
+
+  /*
+    Parts processed concurrently are never connected, so the 
+    shared mark and localnr arrays are written by one task only.
+  */
+  void NestedDissectionOrdering :: Dissect (FlatArray<int> verts, FlatArray<int> result)
+  {
+    size_t nv = verts.Size();
+    if (nv <= leafsize)
+      {
+        for (size_t i = 0; i < nv; i++)
+          result[i] = verts[i];
+        return;
+      }
+
+    int mystamp = ++stamp;
+    for (size_t i = 0; i < nv; i++)
+      {
+        mark[verts[i]] = mystamp;
+        localnr[verts[i]] = i;
+      }
+
+    // the subgraph in local numbering
+    NDGraph g;
+    g.vwt.SetSize(nv);
+    g.vwt = 1;
+    g.firsti.SetSize(nv+1);
+    for (size_t i = 0; i < nv; i++)
+      {
+        g.firsti[i] = g.adj.Size();
+        for (int w : graph[verts[i]])
+          if (mark[w] == mystamp)
+            g.adj.Append (localnr[w]);
+      }
+    g.firsti[nv] = g.adj.Size();
+    g.ewt.SetSize(g.adj.Size());
+    g.ewt = 1;
+
+    // connected components
+    Array<int> comp(nv), compverts;
+    Array<size_t> compfirst;
+    comp = -1;
+    for (size_t i = 0; i < nv; i++)
+      if (comp[i] == -1)
+        {
+          compfirst.Append (compverts.Size());
+          comp[i] = compfirst.Size()-1;
+          compverts.Append (verts[i]);
+          for (size_t k = compfirst.Last(); k < compverts.Size(); k++)
+            for (auto e : g.Edges(localnr[compverts[k]]))
+              {
+                int w = g.adj[e];
+                if (comp[w] == -1)
+                  {
+                    comp[w] = comp[i];
+                    compverts.Append (verts[w]);
+                  }
+              }
+        }
+    compfirst.Append (compverts.Size());
+
+    if (compfirst.Size() > 2)
+      {
+        // not connected: order the components one after the other
+        ParallelFor (compfirst.Size()-1, [&] (size_t c)
+                     {
+                       Dissect (compverts.Range(compfirst[c], compfirst[c+1]),
+                                result.Range(compfirst[c], compfirst[c+1]));
+                     });
+        return;
+      }
+
+    Array<int> where;
+    MultilevelBisection (g, where);
+    
+    // vertex separator from the boundary of the side with fewer boundary vertices
+    Array<bool> boundary(nv);
+    size_t nboundary[2] = { 0, 0 };
+    for (size_t i = 0; i < nv; i++)
+      {
+        boundary[i] = false;
+        for (auto e : g.Edges(i))
+          if (where[g.adj[e]] != where[i])
+            boundary[i] = true;
+        if (boundary[i]) nboundary[where[i]]++;
+      }
+    int sepside = (nboundary[0] <= nboundary[1]) ? 0 : 1;
+    
+    Array<int> part1, part2, sep;
+    for (size_t i = 0; i < nv; i++)
+      {
+        if (boundary[i] && where[i] == sepside)
+          sep.Append (verts[i]);
+        else if (where[i] == 0)
+          part1.Append (verts[i]);
+        else
+          part2.Append (verts[i]);
+      }
+
+    size_t n1 = part1.Size(), n2 = part2.Size();
+    if (n1+n2 == 0)
+      {
+        for (size_t i = 0; i < nv; i++)
+          result[i] = verts[i];
+        return;
+      }
+
+    auto dissect_part = [&] (int k)
+      {
+        if (k == 0)
+          Dissect (part1, result.Range(0, n1));
+        else
+          Dissect (part2, result.Range(n1, n1+n2));
+      };
+    if (nv > 10000)
+      ParallelFor (2, dissect_part);
+    else
+      {
+        dissect_part(0);
+        dissect_part(1);
+      }
+    
+    for (size_t i = 0; i < sep.Size(); i++)
+      result[n1+n2+i] = sep[i];
+  }
+
+
+  /*
+    Column structures of L are obtained from the original graph
+    and the structures of the children in the elimination tree.
+    Only the structure of the first column of a supernode is stored.
+   */
+  void NestedDissectionOrdering :: SymbolicFactorization ()
+  {
+    static Timer t("NestedDissectionOrdering::SymbolicFactorization");
+    RegionTimer reg(t);
+
+    Array<int> inv(n);
+    inv = -1;
+    for (int i = 0; i < nused; i++)
+      inv[order[i]] = i;
+
+    Array<Array<int>> colstruct(nused);
+    Array<int> marker(nused), first_child(nused), next_sibling(nused);
+    marker = -1;
+    first_child = -1;
+    blocknr.SetSize(nused);
+    Array<int> list;
+
+    for (int j = 0; j < nused; j++)
+      {
+        list.SetSize0();
+        marker[j] = j;
+        for (int w : graph[order[j]])
+          {
+            int i = inv[w];
+            if (i > j && marker[i] != j)
+              {
+                marker[i] = j;
+                list.Append (i);
+              }
+          }
+        for (int c = first_child[j]; c != -1; c = next_sibling[c])
+          for (int i : colstruct[blocknr[c]])
+            if (i > j && marker[i] != j)
+              {
+                marker[i] = j;
+                list.Append (i);
+              }
+        QuickSort (list);
+
+        // column j-1 has structure {j} + struct(j) ?
+        bool same_block = false;
+        if (j > 0)
+          {
+            FlatArray<int> sm = colstruct[blocknr[j-1]];
+            size_t pos = j-1-blocknr[j-1];
+            same_block = pos < sm.Size() && sm[pos] == j &&
+              sm.Size()-pos == list.Size()+1;
+          }
+
+        if (same_block)
+          blocknr[j] = blocknr[j-1];
+        else
+          {
+            blocknr[j] = j;
+            colstruct[j] = Array<int> (list);
+          }
+
+        if (list.Size())
+          {
+            int parent = list[0];
+            next_sibling[j] = first_child[parent];
+            first_child[parent] = j;
+          }
+      }
+
+    TableCreator<int> creator(nused);
+    for ( ; !creator.Done(); creator++)
+      for (int j = 0; j < nused; j++)
+        for (int i : colstruct[j])
+          creator.Add (j, i);
+    structure = creator.MoveTable();
+  }
+
 }
@@ -199,6 +199,60 @@ namespace ngla
   };
 
 
+
+  /**
+     Nested dissection ordering.
+
+     The graph is recursively split by vertex separators, 
+     separator vertices are numbered after the two parts.
+     Bisection is multilevel: the graph is coarsened by heavy-edge
+     matching, the coarsest graph is split by greedy graph growing,
+     and the partition is refined on the way back. The two parts
+     are dissected in parallel.
+
+     Afterwards the symbolic factorization for the new numbering
+     is computed, consecutive columns with nested structure are 
+     collected to (fundamental) supernodes.
+  */
+  class NGS_DLL_HEADER NestedDissectionOrdering
+  {
+  public:
+    ///
+    int n, nused;
+    /// order[i] is the vertex eliminated as i-th
+    Array<int> order;
+    /// first vertex (in elimination order) of the supernode
+    Array<int> blocknr;
+    /// structure of L-columns of supernode masters, in elimination order
+    Table<int> structure;
+    
+  protected:
+    /// symmetric graph, without diagonal
+    Table<int> graph;
+    Array<bool> used;
+    /// subgraphs below this size are not dissected further
+    size_t leafsize = 64;
+
+    // subgraph membership, and local numbers within the subgraph
+    Array<int> mark, localnr;
+    atomic<int> stamp;
+    
+  public:
+    /// graph must be symmetric, without diagonal
+    NestedDissectionOrdering (Table<int> && agraph);
+    ///
+    void SetUnusedVertex (int v) { used[v] = false; }
+    ///
+    void Order();
+    ///
+    int Size () const { return n; }
+    
+  protected:
+    void Dissect (FlatArray<int> verts, FlatArray<int> result);
+    void SymbolicFactorization ();
+  };
+
+
 }
 
 
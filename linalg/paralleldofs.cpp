@@ -172,6 +172,183 @@ namespace ngla
     ScatterDofData (global_nums); 
   }
 
+
+  ExchangePlan & ParallelDofs :: GetExchangePlan (int bs) const
+  {
+    for (auto & plan : exchange_plans)
+      if (plan->BlockSize() == bs)
+        return *plan;
+    exchange_plans.Append (make_shared<ExchangePlan> (*this, bs, exchange_mode));
+    return *exchange_plans.Last();
+  }
+
+
+
+  ExchangePlan :: ExchangePlan (const ParallelDofs & pardofs, int abs, EXCHANGE_MODE amode)
+    : comm(pardofs.GetCommunicator()), bs(abs), mode(amode), procs(pardofs.GetDistantProcs())
+  {
+    static Timer t("ExchangePlan - setup"); RegionTimer reg(t);
+    int nprocs = procs.Size();
+
+    offsets.SetSize (nprocs+1);
+    offsets[0] = 0;
+    for (int i = 0; i < nprocs; i++)
+      offsets[i+1] = offsets[i] + pardofs.GetExchangeDofs(procs[i]).Size();
+
+    dofs.SetSize (offsets[nprocs]);
+    for (int i = 0; i < nprocs; i++)
+      {
+        auto exdofs = pardofs.GetExchangeDofs(procs[i]);
+        for (size_t j = 0; j < exdofs.Size(); j++)
+          dofs[offsets[i]+j] = exdofs[j];
+      }
+
+    // own tag, may be in flight together with a plain Cumulate
+    int tag = MPI_TAG_SOLVE+1;
+
+    sendbuf.SetSize (bs*dofs.Size());
+    recvbuf.SetSize (bs*dofs.Size());
+
+    switch (mode)
+      {
+      case EXCHANGE_MODE::PERSISTENT:
+        {
+          requests.SetSize (2*nprocs);
+          for (int i = 0; i < nprocs; i++)
+            {
+              int cnt = bs * (offsets[i+1]-offsets[i]);
+              MPI_Send_init (&sendbuf[bs*offsets[i]], cnt, MPI_DOUBLE, procs[i],
+                             tag, comm, &requests[i]);
+              MPI_Recv_init (&recvbuf[bs*offsets[i]], cnt, MPI_DOUBLE, procs[i],
+                             tag, comm, &requests[nprocs+i]);
+            }
+          break;
+        }
+      case EXCHANGE_MODE::NEIGHBOR:
+        {
+          counts.SetSize (nprocs);
+          displs.SetSize (nprocs);
+          for (int i = 0; i < nprocs; i++)
+            {
+              counts[i] = bs * (offsets[i+1]-offsets[i]);
+              displs[i] = bs * offsets[i];
+            }
+          MPI_Dist_graph_create_adjacent (comm, nprocs, procs.Data(), MPI_UNWEIGHTED,
+                                          nprocs, procs.Data(), MPI_UNWEIGHTED,
+                                          MPI_INFO_NULL, 0, &graphcomm);
+          requests.SetSize (1);
+          break;
+        }
+      case EXCHANGE_MODE::ONESIDED:
+        {
+          MPI_Win_create (recvbuf.Data(), recvbuf.Size()*sizeof(double), sizeof(double),
+                          MPI_INFO_NULL, comm, &win);
+
+          // tell every neighbour where to put its values
+          Array<int> myoffsets(nprocs);
+          remote_offsets.SetSize (nprocs);
+          Array<MPI_Request> reqs(2*nprocs);
+          for (int i = 0; i < nprocs; i++)
+            {
+              myoffsets[i] = bs * offsets[i];
+              MPI_Isend (&myoffsets[i], 1, MPI_INT, procs[i], tag, comm, &reqs[i]);
+              MPI_Irecv (&remote_offsets[i], 1, MPI_INT, procs[i], tag, comm, &reqs[nprocs+i]);
+            }
+          MyMPI_WaitAll (reqs);
+
+          MPI_Group commgroup;
+          MPI_Comm_group (comm, &commgroup);
+          MPI_Group_incl (commgroup, nprocs, procs.Data(), &neighbours);
+          MPI_Group_free (&commgroup);
+          break;
+        }
+      }
+  }
+
+
+  ExchangePlan :: ~ExchangePlan ()
+  {
+    int finalized;
+    MPI_Finalized (&finalized);
+    if (finalized) return;
+
+    if (mode == EXCHANGE_MODE::PERSISTENT)
+      for (auto & request : requests)
+        MPI_Request_free (&request);
+    // collective, as the setup
+    if (graphcomm != MPI_COMM_NULL)
+      MPI_Comm_free (&graphcomm);
+    if (win != MPI_WIN_NULL)
+      MPI_Win_free (&win);
+    if (neighbours != MPI_GROUP_NULL)
+      MPI_Group_free (&neighbours);
+  }
+
+  
+  void ExchangePlan :: Start (const double * vec)
+  {
+    static Timer t("ExchangePlan - Start"); RegionTimer reg(t);
+    
+    // gather
+    size_t n = dofs.Size();
+    if (bs == 1)
+      for (size_t i = 0; i < n; i++)
+        sendbuf[i] = vec[dofs[i]];
+    else
+      for (size_t i = 0; i < n; i++)
+        for (int k = 0; k < bs; k++)
+          sendbuf[i*bs+k] = vec[size_t(dofs[i])*bs+k];
+
+    switch (mode)
+      {
+      case EXCHANGE_MODE::PERSISTENT:
+        if (requests.Size())  // Startall with 0 requests fails
+          MPI_Startall (requests.Size(), requests.Data());
+        break;
+      case EXCHANGE_MODE::NEIGHBOR:
+        MPI_Ineighbor_alltoallv (sendbuf.Data(), counts.Data(), displs.Data(), MPI_DOUBLE,
+                                 recvbuf.Data(), counts.Data(), displs.Data(), MPI_DOUBLE,
+                                 graphcomm, &requests[0]);
+        break;
+      case EXCHANGE_MODE::ONESIDED:
+        MPI_Win_post (neighbours, 0, win);
+        MPI_Win_start (neighbours, 0, win);
+        for (int i = 0; i < procs.Size(); i++)
+          {
+            int cnt = bs * (offsets[i+1]-offsets[i]);
+            MPI_Put (&sendbuf[bs*offsets[i]], cnt, MPI_DOUBLE, procs[i],
+                     remote_offsets[i], cnt, MPI_DOUBLE, win);
+          }
+        break;
+      }
+    busy = true;
+  }
+
+  
+  void ExchangePlan :: FinishAdd (double * vec)
+  {
+    static Timer t("ExchangePlan - Finish"); RegionTimer reg(t);
+
+    if (mode == EXCHANGE_MODE::ONESIDED)
+      {
+        MPI_Win_complete (win);
+        MPI_Win_wait (win);
+      }
+    else if (requests.Size())
+      MPI_Waitall (requests.Size(), requests.Data(), MPI_STATUSES_IGNORE);
+
+    // scatter-add
+    size_t n = dofs.Size();
+    if (bs == 1)
+      for (size_t i = 0; i < n; i++)
+        vec[dofs[i]] += recvbuf[i];
+    else
+      for (size_t i = 0; i < n; i++)
+        for (int k = 0; k < bs; k++)
+          vec[size_t(dofs[i])*bs+k] += recvbuf[i*bs+k];
+    busy = false;
+  }
+
 }
 
 
@@ -12,6 +12,11 @@
 namespace ngla
 {
 
+  /// how values at exchange dofs are communicated
+  enum class EXCHANGE_MODE { PERSISTENT, NEIGHBOR, ONESIDED };
+
+  class ExchangePlan;
+
 #ifdef PARALLEL
 
   /**
@@ -47,6 +52,10 @@ namespace ngla
     /// entry-size
     int es;
     bool complex;
+
+    /// cached exchange plans, one per block-size
+    EXCHANGE_MODE exchange_mode = EXCHANGE_MODE::PERSISTENT;
+    mutable Array<shared_ptr<ExchangePlan>> exchange_plans;
     
   public:
     /**
@@ -103,6 +112,12 @@ namespace ngla
 
     void EnumerateGlobally (shared_ptr<BitArray> freedofs, Array<int> & globnum, int & num_glob_dofs) const;
 
+    /// exchange of vectors with bs doubles per dof, created on first use (collective)
+    ExchangePlan & GetExchangePlan (int bs) const;
+    void SetExchangeMode (EXCHANGE_MODE amode)
+    { exchange_mode = amode; exchange_plans.SetSize0(); }
+    EXCHANGE_MODE GetExchangeMode () const { return exchange_mode; }
+
 
     template <typename T>
     void ReduceDofData (FlatArray<T> data, MPI_Op op) const;
@@ -121,6 +136,44 @@ namespace ngla
 
   };
 
+
+
+  /**
+     Sums the values at exchange dofs with all neighbour processes.
+     Values are packed into contiguous buffers, the communication pattern 
+     is set up once: persistent point-to-point requests, a neighbourhood 
+     collective on a graph communicator, or one-sided puts.
+   */
+  class ExchangePlan
+  {
+    MPI_Comm comm;
+    int bs;
+    EXCHANGE_MODE mode;
+    FlatArray<int> procs;
+    Array<size_t> offsets;        // of the procs in the buffers
+    Array<int> dofs;              // exchange dofs, concatenated
+    Array<double> sendbuf, recvbuf;
+    Array<MPI_Request> requests;
+    MPI_Comm graphcomm = MPI_COMM_NULL;
+    Array<int> counts, displs;
+    MPI_Win win = MPI_WIN_NULL;
+    MPI_Group neighbours = MPI_GROUP_NULL;
+    Array<int> remote_offsets;    // my block in the neighbours' recvbuf
+    bool busy = false;
+
+  public:
+    ExchangePlan (const ParallelDofs & pardofs, int abs, EXCHANGE_MODE amode);
+    ~ExchangePlan ();
+
+    int BlockSize () const { return bs; }
+    bool IsBusy () const { return busy; }
+
+    /// packs the values at exchange dofs and starts the communication
+    void Start (const double * vec);
+    /// waits and adds the received values
+    void FinishAdd (double * vec);
+  };
+
 #else
 
   class ParallelDofs 
@@ -169,6 +222,9 @@ namespace ngla
     template <typename T>
     void AllReduceDofData (FlatArray<T> data, MPI_Op op) const { ; }
 
+    void SetExchangeMode (EXCHANGE_MODE amode) { ; }
+    EXCHANGE_MODE GetExchangeMode () const { return EXCHANGE_MODE::PERSISTENT; }
+
     int GetEntrySize () const { return es; }
     bool IsComplex () const { return complex; }
   };
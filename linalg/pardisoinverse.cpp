@@ -647,6 +647,56 @@ namespace ngla
 
 
 
+  template<class TM>
+  void PardisoInverseTM<TM> :: Update()
+  {
+    static Timer timer("Pardiso Inverse - update");
+    RegionTimer reg (timer);
+
+    // member 'matrix' holds the pardiso values
+    auto castmatrix = dynamic_pointer_cast<SparseMatrixTM<TM>>(GetAMatrix());
+    if (!castmatrix)
+      throw Exception ("PardisoInverse::Update: matrix has been deleted");
+    if (castmatrix->Height()*entrysize != height)
+      throw Exception ("PardisoInverse::Update: matrix size has changed");
+
+    if (inner)
+      GetPardisoMatrix (*castmatrix, SubsetFree (*inner));
+    else if (cluster)
+      GetPardisoMatrix (*castmatrix, SubsetCluster (*cluster));
+    else
+      GetPardisoMatrix (*castmatrix, SubsetAll());
+
+    if (rowstart[compressed_height] != nze)
+      throw Exception ("PardisoInverse::Update: matrix graph has changed");
+
+    integer maxfct = 1, mnum = 1, phase = 22, nrhs = 1, msglevel = print, error;
+    integer * params = const_cast <integer*> (&hparams[0]);
+
+    cout << IM(3) << "call pardiso update ..." << flush;
+    if (task_manager) task_manager -> StopWorkers();
+#ifdef USE_MKL
+    mkl_set_num_threads(mkl_max_threads);
+#endif // USE_MKL
+
+    F77_FUNC(pardiso) ( pt, &maxfct, &mnum, &matrixtype, &phase, &compressed_height, 
+			reinterpret_cast<double *>(&matrix[0]),
+			&rowstart[0], &indices[0], NULL, &nrhs, params, &msglevel,
+			NULL, NULL, &error );
+#ifdef USE_MKL
+    mkl_set_num_threads(1);
+#endif // USE_MKL
+    if (task_manager) task_manager -> StartWorkers();
+    cout << IM(3) << " done" << endl;
+
+    if (error != 0)
+      {
+        cout << "Numeric Factorization: PARDISO returned error " << error << "!" << endl;
+        throw Exception("PardisoInverse: Numeric factorization failed.");
+      }
+  }
+
+
   template<class TM>
   void PardisoInverseTM<TM> :: SetMatrixType() // TM entry)
   {
@@ -137,6 +137,10 @@ namespace ngla
     ///
     virtual ostream & Print (ostream & ost) const;
 
+    virtual bool SupportsUpdate() const { return true; }
+    /// numeric factorization only (phase 22), reordering and symbolic factorization are kept
+    virtual void Update();
+
     virtual Array<MemoryUsage> GetMemoryUsage () const
     {
       return { MemoryUsage ("Pardiso", nze*sizeof(TM), 1) };
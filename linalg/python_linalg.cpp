@@ -62,6 +62,119 @@ public:
 };
 
 
+/// vector working on the memory of a numpy array, keeps the array alive
+template <typename TSCAL>
+class NumPyVector : public S_BaseVectorPtr<TSCAL>
+{
+  py::object array;
+public:
+  NumPyVector (py::array arr, size_t size, int es)
+    : S_BaseVectorPtr<TSCAL> (size, es, arr.mutable_data()), array(arr) { ; }
+  ~NumPyVector ()
+  {
+    py::gil_scoped_acquire gil;
+    array = py::object();
+  }
+};
+
+static shared_ptr<BaseVector> WrapNumPy (py::array arr)
+{
+  if (!(arr.flags() & py::array::c_style) || !arr.writeable())
+    throw Exception ("BaseVector needs a writeable, C-contiguous numpy array");
+  if (arr.ndim() != 1 && arr.ndim() != 2)
+    throw Exception ("BaseVector needs a 1D or 2D numpy array");
+  size_t size = arr.shape(0);
+  int es = (arr.ndim() == 2) ? arr.shape(1) : 1;
+  if (py::isinstance<py::array_t<double>> (arr))
+    return make_shared<NumPyVector<double>> (arr, size, es);
+  if (py::isinstance<py::array_t<Complex>> (arr))
+    return make_shared<NumPyVector<Complex>> (arr, size, es);
+  throw Exception ("BaseVector needs a numpy array of float64 or complex128");
+}
+
+template <typename TSCAL>
+py::buffer_info MakeBuffer (void * data, std::vector<py::ssize_t> shape,
+                            std::vector<py::ssize_t> strides)
+{
+  return py::buffer_info (data, sizeof(TSCAL), py::format_descriptor<TSCAL>::format(),
+                          shape.size(), shape, strides);
+}
+
+static bool HasContiguousMemory (const BaseVector & vec)
+{
+  return dynamic_cast<const S_BaseVectorPtr<double>*> (&vec) ||
+    dynamic_cast<const S_BaseVectorPtr<Complex>*> (&vec);
+}
+
+/// (local) vector memory, vectors with entrysize > 1 as a size x entrysize array
+static py::buffer_info VectorBuffer (BaseVector & vec)
+{
+  if (!HasContiguousMemory (vec))
+    throw py::buffer_error ("vector has no contiguous memory");
+  size_t es = vec.IsComplex() ? vec.EntrySize()/2 : vec.EntrySize();
+  size_t scal = vec.IsComplex() ? sizeof(Complex) : sizeof(double);
+  std::vector<py::ssize_t> shape { py::ssize_t(vec.Size()) }, strides { py::ssize_t(es*scal) };
+  if (es > 1)
+    {
+      shape.push_back (es);
+      strides.push_back (scal);
+    }
+  if (vec.IsComplex())
+    return MakeBuffer<Complex> (vec.Memory(), shape, strides);
+  return MakeBuffer<double> (vec.Memory(), shape, strides);
+}
+
+/// size x cnt array of the vectors, needs equally spaced vectors in memory
+static py::buffer_info MultiVectorBuffer (MultiVector & mv)
+{
+  size_t cnt = mv.Size();
+  size_t scal = mv.IsComplex() ? sizeof(Complex) : sizeof(double);
+  if (cnt == 0 || !HasContiguousMemory (*mv[0]))
+    throw py::buffer_error ("MultiVector is empty or has no contiguous memory");
+  size_t size = mv[0]->Size();
+  char * first = static_cast<char*> (mv[0]->Memory());
+  py::ssize_t dist = size*scal;
+  for (size_t i = 0; i < cnt; i++)
+    {
+      auto & vec = *mv[i];
+      if (!HasContiguousMemory (vec) || vec.Size() != size || vec.EntrySize()*sizeof(double) != scal)
+        throw py::buffer_error ("MultiVector vectors have no common memory layout");
+      if (i == 1)
+        dist = static_cast<char*> (vec.Memory()) - first;
+      if (static_cast<char*> (vec.Memory()) != first + i*dist)
+        throw py::buffer_error ("MultiVector vectors are not equally spaced in memory");
+    }
+  if (mv.IsComplex())
+    return MakeBuffer<Complex> (first, { py::ssize_t(size), py::ssize_t(cnt) },
+                                { py::ssize_t(scal), dist });
+  return MakeBuffer<double> (first, { py::ssize_t(size), py::ssize_t(cnt) },
+                             { py::ssize_t(scal), dist });
+}
+
+/// read-only numpy view of memory owned by the python object base
+template <typename T>
+py::array ReadOnlyView (T * data, std::vector<py::ssize_t> shape,
+                        std::vector<py::ssize_t> strides, py::object base)
+{
+  auto arr = py::array_t<T> (shape, strides, data, base);
+  arr.attr("setflags")(py::arg("write")=false);
+  return std::move(arr);
+}
+
+// the ordering is used for one factorization, the matrix keeps its own
+class OrderingScope
+{
+  const BaseSparseMatrix & mat;
+  ORDERINGTYPE old;
+public:
+  OrderingScope (const BaseSparseMatrix & amat, string ordering)
+    : mat(amat), old(amat.GetOrderingType())
+  {
+    if (ordering != "") mat.SetOrderingType (ordering);
+  }
+  ~OrderingScope () { mat.SetOrderingType (old); }
+};
+
 template<typename T>
 void ExportSparseMatrix(py::module m)
 {
@@ -134,6 +247,32 @@ void ExportSparseMatrix(py::module m)
 
     .def_property_readonly("entrysizes", [](shared_ptr<SparseMatrix<T>> self)
                            { return self->EntrySizes(); })
+
+    .def_property_readonly("firsti", [] (py::object self)
+         {
+           auto first = self.cast<SparseMatrix<T>&>().GetFirstArray();
+           return ReadOnlyView (first.Data(), { py::ssize_t(first.Size()) },
+                                { py::ssize_t(sizeof(size_t)) }, self);
+         }, "read-only view of the row starts (CSR indptr)")
+    .def_property_readonly("colnr", [] (py::object self)
+         {
+           auto colnr = self.cast<SparseMatrix<T>&>().GetColIndices();
+           return ReadOnlyView (colnr.Data(), { py::ssize_t(colnr.Size()) },
+                                { py::ssize_t(sizeof(int)) }, self);
+         }, "read-only view of the column numbers (CSR indices)")
+    .def_property_readonly("data", [] (py::object self)
+         {
+           typedef typename mat_traits<T>::TSCAL TSCAL;
+           constexpr int h = mat_traits<T>::HEIGHT, w = mat_traits<T>::WIDTH;
+           auto values = self.cast<SparseMatrix<T>&>().GetValues();
+           TSCAL * data = reinterpret_cast<TSCAL*> (values.Data());
+           if (h == 1 && w == 1)
+             return ReadOnlyView (data, { py::ssize_t(values.Size()) },
+                                  { py::ssize_t(sizeof(T)) }, self);
+           return ReadOnlyView (data, { py::ssize_t(values.Size()), h, w },
+                                { py::ssize_t(sizeof(T)), py::ssize_t(w*sizeof(TSCAL)),
+                                  py::ssize_t(sizeof(TSCAL)) }, self);
+         }, "read-only view of the matrix entries (CSR data)")
     
     .def_static("CreateFromCOO",
                 [] (py::list indi, py::list indj, py::list values, size_t h, size_t w)
@@ -184,6 +323,11 @@ void NGS_DLL_HEADER ExportNgla(py::module &m) {
     .value("NOT_PARALLEL", NOT_PARALLEL)
     ;
 
+  py::enum_<EXCHANGE_MODE>(m, "EXCHANGE_MODE", "MPI mechanism used for cumulating parallel vectors")
+    .value("PERSISTENT", EXCHANGE_MODE::PERSISTENT)
+    .value("NEIGHBOR", EXCHANGE_MODE::NEIGHBOR)
+    .value("ONESIDED", EXCHANGE_MODE::ONESIDED)
+    ;
 
   py::class_<ParallelDofs, shared_ptr<ParallelDofs>> (m, "ParallelDofs")
 #ifdef PARALLEL
@@ -227,6 +371,10 @@ void NGS_DLL_HEADER ExportNgla(py::module &m) {
       }, py::arg("freedofs")=nullptr)
     .def("MasterDofs", &ParallelDofs::MasterDofs)
     .def_property_readonly("entrysize", [](shared_ptr<ParallelDofs> self)  { return self->GetEntrySize(); })
+    .def_property("exchange_mode",
+                  [](const ParallelDofs & self) { return self.GetExchangeMode(); },
+                  [](ParallelDofs & self, EXCHANGE_MODE mode) { self.SetExchangeMode(mode); },
+                  "MPI mechanism used for cumulating vectors, must be set on all ranks")
     ;
 
   py::class_<DofRange, IntRange> (m, "DofRange")
@@ -259,8 +407,23 @@ void NGS_DLL_HEADER ExportNgla(py::module &m) {
      
     
   py::class_<BaseVector, shared_ptr<BaseVector>>(m, "BaseVector",
-        py::dynamic_attr() // add dynamic attributes
+        py::dynamic_attr(), // add dynamic attributes
+        py::buffer_protocol()
       )
+    .def_buffer (&VectorBuffer)
+    .def(py::init([] (py::array array, bool copy) -> shared_ptr<BaseVector>
+                  {
+                    auto vec = WrapNumPy (array);
+                    if (!copy) return vec;
+                    shared_ptr<BaseVector> hvec = vec->CreateVector();
+                    *hvec = *vec;
+                    return hvec;
+                  }), py::arg("array"), py::arg("copy"),
+         "vector from a C-contiguous float64 or complex128 numpy array,\n"
+         "copy=False shares the memory of the array")
+    .def("NumPy", [] (py::object self)
+         { return py::module::import("numpy").attr("asarray")(self); },
+         "numpy view of the vector memory, without copying")
     .def(py::init([] (size_t s, bool is_complex, int es) -> shared_ptr<BaseVector>
                   { return CreateBaseVector(s,is_complex, es); }),
          "size"_a, "complex"_a=false, "entrysize"_a=1)
@@ -577,7 +740,11 @@ void NGS_DLL_HEADER ExportNgla(py::module &m) {
          { return e1-e2; })
     ;
 
-  py::class_<MultiVector, MultiVectorExpr, shared_ptr<MultiVector>> (m, "MultiVector")
+  py::class_<MultiVector, MultiVectorExpr, shared_ptr<MultiVector>> (m, "MultiVector", py::buffer_protocol())
+    .def_buffer (&MultiVectorBuffer)
+    .def("NumPy", [] (py::object self)
+         { return py::module::import("numpy").attr("asarray")(self); },
+         "numpy view (size x number of vectors) of equally spaced vectors, without copying")
     // .def(py::init<shared_ptr<BaseVector>,size_t>([] ))
     .def(py::init<>([] (shared_ptr<BaseVector> bv, size_t cnt) { return bv->CreateMultiVector(cnt); } ))
     .def(py::init<size_t,size_t,bool>())
@@ -974,12 +1141,18 @@ void NGS_DLL_HEADER ExportNgla(py::module &m) {
                                               return GetInverseName( m.GetInverseType());
                                             })
 
-    .def("Inverse", [](BM &m, shared_ptr<BitArray> freedofs, string inverse)
+    .def("Inverse", [](BM &m, shared_ptr<BitArray> freedofs, string inverse, string ordering)
                                      { 
                                        if (inverse != "") m.SetInverseType(inverse);
+                                       if (ordering == "")
+                                         return m.InverseMatrix(freedofs);
+                                       auto spmat = dynamic_cast<BaseSparseMatrix*> (&m);
+                                       if (!spmat)
+                                         throw Exception ("ordering can be set only for sparse matrices");
+                                       OrderingScope scope(*spmat, ordering);
                                        return m.InverseMatrix(freedofs);
                                      }
-         ,"Inverse", py::arg("freedofs")=nullptr, py::arg("inverse")=py::str(""), 
+         ,"Inverse", py::arg("freedofs")=nullptr, py::arg("inverse")=py::str(""), py::arg("ordering")=py::str(""),
          docu_string(R"raw_string(Calculate inverse of sparse matrix
 Parameters:
 
@@ -993,6 +1166,11 @@ inverse : string
     pardiso        - PARDISO, either provided by libpardiso (USE_PARDISO=ON) or Intel MKL (USE_MKL=ON).
                      If neither Pardiso nor Intel MKL was linked at compile-time, NGSolve will look
                      for libmkl_rt in LD_LIBRARY_PATH (Unix) or PATH (Windows) at run-time.
+
+ordering : string
+  Fill-reducing ordering for sparsecholesky, allowed values are:
+    mindegree        - minimum degree ordering (default)
+    nesteddissection - nested dissection, wider elimination tree for parallel factorization
 )raw_string"), py::call_guard<py::gil_scoped_release>())
     // .def("Inverse", [](BM &m)  { return m.InverseMatrix(); })
 
@@ -1043,6 +1221,8 @@ inverse : string
          })
     
     .def("Update", [](BM &m) { m.Update(); }, py::call_guard<py::gil_scoped_release>(), "Update matrix")
+    .def_property_readonly("supports_update", [](BM & m) { return m.SupportsUpdate(); },
+                           "Update() refactors in place, reusing the symbolic factorization")
     ;
 
   py::class_<BaseSparseMatrix, shared_ptr<BaseSparseMatrix>, BaseMatrix>
@@ -1052,7 +1232,8 @@ inverse : string
          { return m.CreateJacobiPrecond(ba); }, py::call_guard<py::gil_scoped_release>(),
          py::arg("freedofs") = shared_ptr<BitArray>())
     
-    .def("CreateBlockSmoother", [](BaseSparseMatrix & m, py::object blocks, bool parallel)
+    .def("CreateBlockSmoother", [](BaseSparseMatrix & m, py::object blocks, bool parallel,
+                                   string ordering)
          {
            shared_ptr<Table<int>> blocktable;
            {
@@ -1074,8 +1255,16 @@ inverse : string
                    row[j++] = val.cast<int>();
                }
            }
+           OrderingScope scope(m, ordering);
            return m.CreateBlockJacobiPrecond (blocktable, nullptr, parallel);
-         }, py::call_guard<py::gil_scoped_release>(), py::arg("blocks"), py::arg("parallel")=false)
+         }, py::call_guard<py::gil_scoped_release>(), py::arg("blocks"), py::arg("parallel")=false,
+         py::arg("ordering")="")
+
+    .def("Restrict", [](BaseSparseMatrix & m, const SparseMatrix<double> & prol,
+                        shared_ptr<BaseSparseMatrix> cmat)
+         { return m.Restrict (prol, cmat); }, py::call_guard<py::gil_scoped_release>(),
+         py::arg("prol"), py::arg("cmat") = shared_ptr<BaseSparseMatrix>(),
+         "Galerkin product prol^T * mat * prol, reuses the pattern of cmat if it fits")
      ;
   
   py::class_<S_BaseMatrix<double>, shared_ptr<S_BaseMatrix<double>>, BaseMatrix>
@@ -1236,6 +1425,8 @@ inverse : string
     .def_property_readonly("col_pardofs", [](ParallelMatrix & mat) { return mat.GetColParallelDofs(); })
     .def_property_readonly("local_mat", [](ParallelMatrix & mat) { return mat.GetMatrix(); })
     .def_property_readonly("op_type", [](ParallelMatrix & mat) { return mat.GetOpType(); })
+    .def_property("overlap", &ParallelMatrix::GetOverlap, &ParallelMatrix::SetOverlap,
+                  "overlap the halo exchange of the input vector with the interior rows")
     ;
 
 
@@ -1298,6 +1489,39 @@ inverse : string
                   }))
     ;
 
+  py::class_<SparseMatrixFloat, shared_ptr<SparseMatrixFloat>, BaseSparseMatrix>
+    (m, "SparseMatrixFloat",
+     "real sparse matrix with entries stored in single precision,\n"
+     "products are accumulated in double precision.\n"
+     "CreateSmoother and CreateBlockSmoother keep their inverses in single precision.\n"
+     "Symmetric storage is expanded to the full pattern.")
+    .def(py::init([] (const BaseMatrix & mat)
+                  {
+                    if (auto ptr = dynamic_cast<const SparseMatrixSymmetric<double>*> (&mat); ptr)
+                      return make_shared<SparseMatrixFloat> (*ExpandSymmetric(*ptr));
+                    if (auto ptr = dynamic_cast<const SparseMatrixTM<double>*> (&mat); ptr)
+                      return make_shared<SparseMatrixFloat> (*ptr);
+                    throw Exception("cannot create SparseMatrixFloat");
+                  }), py::arg("mat"))
+    ;
+
+  py::class_<SparseMatrixSELL<double>, shared_ptr<SparseMatrixSELL<double>>, BaseMatrix>
+    (m, "SparseMatrixSELL", "sparse matrix in sliced ELLPACK (SELL-C-sigma) format")
+    .def(py::init([] (const BaseMatrix & mat, size_t sigma)
+                  {
+                    if (auto ptr = dynamic_cast<const SparseMatrixSymmetric<double>*> (&mat); ptr)
+                      return make_shared<SparseMatrixSELL<double>> (*ExpandSymmetric(*ptr), sigma);
+                    if (auto ptr = dynamic_cast<const SparseMatrixTM<double>*> (&mat); ptr)
+                      return make_shared<SparseMatrixSELL<double>> (*ptr, sigma);
+                    throw Exception("cannot create SparseMatrixSELL");
+                  }), py::arg("mat"), py::arg("sigma")=256,
+         "converts a real sparse matrix, rows are sorted by length within windows of sigma rows.\n"
+         "Symmetric storage is expanded to the full pattern.")
+    .def_property_readonly("chunksize", [](const SparseMatrixSELL<double> & self)
+                           { return SparseMatrixSELL<double>::GetChunkSize(); })
+    .def_property_readonly("nze_padded", &SparseMatrixSELL<double>::NZEPadded)
+    ;
+
   
   py::class_<BaseBlockJacobiPrecond, shared_ptr<BaseBlockJacobiPrecond>, BaseMatrix>
     (m, "BlockSmoother",
@@ -1329,6 +1553,12 @@ inverse : string
            self.Smooth (u, y /* this is not needed */, y);
          }, py::call_guard<py::gil_scoped_release>(),
          "perform smoothing step (needs non-symmetric storage so symmetric sparse matrix)")
+    .def("Refactor", [] (SparseFactorization & self, shared_ptr<BaseSparseMatrix> mat)
+         {
+           self.Refactor (mat);
+         }, py::arg("mat"), py::call_guard<py::gil_scoped_release>(),
+         "numeric factorization of mat, reusing ordering and symbolic factorization.\n"
+         "mat must have the same sparsity pattern as the factorized matrix")
     ;
 
   py::class_<SparseCholesky<double>, shared_ptr<SparseCholesky<double>>, SparseFactorization> (m, "SparseCholesky_d");
@@ -1443,6 +1673,247 @@ precision : float
 maxsteps : int
   input maximal steps. CGSolver stops after this steps.
 
+)raw_string"))
+    ;
+
+  m.def("PipelinedCGSolver", [](shared_ptr<BaseMatrix> mat, shared_ptr<BaseMatrix> pre,
+                                bool printrates, double precision, int maxsteps, bool conjugate)
+        {
+          shared_ptr<KrylovSpaceSolver> solver;
+          if (!mat->IsComplex())
+            solver = make_shared<PipelinedCGSolver<double>> (mat, pre);
+          else if (conjugate)
+            solver = make_shared<PipelinedCGSolver<ComplexConjugate>> (mat, pre);
+          else
+            solver = make_shared<PipelinedCGSolver<Complex>> (mat, pre);
+          solver->SetPrecision(precision);
+          solver->SetMaxSteps(maxsteps);
+          solver->SetPrintRates (printrates);
+          return solver;
+        },
+        py::arg("mat"), py::arg("pre"), py::arg("printrates")=true,
+        py::arg("precision")=1e-8, py::arg("maxsteps")=200, py::arg("conjugate")=false,
+        docu_string(R"raw_string(
+A pipelined CG Solver (Ghysels-Vanroose). The two inner products
+of an iteration are combined into one non-blocking reduction,
+which overlaps with the preconditioner and the matrix-vector product.
+
+Parameters:
+
+mat : ngsolve.la.BaseMatrix
+  input matrix
+
+pre : ngsolve.la.BaseMatrix
+  input preconditioner matrix
+
+printrates : bool
+  input printrates
+
+precision : float
+  input requested precision. Solver stops if precision is reached.
+
+maxsteps : int
+  input maximal steps. Solver stops after this steps.
+
+conjugate : bool
+  use the Hermitian inner product for complex matrices
+
+)raw_string"))
+    ;
+
+  m.def("SStepCGSolver", [](shared_ptr<BaseMatrix> mat, shared_ptr<BaseMatrix> pre, int s,
+                            bool printrates, double precision, int maxsteps, bool conjugate)
+        {
+          shared_ptr<KrylovSpaceSolver> solver;
+          if (!mat->IsComplex())
+            {
+              auto ssolver = make_shared<SStepCGSolver<double>> (mat, pre);
+              ssolver->SetS(s);
+              solver = ssolver;
+            }
+          else if (conjugate)
+            {
+              auto ssolver = make_shared<SStepCGSolver<ComplexConjugate>> (mat, pre);
+              ssolver->SetS(s);
+              solver = ssolver;
+            }
+          else
+            {
+              auto ssolver = make_shared<SStepCGSolver<Complex>> (mat, pre);
+              ssolver->SetS(s);
+              solver = ssolver;
+            }
+          solver->SetPrecision(precision);
+          solver->SetMaxSteps(maxsteps);
+          solver->SetPrintRates (printrates);
+          return solver;
+        },
+        py::arg("mat"), py::arg("pre"), py::arg("s")=4, py::arg("printrates")=true,
+        py::arg("precision")=1e-8, py::arg("maxsteps")=200, py::arg("conjugate")=false,
+        docu_string(R"raw_string(
+An s-step CG Solver. s CG steps are performed with a single global reduction.
+
+Parameters:
+
+mat : ngsolve.la.BaseMatrix
+  input matrix
+
+pre : ngsolve.la.BaseMatrix
+  input preconditioner matrix
+
+s : int
+  number of steps per block, small values (up to 5) are recommended
+
+printrates : bool
+  input printrates
+
+precision : float
+  input requested precision. Solver stops if precision is reached.
+
+maxsteps : int
+  input maximal steps. Solver stops after this steps.
+
+conjugate : bool
+  use the Hermitian inner product for complex matrices
+
+)raw_string"))
+    ;
+
+  m.def("SStepGMRESSolver", [](shared_ptr<BaseMatrix> mat, shared_ptr<BaseMatrix> pre, int s,
+                               bool printrates, double precision, int maxsteps)
+        {
+          shared_ptr<KrylovSpaceSolver> solver;
+          if (!mat->IsComplex())
+            {
+              auto ssolver = make_shared<SStepGMRESSolver<double>> (mat, pre);
+              ssolver->SetS(s);
+              solver = ssolver;
+            }
+          else
+            {
+              auto ssolver = make_shared<SStepGMRESSolver<Complex>> (mat, pre);
+              ssolver->SetS(s);
+              solver = ssolver;
+            }
+          solver->SetPrecision(precision);
+          solver->SetMaxSteps(maxsteps);
+          solver->SetPrintRates (printrates);
+          return solver;
+        },
+        py::arg("mat"), py::arg("pre"), py::arg("s")=4, py::arg("printrates")=true,
+        py::arg("precision")=1e-8, py::arg("maxsteps")=200,
+        docu_string(R"raw_string(
+An s-step (communication avoiding) GMRES Solver. Blocks of s Krylov vectors
+are orthonormalized with a single global reduction.
+
+Parameters:
+
+mat : ngsolve.la.BaseMatrix
+  input matrix
+
+pre : ngsolve.la.BaseMatrix
+  input preconditioner matrix
+
+s : int
+  number of Krylov vectors per block, small values (up to 5) are recommended
+
+printrates : bool
+  input printrates
+
+precision : float
+  input requested precision. Solver stops if precision is reached.
+
+maxsteps : int
+  input maximal steps, equals the maximal dimension of the Krylov space.
+
+)raw_string"))
+    ;
+
+  m.def("BlockCGSolver", [](shared_ptr<BaseMatrix> mat, shared_ptr<BaseMatrix> pre,
+                            bool printrates, double precision, int maxsteps, bool conjugate)
+        {
+          shared_ptr<KrylovSpaceSolver> solver;
+          if (!mat->IsComplex())
+            solver = make_shared<BlockCGSolver<double>> (mat, pre);
+          else if (conjugate)
+            solver = make_shared<BlockCGSolver<ComplexConjugate>> (mat, pre);
+          else
+            solver = make_shared<BlockCGSolver<Complex>> (mat, pre);
+          solver->SetPrecision(precision);
+          solver->SetMaxSteps(maxsteps);
+          solver->SetPrintRates (printrates);
+          return solver;
+        },
+        py::arg("mat"), py::arg("pre"), py::arg("printrates")=true,
+        py::arg("precision")=1e-8, py::arg("maxsteps")=200, py::arg("conjugate")=false,
+        docu_string(R"raw_string(
+A block CG Solver for several right-hand sides. Applied to a MultiVector,
+matrix and preconditioner act on all vectors at once:
+
+  sol.data = inv * rhs
+
+Parameters:
+
+mat : ngsolve.la.BaseMatrix
+  input matrix
+
+pre : ngsolve.la.BaseMatrix
+  input preconditioner matrix
+
+printrates : bool
+  input printrates
+
+precision : float
+  input requested precision, for every right-hand side.
+
+maxsteps : int
+  input maximal steps. Solver stops after this steps.
+
+conjugate : bool
+  use the Hermitian inner product for complex matrices
+
+)raw_string"))
+    ;
+
+  m.def("BlockGMRESSolver", [](shared_ptr<BaseMatrix> mat, shared_ptr<BaseMatrix> pre,
+                               bool printrates, double precision, int maxsteps)
+        {
+          shared_ptr<KrylovSpaceSolver> solver;
+          if (!mat->IsComplex())
+            solver = make_shared<BlockGMRESSolver<double>> (mat, pre);
+          else
+            solver = make_shared<BlockGMRESSolver<Complex>> (mat, pre);
+          solver->SetPrecision(precision);
+          solver->SetMaxSteps(maxsteps);
+          solver->SetPrintRates (printrates);
+          return solver;
+        },
+        py::arg("mat"), py::arg("pre"), py::arg("printrates")=true,
+        py::arg("precision")=1e-8, py::arg("maxsteps")=200,
+        docu_string(R"raw_string(
+A block GMRES Solver for several right-hand sides, to be applied to a MultiVector.
+Zero or linearly dependent right-hand sides, and directions where the
+block Krylov space loses rank, are deflated: the blocks shrink, and the
+iteration stops when the space becomes invariant. A zero right-hand side
+gives a zero solution.
+
+Parameters:
+
+mat : ngsolve.la.BaseMatrix
+  input matrix
+
+pre : ngsolve.la.BaseMatrix
+  input preconditioner matrix
+
+printrates : bool
+  input printrates
+
+precision : float
+  input requested precision, for every right-hand side.
+
+maxsteps : int
+  input maximal number of block steps, each one extends the Krylov space by one vector per right-hand side.
+
 )raw_string"))
     ;
 
@@ -1626,6 +2097,58 @@ vecs : list
 shift : object
   complex or real shift
 )raw_string"));
+
+  m.def("LOBPCGSolver", [](shared_ptr<BaseMatrix> mata, shared_ptr<BaseMatrix> matm,
+                           shared_ptr<BaseMatrix> pre, MultiVector & vecs,
+                           shared_ptr<BitArray> freedofs, double tol, int maxsteps,
+                           bool initialize, bool printrates)
+        {
+          LOBPCG lobpcg (mata, matm, pre, freedofs);
+          lobpcg.SetPrecision (tol);
+          lobpcg.SetMaxSteps (maxsteps);
+          lobpcg.SetPrintRates (printrates);
+          return lobpcg.Calc (vecs, initialize);
+        },
+        py::arg("mata"), py::arg("matm"), py::arg("pre"), py::arg("vecs"),
+        py::arg("freedofs")=nullptr, py::arg("tol")=1e-8, py::arg("maxsteps")=200,
+        py::arg("initialize")=true, py::arg("printrates")=false,
+        py::call_guard<py::gil_scoped_release>(),
+        docu_string(R"raw_string(
+LOBPCG eigenvalue solver
+
+Computes the len(vecs) smallest eigenvalues of the real symmetric EVP 
+A*u = M*lam*u. Converged eigenvectors are soft-locked, and all inner 
+products of a block are computed with a single reduction.
+
+Parameters:
+
+mata : ngsolve.la.BaseMatrix
+  matrix A
+
+matm : ngsolve.la.BaseMatrix
+  matrix M, identity if None
+
+pre : ngsolve.la.BaseMatrix
+  preconditioner for A, or None
+
+vecs : ngsolve.la.MultiVector
+  eigenvectors, initial guess if initialize is False
+
+freedofs : nsolve.ngstd.BitArray
+  correct degrees of freedom
+
+tol : float
+  relative residual for convergence
+
+maxsteps : int
+  maximal number of iterations
+
+initialize : bool
+  start from random vectors
+
+printrates : bool
+  print iteration history
+)raw_string"));
   
   
 
@@ -136,100 +136,111 @@ namespace ngla
 
     int printstat = 0;
     
-    if (printstat)
-      cout << IM(4) << "Minimal degree ordering: N = " << n << endl;
-    
     clock_t starttime, endtime;
     starttime = clock();
-    
-    mdo = new MinimumDegreeOrdering (n);
 
-    if (inner)
-      ParallelFor (n, [&] (size_t i)
-                   {
-                     if (!inner->Test(i))
-                       mdo->SetUnusedVertex(i);
-                   });
-    if (cluster)
-      for (int i = 0; i < n; i++)
-        if (!(*cluster)[i])
-          mdo->SetUnusedVertex(i);
+    auto is_used = [&] (int i)
+      {
+        if (inner && !inner->Test(i)) return false;
+        if (cluster && !(*cluster)[i]) return false;
+        return true;
+      };
     
-
+    // the edge i-col enters the elimination graph
+    auto is_coupling = [&] (int i, int col)
+      {
+        if (inner) return inner->Test(i) && inner->Test(col);
+        if (cluster) return (*cluster)[i] == (*cluster)[col] && (*cluster)[i] != 0;
+        return true;
+      };
     
-    if (!inner && !cluster)
-      for (int i = 0; i < n; i++)
-	for (int j = 0; j < a.GetRowIndices(i).Size(); j++)
-	  {
-	    int col = a.GetRowIndices(i)[j];
-	    if (col <= i)
-	      mdo->AddEdge (i, col);
-	  }
-
-    else if (inner)
+    if (a.GetOrderingType() == NESTED_DISSECTION)
       {
+        if (printstat)
+          cout << IM(4) << "Nested dissection ordering: N = " << n << endl;
+        
+        TableCreator<int> creator(n);
+        for ( ; !creator.Done(); creator++)
+          ParallelFor (n, [&] (int i)
+                       {
+                         if (!is_used(i)) return;
+                         for (auto col : a.GetRowIndices(i))
+                           if (col < i && is_used(col) && is_coupling(i, col))
+                             {
+                               creator.Add (i, col);
+                               creator.Add (col, i);
+                             }
+                       });
+        
+        NestedDissectionOrdering nd(creator.MoveTable());
         for (int i = 0; i < n; i++)
-          if (inner->Test(i))
-            for (auto col : a.GetRowIndices(i))
-              if (col <= i)
-                if (inner->Test(col)) //  || i==col)
-                  mdo->AddEdge (i, col);
-            /*
-            for (int j = 0; j < a.GetRowIndices(i).Size(); j++)
-              {
-                int col = a.GetRowIndices(i)[j];
-                if (col <= i)
-                if (inner->Test(col)) //  || i==col)
-                mdo->AddEdge (i, col);
-                }
-            */
+          if (!is_used(i))
+            nd.SetUnusedVertex(i);
+        nd.Order();
+        nused = nd.nused;
+        
+        ta.Start();
+        Allocate (nd.order, nd.structure, nd.blocknr);
+        ta.Stop();
       }
+    else
+      {
+        if (printstat)
+          cout << IM(4) << "Minimal degree ordering: N = " << n << endl;
 
-    else 
-      for (int i = 0; i < n; i++)
-	{
-	  FlatArray<int> row = a.GetRowIndices(i);
-	  for (int j = 0; j < row.Size(); j++)
-	    {
-	      int col = row[j];
-	      if (col <= i)
-		if ( ( ((*cluster)[i] == (*cluster)[col]) && (*cluster)[i]) )
-                  // || i == col )
-		  mdo->AddEdge (i, col);
-	    }
-	}
-    
-    /*
-    for (int i = 0; i < n; i++)
-      if (a.GetPositionTest (i,i) == numeric_limits<size_t>::max())
-	{
-	  mdo->AddEdge (i, i);
-	  *testout << "add unsused position " << i << endl;
-	}
-    */
+        mdo = new MinimumDegreeOrdering (n);
 
-    if (printstat)
-      cout << IM(4) << "start ordering" << endl;
+        ParallelFor (n, [&] (size_t i)
+                     {
+                       if (!is_used(i))
+                         mdo->SetUnusedVertex(i);
+                     });
+
+        for (int i = 0; i < n; i++)
+          if (is_used(i))
+            for (auto col : a.GetRowIndices(i))
+              if (col <= i && is_coupling(i, col))
+                mdo->AddEdge (i, col);
     
-    // mdo -> PrintCliques ();
-    mdo->Order();
-    nused = mdo->nused;
-    endtime = clock();
-    if (printstat)
-      cout << IM(4) << "ordering time = "
-	   << double (endtime - starttime) / CLOCKS_PER_SEC 
-	   << " secs" << endl;
+        if (printstat)
+          cout << IM(4) << "start ordering" << endl;
     
-    starttime = endtime;
-    
-    if (printstat)
-      cout << IM(4) << "," << flush;
-    ta.Start();
-    Allocate (mdo->order,  mdo->vertices, mdo->blocknr.Data());
-    ta.Stop();
+        mdo->Order();
+        nused = mdo->nused;
 
-    delete mdo;
-    mdo = 0;
+        // column structures of supernode masters in new numbering
+        Array<int> neworder(n);
+        for (int i = 0; i < nused; i++)
+          neworder[mdo->order[i]] = i;
+        
+        TableCreator<int> creator(nused);
+        for ( ; !creator.Done(); creator++)
+          ParallelFor (nused, [&] (int i)
+                       {
+                         if (mdo->blocknr[i] != i) return;
+                         auto & v = mdo->vertices[mdo->order[i]];
+                         for (int j = 0; j < v.nconnected; j++)
+                           creator.Add (i, neworder[v.connected[j]]);
+                       });
+        Table<int> structure = creator.MoveTable();
+        ParallelFor (nused, [&] (int i)
+                     {
+                       QuickSort (structure[i]);
+                     });
+        
+        endtime = clock();
+        if (printstat)
+          cout << IM(4) << "ordering time = "
+               << double (endtime - starttime) / CLOCKS_PER_SEC 
+               << " secs" << endl;
+        
+        ta.Start();
+        Allocate (mdo->order, structure, mdo->blocknr);
+        ta.Stop();
+        
+        delete mdo;
+        mdo = 0;
+      }
 
     diag.SetSize(nused);
     // lfact.SetSize (nze);
@@ -288,17 +299,23 @@ namespace ngla
   
 
   
+  /*
+    Supernodes from the ordering are amalgamated: a block is merged with
+    the following block if the parent of its last column lies in there.
+    The structure of the merged block is the structure of the parent block,
+    i.e. explicit zeros are stored. The number of zeros is limited by
+    relaxation parameters as in 
+
+    Ashcraft, Grimes: The influence of relaxed supernode partitions
+    on the multifrontal method, ACM TOMS 15, 1989
+  */
   template <class TM>
   void SparseCholeskyTM<TM> :: 
   Allocate (const Array<int> & aorder, 
-	    // const Array<CliqueEl*> & cliques,
-	    const Array<MDOVertex> & vertices,
-	    const int * in_blocknr)
+            const Table<int> & structure,
+            FlatArray<int> in_blocknr)
   {
-    int n = aorder.Size();
-
-    order.SetSize (n);
-    blocknrs.SetSize (nused);
+    order.SetSize (height);
     
     // order: now inverse map
     ParallelForRange (order.Size(), [&] (IntRange r)
@@ -309,97 +326,116 @@ namespace ngla
       order[aorder[i]] = i;
 
     inv_order.SetSize(nused);
-    inv_order = aorder;
-    
     for (int i = 0; i < nused; i++)
-      blocknrs[i] = in_blocknr[i];
+      inv_order[i] = aorder[i];
 
-    long int cnt = 0;
-    long int cnt_master = 0;
+    for (int i = 1; i < nused; i++)
+      if (in_blocknr[i] < in_blocknr[i-1])
+        throw Exception ("blocknrs are unordered !!");
 
+    // supernodes provided by the ordering
+    Array<int> fblocks;
     for (int i = 0; i < nused; i++)
+      if (in_blocknr[i] == i)
+        fblocks.Append (i);
+    fblocks.Append (nused);
+
+    // structure of fundamental block behind its own dofs
+    auto fext = [&] (int fb) -> FlatArray<int>
+      {
+        auto s = structure[fblocks[fb]];
+        int skip = fblocks[fb+1]-fblocks[fb]-1;
+        return s.Range(skip, s.Size());
+      };
+
+    // relaxed amalgamation
+    Array<int> ext_of_block;       // fundamental block providing the structure
+    size_t zeros = 0;
+    blocks.SetSize0();
+    for (int fb = 0; fb+1 < fblocks.Size(); fb++)
       {
-	cnt += vertices[aorder[blocknrs[i]]].nconnected - (i-blocknrs[i]);
-	if (blocknrs[i] == i)
-	  cnt_master += vertices[aorder[i]].nconnected;
+        if (blocks.Size())
+          {
+            auto cur_ext = fext(ext_of_block.Last());
+            auto fb_ext = fext(fb);
+            size_t cur_size = fblocks[fb] - blocks.Last();
+            size_t fb_size = fblocks[fb+1] - fblocks[fb];
+            
+            // parent of the current block is in block fb
+            if (cur_ext.Size() && cur_ext[0] < fblocks[fb+1])
+              {
+                size_t new_zeros = zeros + cur_size * (fb_size + fb_ext.Size() - cur_ext.Size());
+                size_t new_size = cur_size + fb_size;
+                size_t new_entries = new_size*(new_size+1)/2 + new_size*fb_ext.Size();
+                double frac = double(new_zeros) / new_entries;
+                
+                bool merge = (new_zeros == zeros) || (new_size <= 4) ||
+                  (new_size <= 16 && frac < 0.8) ||
+                  (new_size <= 48 && frac < 0.1) ||
+                  (frac < 0.05);
+                
+                if (merge)
+                  {
+                    ext_of_block.Last() = fb;
+                    zeros = new_zeros;
+                    continue;
+                  }
+              }
+          }
+        blocks.Append (fblocks[fb]);
+        ext_of_block.Append (fb);
+        zeros = 0;
       }
+    if (blocks.Size() == 0)
+      blocks.Append (0);
+    else
+      blocks.Append (nused);
 
-    nze = cnt;
-
-    if (n > 2000)
-      cout << IM(4) << " " << cnt*sizeof(TM)+cnt_master*sizeof(int) << " Bytes " << flush;
-    //cout << IM(4) <<"(cnt="<<cnt<<", sizeof(TM)="<<sizeof(TM)<< ", cnt_master=" << cnt_master << ", sizeof(int)=" << sizeof(int) <<") " << flush;
-
-
-    /* 
-     *testout << " Sparse Cholesky mem needed " << double(cnt*sizeof(TM)+cnt_master*sizeof(int))*1e-6 << " MBytes " << endl; 
-     */  
+    blocknrs.SetSize (nused);
+    for (int b = 0; b+1 < blocks.Size(); b++)
+      blocknrs.Range(blocks[b], blocks[b+1]) = blocks[b];
 
+    
     firstinrow.SetSize(nused+1);
     firstinrow_ri.SetSize(nused+1);
-    rowindex2.SetSize (cnt_master);
-
 
-    cnt = 0;
-    cnt_master = 0;
+    size_t cnt = 0;
+    size_t cnt_master = 0;
     maxrow = 0;
 
-    for (int i = 0; i < nused; i++)
+    for (int b = 0; b+1 < blocks.Size(); b++)
       {
-	firstinrow[i] = cnt;
-	int ii = aorder[i];
-	int ncon = vertices[ii].nconnected;
-
-	if (blocknrs[i] == i)
-	  {
-	    firstinrow_ri[i] = cnt_master;
-
-	    for (int j = 0; j < ncon; j++)
-	      rowindex2[firstinrow_ri[i]+j] = order[vertices[ii].connected[j]];
-
-	    // QuickSort (FlatArray<int> (ncon, &rowindex2[firstinrow_ri[i]]));
-            QuickSort (rowindex2.Part(firstinrow_ri[i], ncon));   // fixes pathologic case with ncon = 0
-
-	    cnt_master += ncon;
-	    cnt += ncon;
-	    maxrow = max2 (maxrow, ncon+1);
-	  }
-	else
-	  {
-	    firstinrow_ri[i] = firstinrow_ri[i-1]+1;
-	    cnt += firstinrow[i]-firstinrow[i-1]-1;
-	  }
+        int first = blocks[b], next = blocks[b+1];
+        int next_size = fext(ext_of_block[b]).Size();
+        int ncon = next-first-1 + next_size;
+        
+        for (int i = first; i < next; i++)
+          {
+            firstinrow[i] = cnt;
+            firstinrow_ri[i] = cnt_master + (i-first);
+            cnt += next-i-1 + next_size;
+          }
+        cnt_master += ncon;
+        maxrow = max2 (maxrow, ncon+1);
       }
-
     firstinrow[nused] = cnt;
     firstinrow_ri[nused] = cnt_master;
+    nze = cnt;
     
-    
-    for (int i = 1; i < blocknrs.Size(); i++)
-      if (blocknrs[i] < blocknrs[i-1])
-        throw Exception ("blocknrs are unordered !!");
-    /*
-    for (int i = 1; i < blocknrs.Size(); i++)
-      {
-        if (blocknrs[i] < blocknrs[i-1]) blocknrs[i] = blocknrs[i-1];
-        // limit blocksize (to 256) for better granularity in solve-phase
-        if (blocknrs[i] <= i-256) blocknrs[i] = i;
-      }
-
-    // cout << "finding block-dependeny ... " << endl;
-    for (int i = 0; i < nused; i++)
-      if(blocknrs[i] == i) blocks.Append(i);
-    blocks.Append(nused);
-    */
-    
-    blocks.Append(0);
-    for (int i = 1; i < nused; i++)
-      if (blocknrs[i] == i)  //  || i >= blocks.Last()+256) // don't subdivide, for this we have the micro-blocks
-        blocks.Append (i);
-    if (nused > 0)
-      blocks.Append(nused);
-
+    if (height > 2000)
+      cout << IM(4) << " " << cnt*sizeof(TM)+cnt_master*sizeof(int) << " Bytes " << flush;
 
+    rowindex2.SetSize (cnt_master);
+    ParallelFor (blocks.Size()-1, [&] (int b)
+                 {
+                   int first = blocks[b], next = blocks[b+1];
+                   auto ri = rowindex2.Range(firstinrow_ri[first], firstinrow_ri[next]);
+                   for (int i = first+1; i < next; i++)
+                     ri[i-first-1] = i;
+                   auto ext = fext(ext_of_block[b]);
+                   for (auto j : Range(ext))
+                     ri[next-first-1+j] = ext[j];
+                 });
     
     // find block dependency
     Array<int> block_of_dof(nused);
@@ -521,10 +557,7 @@ namespace ngla
     static Timer tf("SparseCholesky - fill factor");
     tf.Start();
     if ( height != a.Height() )
-      {
-	cout << IM(4) << "SparseCholesky::FactorNew called with matrix of different size." << endl;
-	return;
-      }
+      throw Exception ("SparseCholesky::FactorNew called with matrix of different size");
     lfact = TM(0.0);
 
     if (!inner && !cluster)
@@ -955,7 +988,8 @@ namespace ngla
     // #define CHOLESKY_ORIGINAL
     // #define CHOLESKY_SIMPLE
     // #define CHOLESKY_PARALLEL
-#define CHOLESKY_PARALLEL_ATOMIC
+    // #define CHOLESKY_PARALLEL_ATOMIC
+#define CHOLESKY_LEFT_LOOKING
 
     
 #ifdef CHOLESKY_ORIGINAL
@@ -1466,6 +1500,130 @@ namespace ngla
 #endif
 
 
+
+#ifdef CHOLESKY_LEFT_LOOKING
+
+    /*
+      supernodal left-looking:
+      a block collects the updates from all blocks coupling to it, 
+      and then factors its own panel. Only the block writes into
+      its columns, no locks on the factor are needed.
+     */
+    
+    // blocks sending updates to the block
+    TableCreator<int> creator_trans(block_dependency.Size());
+    for ( ; !creator_trans.Done(); creator_trans++)
+      ParallelFor (block_dependency.Size(), [&] (int i)
+                   {
+                     for (int j : block_dependency[i])
+                       creator_trans.Add(j, i);
+                   });
+    auto block_dep_trans = creator_trans.MoveTable();
+
+    static Timer tll_update("SparseCholesky::Factor SPD - panel updates", 2);
+    static Timer tll_factor("SparseCholesky::Factor SPD - panel factor", 2);
+    
+    auto hdiag = diag.Addr(0);
+    
+    RunParallelDependency
+      (block_dependency, block_dep_trans, [&] (int blocknr)
+       {
+        IntRange block = BlockDofs(blocknr);
+        size_t i1 = block.First();
+        size_t mi = block.Size();
+        size_t nk = hfirstinrow[i1+1] - hfirstinrow[i1] + 1;
+        auto ext = BlockExtDofs(blocknr);
+
+        // the panel: columns of the block, rows of the block and the external dofs
+        ArrayMem<TM,1000> panelmem(nk*mi);
+        FlatMatrix<TM,ColMajor> panel(nk, mi, panelmem.Addr(0));
+        panel = TM(0.0);
+	for (size_t j = 0; j < mi; j++)
+	  {
+            panel(j,j) = hdiag[i1+j];
+            panel.Col(j).Range(j+1,nk) = FlatVector<TM>(nk-j-1, hlfact+hfirstinrow[i1+j]);
+          }
+
+        MyMutex panel_lock;
+        auto update_from = [&] (int kblock)
+          {
+            ThreadRegionTimer reg(tll_update, TaskManager::GetThreadId());
+            IntRange kdofs = BlockDofs(kblock);
+            int k1 = kdofs.First();
+            int mk = kdofs.Size();
+            auto kext = BlockExtDofs(kblock);
+
+            // rows of kext belonging to the block, and below
+            int * pkext = kext.Addr(0);
+            size_t p0 = std::lower_bound (pkext, pkext+kext.Size(), int(i1)) - pkext;
+            size_t p1 = std::lower_bound (pkext+p0, pkext+kext.Size(), int(i1+mi)) - pkext;
+            size_t m = kext.Size()-p0;
+            size_t w = p1-p0;
+
+            // gather (L D)_K of these rows
+            ArrayMem<TM,1000> wmem(m*mk);
+            FlatMatrix<TM,ColMajor> wk(m, mk, wmem.Addr(0));
+            for (int c = 0; c < mk; c++)
+              wk.Col(c) = FlatVector<TM>(m, hlfact+hfirstinrow[k1+c]+(mk-1-c)+p0);
+            
+            ArrayMem<TM,1000> umem(m*w);
+            FlatMatrix<TM,ColMajor> upd(m, w, umem.Addr(0));
+            upd = TM(0.0);
+            MySubADBt<TM,ColMajor> (wk, FlatVector<TM>(mk, hdiag+k1), wk.Rows(0,w), upd, false);
+
+            // position of rows in the panel
+            ArrayMem<int,100> relind(m);
+            size_t pos = 0;
+            for (size_t r = 0; r < m; r++)
+              {
+                int row = kext[p0+r];
+                if (size_t(row) < i1+mi)
+                  relind[r] = row-i1;
+                else
+                  {
+                    while (ext[pos] != row) pos++;
+                    relind[r] = mi+pos;
+                  }
+              }
+
+            panel_lock.lock();
+            for (size_t c = 0; c < w; c++)
+              {
+                int col = relind[c];
+                for (size_t r = c; r < m; r++)
+                  panel(relind[r], col) += upd(r,c);
+              }
+            panel_lock.unlock();
+          };
+
+        auto updaters = block_dep_trans[blocknr];
+        if (updaters.Size() > 8 && nk*mi > 10000)
+          ParallelFor (updaters.Size(), [&] (size_t k)
+                       {
+                         update_from (updaters[k]);
+                       });
+        else
+          for (int k : updaters)
+            update_from (k);
+
+        auto A11 = panel.Rows(0,mi).Cols(0,mi);
+        auto B   = panel.Rows(mi,nk).Cols(0,mi);
+        {
+          ThreadRegionTimer reg(tll_factor, TaskManager::GetThreadId());
+          CalcLDL (A11);
+          if (mi < nk)
+            CalcLDL_SolveL (A11,B);
+        }
+        
+	for (size_t j = 0; j < mi; j++)
+	  {
+            hdiag[i1+j] = A11(j,j);
+            FlatVector<TM>(nk-j-1, hlfact+hfirstinrow[i1+j]) = panel.Col(j).Range(j+1,nk);
+          }
+       });
+#endif
+
+
     
     
     
@@ -2018,6 +2176,19 @@ namespace ngla
 
 
 
+  static size_t GraphHash (const BaseSparseMatrix & a)
+  {
+    size_t hash = a.Height();
+    for (size_t i = 0; i < a.Height(); i++)
+      {
+        auto ind = a.GetRowIndices(i);
+        hash = hash * 1000003 ^ ind.Size();
+        for (int col : ind)
+          hash = hash * 1000003 ^ size_t(col);
+      }
+    return hash;
+  }
+
   SparseFactorization ::     
   SparseFactorization (const BaseSparseMatrix & amatrix,
 		       shared_ptr<BitArray> ainner,
@@ -2025,6 +2196,7 @@ namespace ngla
     : matrix(const_cast<BaseSparseMatrix&>(amatrix).SharedFromThis<BaseSparseMatrix>()),
       inner(ainner), cluster(acluster)
   { 
+    graph_hash = GraphHash (amatrix);
     smooth_is_projection = true;
     if (cluster)
       {
@@ -2046,6 +2218,24 @@ namespace ngla
   }
   
   
+  bool SparseFactorization :: SameGraph (const BaseSparseMatrix & a) const
+  {
+    auto mat = matrix.lock();
+    if (mat.get() == &a) return true;
+    return GraphHash(a) == graph_hash;
+  }
+
+  void SparseFactorization :: Refactor (shared_ptr<BaseSparseMatrix> amat)
+  {
+    if (!SupportsUpdate())
+      throw Exception ("SparseFactorization::Refactor: inverse type does not support numeric refactorization");
+    if (!SameGraph (*amat))
+      throw Exception ("SparseFactorization::Refactor: matrix graph has changed");
+    matrix = amat;
+    Update();
+  }
+  
+
   void SparseFactorization  :: 
   Smooth (BaseVector & u, const BaseVector & /* f */, BaseVector & y) const
   {
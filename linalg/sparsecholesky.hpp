@@ -21,6 +21,8 @@ namespace ngla
     shared_ptr<BitArray> inner;
     shared_ptr<const Array<int>> cluster;
     bool smooth_is_projection;
+    /// fingerprint of the factorized matrix graph
+    size_t graph_hash;
 
   public:
     SparseFactorization (const BaseSparseMatrix & amatrix,
@@ -37,7 +39,12 @@ namespace ngla
     bool SmoothIsProjection () const { return smooth_is_projection; }
     
     auto GetAMatrix() const { return matrix.lock(); }
+    /// Update() refactors numerically, keeping ordering and symbolic factorization
     virtual bool SupportsUpdate() const { return false; } 
+    /// can the symbolic factorization be reused for matrix a ?
+    bool SameGraph (const BaseSparseMatrix & a) const;
+    /// numeric factorization of a new matrix with unchanged graph
+    void Refactor (shared_ptr<BaseSparseMatrix> amat);
   };
 
 
@@ -50,7 +57,8 @@ namespace ngla
   /**
      A sparse cholesky factorization.
      The unknowns are reordered by the minimum degree
-     ordering algorithm
+     or the nested dissection ordering algorithm,
+     see BaseSparseMatrix::SetOrderingType
 
      computs A = L D L^t
      L is stored column-wise
@@ -141,8 +149,8 @@ namespace ngla
     int VWidth() const { return height; }
     ///
     void Allocate (const Array<int> & aorder, 
-		   const Array<MDOVertex> & vertices,
-		   const int * blocknr);
+                   const Table<int> & structure,
+                   FlatArray<int> blocknr);
     ///
     void Factor (); 
 #ifdef LAPACK
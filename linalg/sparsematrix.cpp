@@ -1275,6 +1275,21 @@ namespace ngla
       }
     return old_invtype;
   }
+
+  ORDERINGTYPE BaseSparseMatrix ::
+  SetOrderingType (string aorderingtype) const
+  {
+    ORDERINGTYPE old_ordering = orderingtype;
+
+    if      (aorderingtype == "mindegree")         SetOrderingType ( MINIMUM_DEGREE );
+    else if (aorderingtype == "nesteddissection")  SetOrderingType ( NESTED_DISSECTION );
+    else
+      {
+        throw Exception (ToString("undefined ordering ")+aorderingtype+
+                         "\nallowed is: 'mindegree', 'nesteddissection'");
+      }
+    return old_ordering;
+  }
 }
 
 
@@ -1562,338 +1577,36 @@ namespace ngla
   shared_ptr<BaseSparseMatrix>
   SparseMatrixSymmetric<TM,TV> :: Restrict (const SparseMatrixTM<double> & prol,
 					    shared_ptr<BaseSparseMatrix> acmat ) const
-  {
-    static Timer t ("sparsematrix - restrict");
-    static Timer tbuild ("sparsematrix - restrict, build matrix");
-    static Timer tcomp ("sparsematrix - restrict, compute matrix");
-    RegionTimer reg(t);
-    
-    int n = this->Height();
-
-    auto cmat = dynamic_pointer_cast<SparseMatrixSymmetric<TM,TV>>(acmat);
- 
-    // if no coarse matrix, build up matrix-graph!
-    if ( !cmat )
-      {
-        RegionTimer reg(tbuild);
-
-	Array<int> marks(n);
-	Array<INT<2> > e2v;
-	for (int i = 0; i < n; i++)
-	  for (int j = 0; j < this->GetRowIndices(i).Size(); j++)
-	    {
-	      int col = this->GetRowIndices(i)[j];
-	      FlatArray<int> prol_rowind = prol.GetRowIndices(i);
-	      FlatArray<int> prol_colind = prol.GetRowIndices(col);
-
-	      for (int k = 0; k < prol_rowind.Size(); k++)
-		for (int l = 0; l < prol_colind.Size(); l++)
-		  {
-		    int kk = prol_rowind[k];
-		    int ll = prol_colind[l];
-		    
-		    if (kk >= ll) swap (kk,ll);
-		    e2v.Append (INT<2> (kk,ll));
-		  }
-	    }
-
-	int nc = 0;
-	for (int i = 0; i < e2v.Size(); i++)
-	  nc = max2 (nc, e2v[i][1]);
-	nc++;
-
-	// *testout << "e2v = " << endl << e2v << endl;
-        
-        // count all entries in row with multiplicity
-	Array<int> cnt(nc);
-	cnt = 0;
-	for (int i = 0; i < e2v.Size(); i++)
-	  cnt[e2v[i][1]]++;
-
-	Table<int> v2e(cnt);
-	cnt = 0;
-	for (int i = 0; i < e2v.Size(); i++)
-	  {
-	    int v1 = e2v[i][1];
-	    v2e[v1][cnt[v1]++] = i;
-	  }
-	
-	cnt = 0;
-	marks = -1;
-
-        // count all entries in row withOUT multiplicity
-	for (int i = 0; i < nc; i++)
-	  for (int j = 0; j < v2e[i].Size(); j++)
-	    {
-	      int jj = v2e[i][j];
-	      int v0 = e2v[jj][0];
-	      if (marks[v0] != i) 
-		{
-		  cnt[i]++;
-		  marks[v0] = i;
-		}
-	    }
-
-	cmat = make_shared<SparseMatrixSymmetric<TM,TV>> (cnt);
-
-	marks = -1;
-	for (int i = 0; i < nc; i++)
-	  for (int j = 0; j < v2e[i].Size(); j++)
-	    {
-	      int jj = v2e[i][j];
-	      int v0 = e2v[jj][0];
-	      if (marks[v0] != i) 
-		{
-		  marks[v0] = i;
-		  cmat -> CreatePosition (i, v0);
-		}
-	    }
-      }
-
-    *cmat = 0.;
-    RegionTimer reg2(tcomp);
-	  
-    for (int i = 0; i < n; i++)
-      {
-        FlatArray<int> mat_ri = this->GetRowIndices(i);
-        FlatVector<TM> mat_rval = this->GetRowValues(i);
-
-        for (int j = 0; j < mat_ri.Size(); j++)
-          {
-            int col = mat_ri[j];
-            TM mat_val = mat_rval[j]; 
-
-            FlatArray<int> prol_ri_i = prol.GetRowIndices(i);
-            FlatArray<int> prol_ri_col = prol.GetRowIndices(col);
-            FlatVector<double> prol_rval_i = prol.GetRowValues(i);
-            FlatVector<double> prol_rval_col = prol.GetRowValues(col);
-
-            for (int k = 0; k < prol_ri_i.Size(); k++)
-              for (int l = 0; l < prol_ri_col.Size(); l++)
-                {
-                  int kk = prol_ri_i[k];
-                  int ll = prol_ri_col[l];
-                  
-                  if ( kk>=ll && kk < cmat->Height() )
-                    {
-                      (*cmat)(kk,ll) += 
-                        prol_rval_i[k] * prol_rval_col[l] * mat_val; 
-                    }
-                  
-                  if (ll >= kk && i != col && ll < cmat->Height() )
-                    {
-                      (*cmat)(ll,kk) += 
-                        prol_rval_col[l] * prol_rval_i[k] * Trans(mat_val); 
-                    }
-                  
-                }
-          }
-      }
-    return cmat;
-  }
-  
-
-
-
-  template <> shared_ptr<BaseSparseMatrix>
-  SparseMatrix<double> :: Restrict (const SparseMatrixTM<double> & prol,
-                                    shared_ptr<BaseSparseMatrix> acmat ) const
-  {
-    static Timer t ("sparsematrix - restrict");
-    RegionTimer reg(t);
-
-    // auto prolT = TransposeMatrix(prol);
-    auto prolT = dynamic_pointer_cast<SparseMatrixTM<double>> (prol.CreateTranspose());
-
-    auto prod1 = MatMult<double, double, double>(*this, prol);
-    auto prod = MatMult<double, double, double>(*prolT, *prod1);
-    return prod;
-  }
-
-  template <> shared_ptr<BaseSparseMatrix>
-  SparseMatrix<std::complex<double>> :: Restrict (const SparseMatrixTM<double> & prol,
-                                                  shared_ptr<BaseSparseMatrix> acmat ) const
-  {
-    static Timer t ("sparsematrix - restrict");
-    RegionTimer reg(t);
-    // new version
-    // auto prolT = TransposeMatrix(prol);
-    auto prolT = dynamic_pointer_cast<SparseMatrixTM<double>> (prol.CreateTranspose());
-    
-    auto prod1 = MatMult<std::complex<double>, std::complex<double>, double>(*this, prol);
-    auto prod = MatMult<std::complex<double>, double, std::complex<double>>(*prolT, *prod1);
-    return prod;
-  }
-
-
-
-
-
-  template <> shared_ptr<BaseSparseMatrix>
-  SparseMatrixSymmetric<double,double> :: Restrict (const SparseMatrixTM<double> & prol,
-                                                    shared_ptr<BaseSparseMatrix> acmat ) const
   {
     static Timer t ("sparsematrixsymmetric - restrict");
     RegionTimer reg(t);
-    // new version
-    // auto prolT = TransposeMatrix(prol);
-    auto prolT = dynamic_pointer_cast<SparseMatrixTM<double>> (prol.CreateTranspose());    
-    auto full = MakeFullMatrix(*this);
-
-    auto prod1 = MatMult<double, double, double>(*full, prol);
-    auto prod = MatMult<double, double, double>(*prolT, *prod1);
-
-    auto prodhalf = GetSymmetricMatrix (*prod);
-    return prodhalf;
-
-
-#ifdef OLD
-
-    static Timer t ("sparsematrix - restrict");
-    static Timer tbuild ("sparsematrix - restrict, build matrix");
-    static Timer tbuild1 ("sparsematrix - restrict, build matrix1");
-    static Timer tbuild2 ("sparsematrix - restrict, build matrix2");
-    static Timer tbuild3 ("sparsematrix - restrict, build matrix3");
-    static Timer tbuild4 ("sparsematrix - restrict, build matrix4");
-    static Timer tcomp ("sparsematrix - restrict, compute matrix");
-    RegionTimer reg(t);
-    
-    int n = this->Height();
-
-    SparseMatrixSymmetric<double,double>* cmat = 
-      dynamic_cast< SparseMatrixSymmetric<double,double>* > ( acmat );
- 
-    // if no coarse matrix, build up matrix-graph!
-    if ( !cmat )
-      {
-        RegionTimer reg(tbuild);
-        tbuild1.Start();
-	Array<INT<2> > e2v;
-	for (int i = 0; i < n; i++)
-	  for (int j = 0; j < this->GetRowIndices(i).Size(); j++)
-	    {
-	      int col = this->GetRowIndices(i)[j];
-
-	      for (int kk : prol.GetRowIndices(i))
-		for (int ll : prol.GetRowIndices(col))
-		  {
-                    /*
-		    if (kk >= ll) swap (kk,ll);
-		    e2v.Append (INT<2> (kk,ll));
-                    */
-                    INT<2> i2 = (kk<ll) ? INT<2>(kk,ll) : INT<2>(ll,kk);
-                    e2v.Append (i2);
-		  }
-	    }
-
-	int nc = 0;
-        for (auto vpair : e2v)
-          nc = max2 (nc, vpair[1]);
-	nc++;
-
-        tbuild1.Stop();
-        tbuild2.Start();
-
-        // count all entries in row with multiplicity
-	Array<int> cnt(nc);
-	cnt = 0;
-	for (int i = 0; i < e2v.Size(); i++)
-	  cnt[e2v[i][1]]++;
-
-	Table<int> v2e(cnt);
-	cnt = 0;
-	for (int i = 0; i < e2v.Size(); i++)
-	  {
-	    int v1 = e2v[i][1];
-	    v2e[v1][cnt[v1]++] = i;
-	  }
 
-        tbuild2.Stop();
-        tbuild3.Start();
-	
-	cnt = 0;
-	Array<int> marks(n);
-	marks = -1;
-
-        // count all entries in row withOUT multiplicity
-	for (int i = 0; i < nc; i++)
-	  for (int j = 0; j < v2e[i].Size(); j++)
-	    {
-	      int jj = v2e[i][j];
-	      int v0 = e2v[jj][0];
-	      if (marks[v0] != i) 
-		{
-		  cnt[i]++;
-		  marks[v0] = i;
-		}
-	    }
-
-        tbuild3.Stop();
-        tbuild4.Start();
-
-	cmat = new SparseMatrixSymmetric<double,double> (cnt);
-
-	marks = -1;
-	for (int i = 0; i < nc; i++)
-	  for (int j = 0; j < v2e[i].Size(); j++)
-	    {
-	      int jj = v2e[i][j];
-	      int v0 = e2v[jj][0];
-	      if (marks[v0] != i) 
-		{
-		  marks[v0] = i;
-		  cmat -> CreatePosition (i, v0);
-		}
-	    }
-
-        tbuild4.Stop();
-      }
-
-    *cmat = 0.;
-    RegionTimer reg2(tcomp);
-
-    // #pragma omp parallel for	  
-    for (int i = 0; i < n; i++)
+    // the upper triangle of row i: (row, position) of the stored transposed entries
+    size_t n = this->Height();
+    TableCreator<INT<2>> creator(n);
+    for ( ; !creator.Done(); creator++)
+      ParallelFor (n, [&] (size_t i)
+                   {
+                     auto cols = this->GetRowIndices(i);
+                     for (size_t k = 0; k < cols.Size(); k++)
+                       if (size_t(cols[k]) != i)
+                         creator.Add (cols[k], INT<2>(int(i), int(k)));
+                   });
+    Table<INT<2>> upper = creator.MoveTable();
+
+    auto arow = [&] (int i, auto func)
       {
-        FlatArray<int> mat_ri = this->GetRowIndices(i);
-        FlatVector<double> mat_rval = this->GetRowValues(i);
-
-        for (int j = 0; j < mat_ri.Size(); j++)
-          {
-            int col = mat_ri[j];
-            double mat_val = mat_rval[j]; 
-
-            FlatArray<int> prol_rowind = prol.GetRowIndices(i);
-            FlatArray<int> prol_colind = prol.GetRowIndices(col);
-            FlatVector<double> prol_rowval = prol.GetRowValues(i);
-            FlatVector<double> prol_colval = prol.GetRowValues(col);
-
-            for (int k = 0; k < prol_rowind.Size(); k++)
-              for (int l = 0; l < prol_colind.Size(); l++)
-                {
-                  int kk = prol_rowind[k];
-                  int ll = prol_colind[l];
-                  
-                  if ( kk>=ll && kk < cmat->Height() )
-                    {
-                      auto val = prol_rowval[k] * prol_colval[l] * mat_val;
-                      // #pragma omp atomic                      
-                      (*cmat)(kk,ll) += val;
-                    }
-                  
-                  if (ll >= kk && i != col && ll < cmat->Height() )
-                    {
-                      auto val = prol_colval[l] * prol_rowval[k] * Trans(mat_val);
-                      // #pragma omp atomic                      
-                      (*cmat)(ll,kk) += val;
-                    }
-                  
-                }
-          }
-      }
-    return cmat;
-#endif
-
+        auto ari = this->GetRowIndices(i);
+        auto arv = this->GetRowValues(i);
+        for (size_t j = 0; j < ari.Size(); j++)
+          func (ari[j], arv[j]);
+        for (auto jk : upper[i])
+          func (jk[0], TM(Trans(this->GetRowValues(jk[0])[jk[1]])));
+      };
+
+    return GalerkinProduct<TM> (arow, prol,
+                                dynamic_pointer_cast<SparseMatrixSymmetric<TM,TV>> (acmat),
+                                true);
   }
 
 
@@ -1902,6 +1615,7 @@ namespace ngla
 
 
 
+
   
 
   template <class TM, class TV>
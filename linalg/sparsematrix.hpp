@@ -167,6 +167,8 @@ namespace ngla
   protected:
     /// sparse direct solver
     mutable INVERSETYPE inversetype = default_inversetype;    // C++11 :-) Windows VS2013
+    /// ordering for sparse cholesky
+    mutable ORDERINGTYPE orderingtype = MINIMUM_DEGREE;
     bool spd = false;
     
   public:
@@ -214,6 +216,11 @@ namespace ngla
       throw Exception ("BaseSparseMatrix::CreateJacobiPrecond");
     }
 
+    /// y += s A x restricted to the given rows, returns false if not supported
+    virtual bool MultAddRows (double s, const BaseVector & x, BaseVector & y,
+                              FlatArray<int> rows) const
+    { return false; }
+
     virtual shared_ptr<BaseBlockJacobiPrecond>
       CreateBlockJacobiPrecond (shared_ptr<Table<int>> blocks,
                                 const BaseVector * constraint = 0,
@@ -259,6 +266,18 @@ namespace ngla
     virtual INVERSETYPE  GetInverseType () const override
     { return inversetype; }
 
+    ORDERINGTYPE SetOrderingType (ORDERINGTYPE aorderingtype) const
+    {
+      ORDERINGTYPE old_ordering = orderingtype;
+      orderingtype = aorderingtype;
+      return old_ordering;
+    }
+
+    ORDERINGTYPE SetOrderingType (string aorderingtype) const;
+
+    ORDERINGTYPE GetOrderingType () const
+    { return orderingtype; }
+
     void SetSPD (bool aspd = true) { spd = aspd; }
     bool IsSPD () const { return spd; }
     virtual size_t NZE () const override { return nze; }
@@ -441,6 +460,10 @@ namespace ngla
     virtual void AddElementMatrixSymmetric(FlatArray<int> dnums,
                                            BareSliceMatrix<TSCAL> elmat,
                                            bool use_atomic = false);
+    /// adds only the rows dnums[i] in rows, for row-owner assembly 
+    void AddElementMatrixSymmetricRows(FlatArray<int> dnums,
+                                       BareSliceMatrix<TSCAL> elmat,
+                                       IntRange rows);
     
 
     virtual void SetZero() override;
@@ -594,11 +617,15 @@ namespace ngla
     virtual void MultConjTransAdd (Complex s, const BaseVector & x, BaseVector & y) const override;
 
     virtual void MultAdd (FlatVector<double> alpha, const MultiVector & x, MultiVector & y) const override;
+    virtual void MultAddInterleaved (double s, SliceMatrix<double> x, SliceMatrix<double> y) const override;
 
     
     virtual void MultAdd1 (double s, const BaseVector & x, BaseVector & y,
 			   const BitArray * ainner = NULL,
 			   const Array<int> * acluster = NULL) const override;
+
+    virtual bool MultAddRows (double s, const BaseVector & x, BaseVector & y,
+                              FlatArray<int> rows) const override;
     
     virtual void DoArchive (Archive & ar) override;
   };
@@ -702,6 +729,16 @@ namespace ngla
       MultAdd (s, x, y);
     }
 
+    virtual void MultAdd (FlatVector<double> alpha, const MultiVector & x, MultiVector & y) const override
+    {
+      BaseMatrix::MultAdd (alpha, x, y);
+    }
+
+    virtual void MultAddInterleaved (double s, SliceMatrix<double> x, SliceMatrix<double> y) const override
+    {
+      BaseMatrix::MultAddInterleaved (s, x, y);
+    }
+
 
     /*
       y += s L * x
@@ -717,6 +754,12 @@ namespace ngla
     virtual void MultAdd2 (double s, const BaseVector & x, BaseVector & y,
 			   const BitArray * ainner = NULL,
 			   const Array<int> * acluster = NULL) const override;
+
+    /*
+      rows of the lower triangle, and their transposed contributions
+    */
+    virtual bool MultAddRows (double s, const BaseVector & x, BaseVector & y,
+                              FlatArray<int> rows) const override;
     
 
 
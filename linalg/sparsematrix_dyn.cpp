@@ -185,4 +185,302 @@ namespace ngla
 
   template class SparseMatrixVariableBlocks<double>;  
 
+
+
+  
+
+  SparseMatrixFloat :: SparseMatrixFloat (const SparseMatrixTM<double> & mat)
+    : BaseSparseMatrix (mat, false)
+  {
+    if (dynamic_cast<const SparseMatrixSymmetric<double>*> (&mat))
+      throw Exception ("SparseMatrixFloat: symmetric storage, use ExpandSymmetric");
+    SetParallelDofs (mat.GetParallelDofs());
+    data.SetSize (nze);
+    auto matvec = mat.GetValues();
+    ParallelForRange (nze, [&] (IntRange r)
+                      {
+                        for (auto i : r)
+                          data[i] = matvec(i);
+                      });
+  }
+  
+  void SparseMatrixFloat :: MultAdd (double s, const BaseVector & x, BaseVector & y) const
+  {
+    static Timer t("SparseMatrixFloat::MultAdd"); RegionTimer reg(t);
+    t.AddFlops (nze);
+
+    ParallelForRange
+      (balance, [&] (IntRange myrange)
+       {
+         FlatVector<double> fx = x.FVDouble();
+         FlatVector<double> fy = y.FVDouble();
+
+         for (auto i : myrange)
+           fy(i) += s * RowTimesVector (i, fx);
+       });
+  }
+
+  void SparseMatrixFloat :: MultTransAdd (double s, const BaseVector & x, BaseVector & y) const
+  {
+    static Timer t("SparseMatrixFloat::MultTransAdd"); RegionTimer reg(t);
+    t.AddFlops (nze);
+
+    FlatVector<double> fx = x.FVDouble();
+    FlatVector<double> fy = y.FVDouble();
+
+    for (int i = 0; i < size; i++)
+      {
+        double hx = s * fx(i);
+        for (size_t j = firsti[i]; j < firsti[i+1]; j++)
+          fy(colnr[j]) += double(data[j]) * hx;
+      }
+  }
+
+  shared_ptr<BaseJacobiPrecond>
+  SparseMatrixFloat :: CreateJacobiPrecond (shared_ptr<BitArray> inner) const
+  {
+    return make_shared<JacobiPrecondFloat> (*this, inner);
+  }
+
+  shared_ptr<BaseBlockJacobiPrecond>
+  SparseMatrixFloat :: CreateBlockJacobiPrecond (shared_ptr<Table<int>> blocks,
+                                                 const BaseVector * constraint,
+                                                 bool parallel,
+                                                 shared_ptr<BitArray> freedofs) const
+  {
+    if (constraint || freedofs)
+      throw Exception ("SparseMatrixFloat::CreateBlockJacobiPrecond: constraint and freedofs not supported");
+    if (parallel && GetParallelDofs())
+      throw Exception ("SparseMatrixFloat::CreateBlockJacobiPrecond: cumulated block diagonals not supported");
+    return make_shared<BlockJacobiPrecondFloat> (*this, blocks);
+  }
+  
+  Array<MemoryUsage> SparseMatrixFloat :: GetMemoryUsage () const
+  {
+    Array<MemoryUsage> mu;
+    mu += { "SparseMatrixFloat", nze*sizeof(float), 1 };
+    mu += MatrixGraph::GetMemoryUsage ();
+    return mu;
+  }
+
+  AutoVector SparseMatrixFloat :: CreateRowVector () const
+  {
+    return make_unique<VVector<double>> (width);
+  }
+
+  AutoVector SparseMatrixFloat :: CreateColVector () const
+  {
+    return make_unique<VVector<double>> (size);
+  }
+  
+
+  template <typename TSCAL>
+  SparseMatrixSELL<TSCAL> ::
+  SparseMatrixSELL (const SparseMatrixTM<TSCAL> & mat, size_t asigma)
+    : height(mat.Height()), width(mat.Width()), nze(mat.NZE()),
+      sigma(max2(asigma, size_t(C)))
+  {
+    static Timer t("SparseMatrixSELL - ctor"); RegionTimer reg(t);
+
+    if (dynamic_cast<const SparseMatrixSymmetric<TSCAL>*> (&mat))
+      throw Exception ("SparseMatrixSELL: symmetric storage, use ExpandSymmetric");
+
+    nchunks = (height+C-1) / C;
+    perm.SetSize (nchunks*C);
+    for (size_t i = 0; i < height; i++)
+      perm[i] = i;
+    for (size_t i = height; i < perm.Size(); i++)
+      perm[i] = -1;
+
+    // sort rows by decreasing length within windows of sigma rows
+    ParallelFor (Range((height+sigma-1)/sigma), [&] (size_t win)
+                 {
+                   auto r = Range(win*sigma, min2(height, (win+1)*sigma));
+                   QuickSort (perm.Range(r), [&mat] (int r1, int r2)
+                              {
+                                size_t l1 = mat.GetRowIndices(r1).Size();
+                                size_t l2 = mat.GetRowIndices(r2).Size();
+                                return (l1 > l2) || (l1 == l2 && r1 < r2);
+                              });
+                 });
+
+    firsti.SetSize (nchunks+1);
+    firsti[0] = 0;
+    for (size_t k = 0; k < nchunks; k++)
+      {
+        size_t maxlen = 0;
+        for (int l = 0; l < C; l++)
+          if (perm[k*C+l] >= 0)
+            maxlen = max2(maxlen, mat.GetRowIndices(perm[k*C+l]).Size());
+        firsti[k+1] = firsti[k] + C*maxlen;
+      }
+
+    colnr.SetSize (firsti[nchunks]);
+    data.SetSize (firsti[nchunks]);
+
+    ParallelForRange
+      (nchunks, [&] (IntRange r)
+       {
+         for (size_t k : r)
+           {
+             size_t len = (firsti[k+1]-firsti[k]) / C;
+             for (int l = 0; l < C; l++)
+               {
+                 int row = perm[k*C+l];
+                 FlatArray<int> cols = (row >= 0) ? mat.GetRowIndices(row) : FlatArray<int>(0, (int*)nullptr);
+                 FlatVector<TSCAL> vals = (row >= 0) ? mat.GetRowValues(row) : FlatVector<TSCAL>(0, (TSCAL*)nullptr);
+                 // padding entries point to a valid column with value 0
+                 int padcol = cols.Size() ? cols[cols.Size()-1] : 0;
+                 for (size_t j = 0; j < len; j++)
+                   {
+                     size_t pos = firsti[k] + j*C + l;
+                     if (j < cols.Size())
+                       {
+                         colnr[pos] = cols[j];
+                         data[pos] = vals(j);
+                       }
+                     else
+                       {
+                         colnr[pos] = padcol;
+                         data[pos] = TSCAL(0);
+                       }
+                   }
+               }
+           }
+       });
+
+    balance.Calc (nchunks, [&] (int k) { return 1 + (firsti[k+1]-firsti[k]); });
+  }
+
+
+  template <typename TSCAL>
+  void SparseMatrixSELL<TSCAL> ::
+  MultAdd (double s, const BaseVector & x, BaseVector & y) const
+  {
+    static Timer t("SparseMatrixSELL::MultAdd"); RegionTimer reg(t);
+    t.AddFlops (nze);
+
+    auto fx = x.FV<TSCAL>();
+    auto fy = y.FV<TSCAL>();
+
+    ParallelForRange
+      (balance, [&] (IntRange r)
+       {
+         for (size_t k : r)
+           {
+             const int * pcol = colnr.Data() + firsti[k];
+             const TSCAL * pval = data.Data() + firsti[k];
+             size_t len = (firsti[k+1]-firsti[k]) / C;
+
+             SIMD<double> sum(0.0);
+             for (size_t j = 0; j < len; j++, pcol += C, pval += C)
+               sum = FMA (SIMD<double>(pval),
+                          SIMD<double>([pcol, fx] (int l) -> double { return fx(pcol[l]); }),
+                          sum);
+
+             const int * prow = &perm[k*C];
+             for (int l = 0; l < C; l++)
+               if (prow[l] >= 0)
+                 fy(prow[l]) += s * sum[l];
+           }
+       });
+  }
+
+
+  template <typename TSCAL>
+  void SparseMatrixSELL<TSCAL> ::
+  MultTransAdd (double s, const BaseVector & x, BaseVector & y) const
+  {
+    static Timer t("SparseMatrixSELL::MultTransAdd"); RegionTimer reg(t);
+    t.AddFlops (nze);
+
+    auto fx = x.FV<TSCAL>();
+    auto fy = y.FV<TSCAL>();
+
+    ParallelForRange
+      (balance, [&] (IntRange r)
+       {
+         for (size_t k : r)
+           {
+             const int * pcol = colnr.Data() + firsti[k];
+             const TSCAL * pval = data.Data() + firsti[k];
+             size_t len = (firsti[k+1]-firsti[k]) / C;
+
+             const int * prow = &perm[k*C];
+             SIMD<double> sx([prow, fx, s] (int l) -> double
+                             { return prow[l] >= 0 ? s*fx(prow[l]) : 0.0; });
+
+             for (size_t j = 0; j < len; j++, pcol += C, pval += C)
+               {
+                 SIMD<double> prod = SIMD<double>(pval) * sx;
+                 for (int l = 0; l < C; l++)
+                   if (prod[l] != 0.0)
+                     AtomicAdd (fy(pcol[l]), prod[l]);
+               }
+           }
+       });
+  }
+
+
+  template <typename TSCAL>
+  Array<MemoryUsage> SparseMatrixSELL<TSCAL> :: GetMemoryUsage () const
+  {
+    return { { "SparseMatrixSELL", data.Size()*sizeof(TSCAL) + colnr.Size()*sizeof(int)
+               + perm.Size()*sizeof(int) + firsti.Size()*sizeof(size_t), 1 } };
+  }
+
+  template <typename TSCAL>  
+  AutoVector SparseMatrixSELL<TSCAL> :: CreateRowVector () const
+  {
+    return CreateBaseVector(width, false, 1);    
+  }
+
+  template <typename TSCAL>  
+  AutoVector SparseMatrixSELL<TSCAL> :: CreateColVector () const
+  {
+    return CreateBaseVector(height, false, 1);        
+  }
+
+  template class SparseMatrixSELL<double>;
+
+
+  shared_ptr<SparseMatrix<double>>
+  ExpandSymmetric (const SparseMatrixSymmetric<double> & mat)
+  {
+    static Timer t("ExpandSymmetric"); RegionTimer reg(t);
+    size_t n = mat.Height();
+
+    Array<int> cnt(n);
+    cnt = 0;
+    for (size_t i = 0; i < n; i++)
+      for (auto j : mat.GetRowIndices(i))
+        {
+          cnt[i]++;
+          if (size_t(j) != i) cnt[j]++;
+        }
+
+    // rows are filled in increasing order of columns: the lower part of
+    // row i comes with row i, the upper part with the later rows
+    auto full = make_shared<SparseMatrix<double>> (cnt, n);
+    cnt = 0;
+    for (size_t i = 0; i < n; i++)
+      {
+        auto cols = mat.GetRowIndices(i);
+        auto vals = mat.GetRowValues(i);
+        for (size_t k = 0; k < cols.Size(); k++)
+          {
+            int j = cols[k];
+            full->GetRowIndices(i)[cnt[i]] = j;
+            full->GetRowValues(i)[cnt[i]++] = vals[k];
+            if (size_t(j) != i)
+              {
+                full->GetRowIndices(j)[cnt[j]] = i;
+                full->GetRowValues(j)[cnt[j]++] = vals[k];
+              }
+          }
+      }
+    full->SetParallelDofs (mat.GetParallelDofs());
+    return full;
+  }
+
 }
@@ -83,6 +83,116 @@ namespace ngla
 
 
 
+  /**
+     Sparse matrix with entries stored in single precision.
+     Products are accumulated in double precision. Halves the
+     memory traffic of the matrix, useful for preconditioners
+     and for inner solves of iterative refinement.
+   */
+  class  NGS_DLL_HEADER SparseMatrixFloat : public BaseSparseMatrix, 
+                                            public S_BaseMatrix<double>
+  {
+  protected:
+    Array<float> data;
+    
+  public:
+    SparseMatrixFloat (const SparseMatrixTM<double> & mat);
+
+    virtual int VHeight() const override { return size; }
+    virtual int VWidth() const override { return width; }
+
+    FlatArray<float> GetRowValues (size_t i) const
+    { return FlatArray<float> (firsti[i+1]-firsti[i], const_cast<float*>(data.Data())+firsti[i]); }
+    
+    /// entry (i,j), 0 for unused entries
+    double operator() (int i, int j) const
+    {
+      size_t pos = GetPositionTest (i,j);
+      return (pos != numeric_limits<size_t>::max()) ? data[pos] : 0.0;
+    }
+    
+    double RowTimesVector (size_t row, FlatVector<double> vec) const
+    {
+      double sum = 0;
+      for (size_t j = firsti[row]; j < firsti[row+1]; j++)
+        sum += double(data[j]) * vec(colnr[j]);
+      return sum;
+    }
+    
+    virtual void MultAdd (double s, const BaseVector & x, BaseVector & y) const override;
+    virtual void MultTransAdd (double s, const BaseVector & x, BaseVector & y) const override;
+
+    virtual shared_ptr<BaseJacobiPrecond>
+      CreateJacobiPrecond (shared_ptr<BitArray> inner = nullptr) const override;
+
+    virtual shared_ptr<BaseBlockJacobiPrecond>
+      CreateBlockJacobiPrecond (shared_ptr<Table<int>> blocks,
+                                const BaseVector * constraint = 0,
+                                bool parallel  = 1,
+                                shared_ptr<BitArray> freedofs = NULL) const override;
+    
+    virtual Array<MemoryUsage> GetMemoryUsage () const override;
+    
+    AutoVector CreateRowVector() const override;
+    AutoVector CreateColVector() const override;
+
+    virtual tuple<int,int> EntrySizes() const override { return { 1, 1 }; }
+  };
+
+  
+  /**
+     Sliced ELLPACK (SELL-C-sigma) storage.
+     Rows are sorted by length within windows of sigma rows, and
+     grouped into chunks of C = SIMD width rows. Every chunk is
+     padded to its longest row and stored column-major, such that
+     one SIMD lane processes one row.
+   */
+  template <class TSCAL>
+  class  NGS_DLL_HEADER SparseMatrixSELL : public S_BaseMatrix<TSCAL>
+  {
+  protected:
+    size_t height, width, nze;
+    /// chunk height
+    static constexpr int C = SIMD<double>::Size();
+    /// sorting window
+    size_t sigma;
+    /// nr of chunks
+    size_t nchunks;
+    /// row of chunk-lane, -1 for padding rows
+    Array<int> perm;
+    /// start of chunk in colnr and data
+    Array<size_t> firsti;
+    Array<int> colnr;
+    Array<TSCAL> data;
+    /// balancing for multi-threading
+    Partitioning balance;
+    
+  public:
+    SparseMatrixSELL (const SparseMatrixTM<TSCAL> & mat, size_t asigma = 256);
+
+    int VHeight() const override { return height; }
+    int VWidth() const override { return width; }
+    size_t NZE () const override { return nze; }
+
+    /// number of stored entries including padding
+    size_t NZEPadded () const { return colnr.Size(); }
+    size_t GetSigma () const { return sigma; }
+    static constexpr int GetChunkSize () { return C; }
+    
+    void MultAdd (double s, const BaseVector & x, BaseVector & y) const override;
+    void MultTransAdd (double s, const BaseVector & x, BaseVector & y) const override;
+
+    Array<MemoryUsage> GetMemoryUsage () const override;
+    
+    AutoVector CreateRowVector () const override;
+    AutoVector CreateColVector () const override;
+  };
+
+
+  /// the full pattern of a matrix in symmetric (lower triangular) storage
+  NGS_DLL_HEADER shared_ptr<SparseMatrix<double>>
+  ExpandSymmetric (const SparseMatrixSymmetric<double> & mat);
+
 }
 #endif
   
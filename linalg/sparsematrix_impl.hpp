@@ -213,6 +213,26 @@ namespace ngla
   
   
 
+  template <class TM, class TV_ROW, class TV_COL>
+  bool SparseMatrix<TM,TV_ROW,TV_COL> ::
+  MultAddRows (double s, const BaseVector & x, BaseVector & y,
+               FlatArray<int> rows) const
+  {
+    static Timer t("SparseMatrix::MultAddRows"); RegionTimer reg(t);
+
+    ParallelForRange
+      (rows.Size(), [&] (IntRange myrange)
+       {
+         FlatVector<TVX> fx = x.FV<TVX>(); 
+         FlatVector<TVY> fy = y.FV<TVY>(); 
+
+         for (auto i : myrange)
+           fy(rows[i]) += s * RowTimesVector (rows[i], fx);
+       });
+    return true;
+  }
+
+
   template <class TM, class TV_ROW, class TV_COL>
   void SparseMatrix<TM,TV_ROW,TV_COL> ::
   MultTransAdd (double s, const BaseVector & x, BaseVector & y) const
@@ -278,7 +298,65 @@ namespace ngla
   void SparseMatrix<TM,TV_ROW,TV_COL> ::
   MultAdd (FlatVector<double> alpha, const MultiVector & x, MultiVector & y) const
   {
-    BaseMatrix::MultAdd (alpha, x, y);
+    if constexpr (!is_same<TM,double>::value || !is_same<TVX,double>::value || !is_same<TVY,double>::value)
+      BaseMatrix::MultAdd (alpha, x, y);
+    else
+      {
+        static Timer t("SparseMatrix::MultAdd - MultiVector"); RegionTimer reg(t);
+
+        size_t k = alpha.Size();
+        Matrix<double> hx(this->Width(), k), hy(this->Height(), k);
+        x.CopyToInterleaved (hx);
+        hy = 0.0;
+        MultAddInterleaved (1, hx, hy);
+        y.AddFromInterleaved (alpha, hy);
+      }
+  }
+
+  template <class TM, class TV_ROW, class TV_COL>
+  void SparseMatrix<TM,TV_ROW,TV_COL> ::
+  MultAddInterleaved (double s, SliceMatrix<double> x, SliceMatrix<double> y) const
+  {
+    if constexpr (!is_same<TM,double>::value || !is_same<TVX,double>::value || !is_same<TVY,double>::value)
+      BaseMatrix::MultAddInterleaved (s, x, y);
+    else
+      {
+        static Timer t("SparseMatrix::MultAddInterleaved"); RegionTimer reg(t);
+        t.AddFlops (this->NZE()*x.Width());
+
+        // every row is read once, SIMD over the vectors
+        constexpr size_t SW = SIMD<double>::Size();
+        size_t k = x.Width();
+        
+        ParallelForRange
+          (balance, [&] (IntRange myrange)
+           {
+             for (auto i : myrange)
+               {
+                 size_t first = firsti[i], last = firsti[i+1];
+                 size_t j0 = 0;
+                 for ( ; j0+SW <= k; j0 += SW)
+                   {
+                     SIMD<double> sum(0.0);
+                     for (size_t l = first; l < last; l++)
+                       sum = FMA (SIMD<double>(data[l]), SIMD<double>(&x(colnr[l],j0)), sum);
+                     SIMD<double> hy(&y(i,j0));
+                     hy = FMA (SIMD<double>(s), sum, hy);
+                     hy.Store (&y(i,j0));
+                   }
+                 if (j0 < k)
+                   {
+                     SIMD<mask64> mask(k-j0);
+                     SIMD<double> sum(0.0);
+                     for (size_t l = first; l < last; l++)
+                       sum = FMA (SIMD<double>(data[l]), SIMD<double>(&x(colnr[l],j0), mask), sum);
+                     SIMD<double> hy(&y(i,j0), mask);
+                     hy = FMA (SIMD<double>(s), sum, hy);
+                     hy.Store (&y(i,j0), mask);
+                   }
+               }
+           });
+      }
   }
   
 
@@ -491,140 +569,221 @@ namespace ngla
   }
 
 
-  template<class TM, class TV_ROW, class TV_COL>
-  shared_ptr<BaseSparseMatrix>
-  SparseMatrix<TM,TV_ROW,TV_COL> :: Restrict (const SparseMatrixTM<double> & prol,
-                                  shared_ptr<BaseSparseMatrix> acmat ) const
+  /**
+     Hash map column -> value for accumulating one sparse row.
+     Clear costs only the number of used entries, so one accumulator 
+     is reused for all rows of a task.
+  */
+  template <typename T>
+  class RowAccumulator
   {
-    static Timer t ("sparsematrix - restrict");
-    static Timer tbuild ("sparsematrix - restrict, build matrix");
-    static Timer tcomp ("sparsematrix - restrict, compute matrix");
-    RegionTimer reg(t);
-    
-    int n = this->Height();
+    Array<int> keys;     // -1 ... empty
+    Array<T> vals;
+    Array<int> slots;    // used slots, in order of insertion
+    size_t mask;
+  public:
+    RowAccumulator (size_t size = 64)
+    {
+      keys.SetSize (size);
+      vals.SetSize (size);
+      keys = -1;
+      mask = size-1;
+    }
 
-    auto cmat = dynamic_pointer_cast<SparseMatrixTM<TM>> (acmat);
- 
-    // if no coarse matrix, build up matrix-graph!
-    if ( !cmat )
-      {
-        RegionTimer reg(tbuild);
+    size_t Size () const { return slots.Size(); }
+    FlatArray<int> Slots () const { return slots; }
+    int Key (int slot) const { return keys[slot]; }
+    const T & Value (int slot) const { return vals[slot]; }
 
-	Array<int> marks(n);
-	Array<INT<2> > e2v;
-	for (int i = 0; i < n; i++)
-	  for (int j = 0; j < this->GetRowIndices(i).Size(); j++)
-	    {
-	      int col = this->GetRowIndices(i)[j];
-	      FlatArray<int> prol_rowind = prol.GetRowIndices(i);
-	      FlatArray<int> prol_colind = prol.GetRowIndices(col);
-
-	      for (int k = 0; k < prol_rowind.Size(); k++)
-		for (int l = 0; l < prol_colind.Size(); l++)
-		  {
-		    int kk = prol_rowind[k];
-		    int ll = prol_colind[l];
-		    
-		    // if (kk >= ll) swap (kk,ll);
-		    e2v.Append (INT<2> (kk,ll));
-		  }
-	    }
+    void Clear ()
+    {
+      for (auto s : slots)
+        keys[s] = -1;
+      slots.SetSize0();
+    }
 
-	int nc = 0;
-	for (int i = 0; i < e2v.Size(); i++)
-	  nc = max2 (nc, e2v[i][1]);
-	nc++;
+    T & operator[] (int key)
+    {
+      if (2*(slots.Size()+1) > keys.Size())
+        Grow();
+      size_t s = (size_t(key) * 2654435761u) & mask;
+      while (true)
+        {
+          if (keys[s] == key) return vals[s];
+          if (keys[s] == -1)
+            {
+              keys[s] = key;
+              vals[s] = T(0.0);
+              slots.Append (s);
+              return vals[s];
+            }
+          s = (s+1) & mask;
+        }
+    }
 
-	// *testout << "e2v = " << endl << e2v << endl;
-        
-        // count all entries in row with multiplicity
-	Array<int> cnt(nc);
-	cnt = 0;
-	for (int i = 0; i < e2v.Size(); i++)
-	  cnt[e2v[i][1]]++;
-
-	Table<int> v2e(cnt);
-	cnt = 0;
-	for (int i = 0; i < e2v.Size(); i++)
-	  {
-	    int v1 = e2v[i][1];
-	    v2e[v1][cnt[v1]++] = i;
-	  }
-	
-	cnt = 0;
-	marks = -1;
+  private:
+    void Grow ()
+    {
+      Array<int> oldkeys(std::move(keys));
+      Array<T> oldvals(std::move(vals));
+      Array<int> oldslots(std::move(slots));
+      size_t size = 2*oldkeys.Size();
+      keys.SetSize (size);
+      vals.SetSize (size);
+      keys = -1;
+      mask = size-1;
+      slots.SetSize0();
+      for (auto s : oldslots)
+        (*this)[oldkeys[s]] = oldvals[s];
+    }
+  };
+
+
+  /*
+    Galerkin product P^T A P, row by row of the coarse matrix:
+    C(I,:) = sum_{i in P^T(I,:)} P(i,I) sum_{j in A(i,:)} A(i,j) P(j,:)
+    Symbolic pass (count, then sorted indices) and numeric pass 
+    run in parallel over coarse rows, every task accumulates 
+    in its own hash table. If cmat is given and its pattern 
+    contains the product, only the values are recomputed.
+    arow(i, func) calls func(j, A(i,j)) for the full row i of A,
+    with lower only the lower triangle of C is computed.
+  */
+  template <class TM, class TCMAT, class AROW>
+  shared_ptr<TCMAT> GalerkinProduct (AROW arow, const SparseMatrixTM<double> & prol,
+                                     shared_ptr<TCMAT> cmat, bool lower)
+  {
+    static Timer tbuild ("sparsematrix - restrict, build matrix");
+    static Timer tcomp ("sparsematrix - restrict, compute matrix");
 
-        // count all entries in row withOUT multiplicity
-	for (int i = 0; i < nc; i++)
-	  for (int j = 0; j < v2e[i].Size(); j++)
-	    {
-	      int jj = v2e[i][j];
-	      int v0 = e2v[jj][0];
-	      if (marks[v0] != i) 
-		{
-		  cnt[i]++;
-		  marks[v0] = i;
-		}
-	    }
+    size_t nc = prol.Width();
+    auto prolT = dynamic_pointer_cast<SparseMatrixTM<double>> (prol.CreateTranspose());
 
-	cmat = make_shared<SparseMatrix<TM,TV_ROW,TV_COL>> (cnt);
+    if (cmat && (cmat->Height() != nc || cmat->Width() != nc))
+      cmat = nullptr;
 
-	marks = -1;
-	for (int i = 0; i < nc; i++)
-	  for (int j = 0; j < v2e[i].Size(); j++)
-	    {
-	      int jj = v2e[i][j];
-	      int v0 = e2v[jj][0];
-	      if (marks[v0] != i) 
-		{
-		  marks[v0] = i;
-		  cmat -> CreatePosition (i, v0);
-		}
-	    }
-      }
-
-    cmat->AsVector() = 0.0;
-    RegionTimer reg2(tcomp);
-	  
-    for (int i = 0; i < n; i++)
+    auto pattern_row = [&] (size_t I, RowAccumulator<TM> & acc)
       {
-        FlatArray<int> mat_ri = this->GetRowIndices(i);
-        FlatVector<TM> mat_rval = this->GetRowValues(i);
+        for (int i : prolT->GetRowIndices(I))
+          arow (i, [&] (int col, const TM & val)
+                {
+                  for (int ll : prol.GetRowIndices(col))
+                    if (!lower || size_t(ll) <= I)
+                      acc[ll];
+                });
+      };
 
-        for (int j = 0; j < mat_ri.Size(); j++)
+    auto calc_row = [&] (size_t I, RowAccumulator<TM> & acc)
+      {
+        auto pri = prolT->GetRowIndices(I);
+        auto prv = prolT->GetRowValues(I);
+        for (size_t k = 0; k < pri.Size(); k++)
           {
-            int col = mat_ri[j];
-            TM mat_val = mat_rval[j]; 
+            double pik = prv[k];
+            arow (pri[k], [&] (int col, const TM & val)
+                  {
+                    TM pa = pik * val;
+                    auto pci = prol.GetRowIndices(col);
+                    auto pcv = prol.GetRowValues(col);
+                    for (size_t l = 0; l < pci.Size(); l++)
+                      if (!lower || size_t(pci[l]) <= I)
+                        acc[pci[l]] += pcv[l] * pa;
+                  });
+          }
+      };
 
-            FlatArray<int> prol_ri_i = prol.GetRowIndices(i);
-            FlatArray<int> prol_ri_col = prol.GetRowIndices(col);
-            FlatVector<double> prol_rval_i = prol.GetRowValues(i);
-            FlatVector<double> prol_rval_col = prol.GetRowValues(col);
+    auto build_graph = [&] ()
+      {
+        RegionTimer reg(tbuild);
+        Array<int> cnt(nc);
+        ParallelForRange
+          (nc, [&] (IntRange r)
+           {
+             RowAccumulator<TM> acc;
+             for (auto I : r)
+               {
+                 acc.Clear();
+                 pattern_row (I, acc);
+                 cnt[I] = acc.Size();
+               }
+           }, TasksPerThread(4));
+        
+        cmat = make_shared<TCMAT> (cnt);
+        
+        ParallelForRange
+          (nc, [&] (IntRange r)
+           {
+             RowAccumulator<TM> acc;
+             for (auto I : r)
+               {
+                 acc.Clear();
+                 pattern_row (I, acc);
+                 auto ci = cmat->GetRowIndices(I);
+                 for (size_t k = 0; k < acc.Size(); k++)
+                   ci[k] = acc.Key(acc.Slots()[k]);
+                 QuickSort (ci);
+               }
+           }, TasksPerThread(4));
+      };
+
+    if (!cmat)
+      build_graph();
 
-            for (int k = 0; k < prol_ri_i.Size(); k++)
-              for (int l = 0; l < prol_ri_col.Size(); l++)
-                {
-                  int kk = prol_ri_i[k];
-                  int ll = prol_ri_col[l];
-                  
-                  if ( /*kk>=ll &&*/ kk < cmat->Height() )
-                    {
-                      (*cmat)(kk,ll) += 
-                        prol_rval_i[k] * prol_rval_col[l] * mat_val; 
-                    }
-                  
-                  // if (ll >= kk && i != col && ll < cmat->Height() )
-                  //   {
-                  //     (*cmat)(ll,kk) += 
-                  //       prol_rval_col[l] * prol_rval_i[k] * Trans(mat_val); 
-                  //   }
-                  
-                }
-          }
+    RegionTimer reg2(tcomp);
+    for (int pass = 0; pass < 2; pass++)
+      {
+        atomic<bool> missing(false);
+        ParallelForRange
+          (nc, [&] (IntRange r)
+           {
+             RowAccumulator<TM> acc;
+             for (auto I : r)
+               {
+                 acc.Clear();
+                 calc_row (I, acc);
+                 auto ci = cmat->GetRowIndices(I);
+                 auto cv = cmat->GetRowValues(I);
+                 for (size_t k = 0; k < cv.Size(); k++)
+                   cv[k] = TM(0.0);
+                 for (auto s : acc.Slots())
+                   {
+                     auto pos = std::lower_bound (ci.Data(), ci.Data()+ci.Size(), acc.Key(s)) - ci.Data();
+                     if (pos < ci.Size() && ci[pos] == acc.Key(s))
+                       cv[pos] = acc.Value(s);
+                     else
+                       missing = true;
+                   }
+               }
+           }, TasksPerThread(4));
+        
+        if (!missing) break;
+        // the given matrix does not fit, build a new graph
+        build_graph();
       }
     return cmat;
   }
 
+  template<class TM, class TV_ROW, class TV_COL>
+  shared_ptr<BaseSparseMatrix>
+  SparseMatrix<TM,TV_ROW,TV_COL> :: Restrict (const SparseMatrixTM<double> & prol,
+                                  shared_ptr<BaseSparseMatrix> acmat ) const
+  {
+    static Timer t ("sparsematrix - restrict");
+    RegionTimer reg(t);
+
+    auto arow = [&] (int i, auto func)
+      {
+        auto ari = this->GetRowIndices(i);
+        auto arv = this->GetRowValues(i);
+        for (size_t j = 0; j < ari.Size(); j++)
+          func (ari[j], arv[j]);
+      };
+
+    return GalerkinProduct<TM> (arow, prol,
+                                dynamic_pointer_cast<SparseMatrix<TM,TV_ROW,TV_COL>> (acmat),
+                                false);
+  }
+
   template <class TM>
   shared_ptr<BaseSparseMatrix> SparseMatrixTM<TM> ::
   CreateTransposeTM (const function<shared_ptr<SparseMatrixTM<decltype(Trans(TM()))>>(const Array<int>&,int)> & creator) const
@@ -753,6 +912,44 @@ namespace ngla
   }
   
   
+  template <class TM>
+  void SparseMatrixTM<TM> ::
+  AddElementMatrixSymmetricRows(FlatArray<int> dnums, BareSliceMatrix<TSCAL> elmat1, IntRange rows)
+  {
+    STACK_ARRAY(int, hmap, dnums.Size());
+    FlatArray<int> map(dnums.Size(), hmap);
+    for (int i = 0; i < dnums.Size(); i++) map[i] = i;
+    QuickSortI (dnums, map);
+
+    Scalar2ElemMatrix<TM, TSCAL> elmat (elmat1);
+
+    int first_used = 0;
+    while (first_used < dnums.Size() && !IsRegularIndex(dnums[map[first_used]]) ) first_used++;
+
+    for (int i1 = first_used; i1 < dnums.Size(); i1++)
+      {
+        int row = dnums[map[i1]];
+        if (size_t(row) < rows.First() || size_t(row) >= rows.Next()) continue;
+        
+        FlatArray<int> rowind = this->GetRowIndices(row);
+        FlatVector<TM> rowvals = this->GetRowValues(row);
+        auto elmat_row = elmat.Rows(map[i1], map[i1]+1);
+
+        size_t k = 0;
+        for (int j1 = first_used; j1 <= i1; j1++, k++)
+          {
+            while (rowind[k] != dnums[map[j1]])
+              {
+                k++;
+                if (unlikely(k >= rowind.Size()))
+                  throw Exception ("SparseMatrixSymmetricTM::AddElementMatrix: illegal dnums");
+              }
+            rowvals(k) += elmat_row(0, map[j1]);
+          }
+      }
+  }
+  
+  
   template <class TM, class TV>
   SparseMatrixSymmetric<TM,TV> :: 
   SparseMatrixSymmetric (const MatrixGraph & agraph, bool stealgraph)
@@ -785,6 +982,25 @@ namespace ngla
       }
   }
 
+  template <class TM, class TV>
+  bool SparseMatrixSymmetric<TM,TV> :: 
+  MultAddRows (double s, const BaseVector & x, BaseVector & y,
+               FlatArray<int> rows) const
+  {
+    static Timer timer("SparseMatrixSymmetric::MultAddRows");
+    RegionTimer reg (timer);
+
+    const FlatVector<TV_ROW> fx = x.FV<TV_ROW>();
+    FlatVector<TV_COL> fy = y.FV<TV_COL>();
+
+    for (int i : rows)
+      {
+	fy(i) += s * RowTimesVector (i, fx);
+	AddRowTransToVectorNoDiag (i, s * fx(i), fy);
+      }
+    return true;
+  }
+
   template <class TM, class TV>
   void SparseMatrixSymmetric<TM,TV> :: 
   MultAdd1 (double s, const BaseVector & x, BaseVector & y,
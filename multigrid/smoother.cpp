@@ -151,6 +151,68 @@ namespace ngmg
 
 
 
+  ChebyshevSmoother :: 
+  ChebyshevSmoother  (const MeshAccess & ama,
+                      const BilinearForm & abiform, const Flags & aflags)
+    : Smoother(aflags), biform(abiform)
+  {
+    degree = int(flags.GetNumFlag ("chebyshevdegree", 3));
+    Update();
+  }
+
+  ChebyshevSmoother :: ~ChebyshevSmoother()
+  { ; }
+
+  void ChebyshevSmoother :: Update (bool force_update)
+  {
+    int nlevels = biform.GetNLevels();
+    if (cheb.Size() == nlevels && !force_update && !updateall)
+      return;
+
+    double ratio = flags.GetNumFlag ("chebyshevratio", 0.3);
+    int oldsize = (force_update || updateall) ? 0 : cheb.Size();
+    cheb.SetSize (nlevels);
+    for (int i = oldsize; i < nlevels; i++)
+      {
+	if (biform.GetMatrixPtr(i))
+          {
+            auto jac = dynamic_cast<const BaseSparseMatrix&> (*biform.GetMatrixPtr(i))
+              .CreateJacobiPrecond(biform.GetFESpace()->GetFreeDofs());
+            cheb[i] = make_shared<ChebyshevSmoothing> (biform.GetMatrixPtr(i), jac, ratio);
+          }
+	else
+	  cheb[i] = nullptr;
+      }
+  }
+
+  void ChebyshevSmoother :: PreSmooth (int level, BaseVector & u, 
+                                       const BaseVector & f, int steps) const
+  {
+    cheb[level]->Smooth (u, f, steps*degree);
+  }
+
+  void ChebyshevSmoother :: PostSmooth (int level, BaseVector & u, 
+                                        const BaseVector & f, int steps) const
+  {
+    cheb[level]->Smooth (u, f, steps*degree);
+  }
+
+  void ChebyshevSmoother :: 
+  Residuum (int level, BaseVector & u, 
+	    const BaseVector & f, BaseVector & d) const
+  {
+    d = f - biform.GetMatrix(level) * u;
+  }
+  
+  AutoVector ChebyshevSmoother :: CreateVector(int level) const
+  {
+    return biform.GetMatrix(level).CreateColVector();
+  }
+
+
+
+
+
   AnisotropicSmoother :: 
   AnisotropicSmoother  (const MeshAccess & ama,
 			const BilinearForm & abiform)
@@ -703,6 +765,7 @@ namespace ngmg
 
 	jac.DeleteAll();
 	inv.DeleteAll();
+	cheb.DeleteAll();
       }
     if (jac.Size() == level && !force_update)
       return;
@@ -734,6 +797,14 @@ namespace ngmg
             jac[lvl-1] = dynamic_cast<const BaseSparseMatrix&>
               (biform.GetMatrix(lvl-1)).CreateBlockJacobiPrecond(smoothing_blocks[lvl-1], &constraint->GetVector());
           }
+
+        if (flags.GetDefineFlag ("chebyshev"))
+          {
+            while (cheb.Size() < lvl)
+              cheb.Append(nullptr);
+            cheb[lvl-1] = make_shared<ChebyshevSmoothing>
+              (biform.GetMatrixPtr(lvl-1), jac[lvl-1], flags.GetNumFlag ("chebyshevratio", 0.3));
+          }
       }
 #else
 
@@ -802,7 +873,9 @@ namespace ngmg
   void BlockSmoother :: PreSmooth (int level, BaseVector & u, 
 				   const BaseVector & f, int steps) const
   {
-    if(!inv[level]) 
+    if (UseChebyshev(level))
+      cheb[level] -> Smooth (u, f, steps*int(flags.GetNumFlag ("chebyshevdegree", 3)));
+    else if(!inv[level]) 
       jac[level] -> GSSmooth (u, f, steps);
     else
       {
@@ -829,7 +902,12 @@ namespace ngmg
     res = f;
     u = 0;
 
-    if(!inv[level]) 
+    if (UseChebyshev(level))
+      {
+        cheb[level] -> Smooth (u, f, steps*int(flags.GetNumFlag ("chebyshevdegree", 3)));
+        Residuum (level, u, f, res);
+      }
+    else if(!inv[level]) 
       {
 	jac[level] -> GSSmoothResiduum (u, f, res, steps);
       }
@@ -868,7 +946,9 @@ namespace ngmg
   void  BlockSmoother :: PostSmooth (int level, BaseVector & u, 
 				     const BaseVector & f, int steps) const
   {
-    if(!inv[level])
+    if (UseChebyshev(level))
+      cheb[level] -> Smooth (u, f, steps*int(flags.GetNumFlag ("chebyshevdegree", 3)));
+    else if(!inv[level])
       {
 	//*testout << "postsmooth" << endl;
 	jac[level] -> GSSmoothBack (u, f, steps);
@@ -119,6 +119,44 @@ namespace ngmg
   };
 
 
+  /**
+     Chebyshev-Jacobi smoother.
+     Polynomial in the point-Jacobi preconditioned matrix,
+     only matrix-vector products, no coloring.
+     Flags: chebyshevdegree, chebyshevratio
+  */
+  class ChebyshevSmoother : public Smoother
+  {
+    ///
+    const BilinearForm & biform;
+    ///
+    Array<shared_ptr<ChebyshevSmoothing>> cheb;
+    ///
+    int degree;
+  
+  public:
+    ///
+    ChebyshevSmoother (const MeshAccess & ama,
+                       const BilinearForm & abiform, const Flags & aflags);
+    ///
+    virtual ~ChebyshevSmoother();
+  
+    ///
+    virtual void Update (bool force_update = 0);
+    ///
+    virtual void PreSmooth (int level, ngla::BaseVector & u, 
+			    const ngla::BaseVector & f, int steps) const;
+    ///
+    virtual void PostSmooth (int level, ngla::BaseVector & u, 
+			     const ngla::BaseVector & f, int steps) const;
+    ///
+    virtual void Residuum (int level, ngla::BaseVector & u, 
+			   const ngla::BaseVector & f, ngla::BaseVector & d) const;
+    ///
+    virtual AutoVector CreateVector(int level) const;
+  };
+
+
   /**
      Anisotropic smoother.
      Common relaxation of vertically aligned nodes.
@@ -161,6 +199,8 @@ namespace ngmg
   /**
      Block-Gauss-Seidel smoother.
      Blocks are defined by underlying FESpace.
+     With flag chebyshev, a Chebyshev polynomial in the
+     block-Jacobi preconditioned matrix replaces the sweeps.
   */
   class BlockSmoother : public Smoother
   {
@@ -178,6 +218,11 @@ namespace ngmg
     shared_ptr<Array<int>> direct;
 
     Array<shared_ptr<Table<int>>> smoothing_blocks;
+    ///
+    Array<shared_ptr<ChebyshevSmoothing>> cheb;
+
+    bool UseChebyshev (int level) const
+    { return level < cheb.Size() && cheb[level] && !inv[level]; }
 
   public:
     ///
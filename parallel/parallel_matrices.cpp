@@ -493,18 +493,63 @@ namespace ngla
     ; // delete &mat;
   }
 
+  void ParallelMatrix :: SplitRows () const
+  {
+    static Timer t("ParallelMatrix::SplitRows"); RegionTimer reg(t);
+
+    auto spmat = dynamic_pointer_cast<BaseSparseMatrix>(mat);
+    auto pd = row_paralleldofs ? row_paralleldofs : paralleldofs;
+
+    interior_rows.SetSize0();
+    boundary_rows.SetSize0();
+    for (size_t i = 0; i < spmat->Height(); i++)
+      {
+        bool interior = true;
+        for (auto col : spmat->GetRowIndices(i))
+          if (pd->GetDistantProcs(col).Size())
+            {
+              interior = false;
+              break;
+            }
+        if (interior)
+          interior_rows.Append(i);
+        else
+          boundary_rows.Append(i);
+      }
+    rows_split = true;
+  }
+
+
   void ParallelMatrix :: MultAdd (double s, const BaseVector & x, BaseVector & y) const
   {
     const auto & xpar = dynamic_cast_ParallelBaseVector(x);
     auto & ypar = dynamic_cast_ParallelBaseVector(y);
-    if (op & char(2))
-      x.Cumulate();
-    else
-      x.Distribute();
     if (op & char(1))
       y.Cumulate();
     else
       y.Distribute();
+
+    auto spmat = dynamic_pointer_cast<BaseSparseMatrix>(mat);
+    if ( (op & char(2)) && overlap && spmat && x.GetParallelStatus() == DISTRIBUTED)
+      {
+        // split phase: interior rows while the exchange of x is in flight
+        static Timer t("ParallelMatrix::MultAdd - overlapped"); RegionTimer reg(t);
+        if (!rows_split) SplitRows();
+
+        xpar.StartCumulate();
+        bool split = spmat->MultAddRows (s, *xpar.GetLocalVector(), *ypar.GetLocalVector(), interior_rows);
+        xpar.FinishCumulate();
+        if (split)
+          spmat->MultAddRows (s, *xpar.GetLocalVector(), *ypar.GetLocalVector(), boundary_rows);
+        else
+          mat->MultAdd (s, *xpar.GetLocalVector(), *ypar.GetLocalVector());
+        return;
+      }
+
+    if (op & char(2))
+      x.Cumulate();
+    else
+      x.Distribute();
     mat->MultAdd (s, *xpar.GetLocalVector(), *ypar.GetLocalVector());
   
     /*
@@ -56,6 +56,12 @@ namespace ngla
     shared_ptr<ParallelDofs> row_paralleldofs, col_paralleldofs;
 
     PARALLEL_OP op;
+
+    /// overlap the cumulation of x with the rows not touching exchange dofs
+    bool overlap = true;
+    mutable bool rows_split = false;
+    mutable Array<int> interior_rows, boundary_rows;
+    void SplitRows () const;
     
   public:
     ParallelMatrix (shared_ptr<BaseMatrix> amat, shared_ptr<ParallelDofs> apardofs,
@@ -93,6 +99,9 @@ namespace ngla
 
     PARALLEL_OP GetOpType () const { return op; }
 
+    void SetOverlap (bool ov) { overlap = ov; }
+    bool GetOverlap () const { return overlap; }
+
     virtual shared_ptr<BaseMatrix> InverseMatrix (shared_ptr<BitArray> subset = 0) const override;
     template <typename TM>
     shared_ptr<BaseMatrix> InverseMatrixTM (shared_ptr<BitArray> subset = 0) const;
@@ -26,6 +26,8 @@ namespace ngla
     
     Array<MPI_Request> sreqs;
     Array<MPI_Request> rreqs;
+    mutable bool cumulate_started = false;
+    mutable ExchangePlan * cumulate_plan = nullptr;
 
   public:
     ParallelBaseVector ()
@@ -76,6 +78,10 @@ namespace ngla
     { return local_vec; }
     
     virtual void Cumulate () const override; 
+    /// split-phase Cumulate: posts the messages ...
+    virtual void StartCumulate () const;
+    /// ... waits for them and adds the received values
+    virtual void FinishCumulate () const;
     
     virtual void Distribute() const override = 0;
     // { cerr << "ERROR -- Distribute called for BaseVector, is not parallel" << endl; }
@@ -190,6 +196,7 @@ namespace ngla
     // virtual void  RecvVec ( int dest );
     virtual void AddRecvValues( int sender ) override;
     virtual AutoVector CreateVector () const override;
+    virtual unique_ptr<MultiVector> CreateMultiVector (size_t cnt) const override;
 
     virtual double L2Norm () const override;
   };
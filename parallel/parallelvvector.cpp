@@ -60,6 +60,17 @@ namespace ngla
       local_vec -> GetIndirect (ind, v);
     }
 
+    void StartCumulate () const override
+    {
+      orig->StartCumulate();
+    }
+
+    void FinishCumulate () const override
+    {
+      orig->FinishCumulate();
+      status = orig->GetParallelStatus();
+    }
+
     void Cumulate () const override
     {
       orig->Cumulate();
@@ -220,9 +231,16 @@ namespace ngla
   {
     static Timer t("ParallelVector - Cumulate");
     RegionTimer reg(t);
-    
+
+    StartCumulate();
+    FinishCumulate();
+  }
+
+
+  void ParallelBaseVector :: StartCumulate () const
+  {
 #ifdef PARALLEL
-    if (status != DISTRIBUTED) return;
+    if (status != DISTRIBUTED || cumulate_started) return;
     
     // int ntasks = paralleldofs->GetNTasks();
     auto exprocs = paralleldofs->GetDistantProcs();
@@ -230,6 +248,16 @@ namespace ngla
     int nexprocs = exprocs.Size();
     
     ParallelBaseVector * constvec = const_cast<ParallelBaseVector * > (this);
+
+    // cached exchange with pre-packed buffers, unless in use by another vector
+    ExchangePlan & plan = paralleldofs->GetExchangePlan (EntrySize());
+    if (!plan.IsBusy())
+      {
+        plan.Start (static_cast<double*> (Memory()));
+        cumulate_plan = &plan;
+        cumulate_started = true;
+        return;
+      }
     
     for (int idest = 0; idest < nexprocs; idest ++ ) 
       constvec->ISend (exprocs[idest], sreqs[idest] );
@@ -240,6 +268,29 @@ namespace ngla
     //   MPI_Startall(rreqs.Size(), &rreqs[0]);
     //   MPI_Startall(sreqs.Size(), &sreqs[0]);
     // }
+    cumulate_started = true;
+#endif
+  }
+
+
+  void ParallelBaseVector :: FinishCumulate () const
+  {
+#ifdef PARALLEL
+    if (status != DISTRIBUTED) return;
+    if (!cumulate_started) StartCumulate();
+
+    if (cumulate_plan)
+      {
+        cumulate_plan->FinishAdd (static_cast<double*> (Memory()));
+        cumulate_plan = nullptr;
+        cumulate_started = false;
+        SetStatus(CUMULATED);
+        return;
+      }
+
+    auto exprocs = paralleldofs->GetDistantProcs();
+    int nexprocs = exprocs.Size();
+    ParallelBaseVector * constvec = const_cast<ParallelBaseVector * > (this);
 
     MyMPI_WaitAll (sreqs);
     
@@ -250,6 +301,7 @@ namespace ngla
 	constvec->AddRecvValues(exprocs[isender]);
       } 
 
+    cumulate_started = false;
     SetStatus(CUMULATED);
 #endif
   }
@@ -350,6 +402,92 @@ namespace ngla
 
 
 
+  template <class SCAL>
+  int FusedInnerProducts<SCAL> :: Add (const BaseVector & v1, const BaseVector & v2, bool conjugate)
+  {
+    static Timer t("FusedInnerProducts - Add");
+    RegionTimer reg(t);
+
+    const ParallelBaseVector * parv1 = dynamic_cast_ParallelBaseVector(&v1);
+    const ParallelBaseVector * parv2 = dynamic_cast_ParallelBaseVector(&v2);
+
+    FlatVector<SCAL> fv1 = v1.FV<SCAL>();
+    FlatVector<SCAL> fv2 = v2.FV<SCAL>();
+    SCAL localsum = 0.0;
+
+    if (parv1 && parv2 && parv1->Status() != NOT_PARALLEL && parv2->Status() != NOT_PARALLEL)
+      {
+        pardofs = parv1->GetParallelDofs();
+
+        // two distributed vectors -- cumulate one
+        if (parv1->Status() == DISTRIBUTED && parv2->Status() == DISTRIBUTED)
+          parv1->Cumulate();
+
+        // two cumulated vectors -- count master dofs only
+        if (parv1->Status() == CUMULATED && parv2->Status() == CUMULATED)
+          {
+            const BitArray & masters = pardofs->MasterDofs();
+            size_t es = v1.Size() ? fv1.Size() / v1.Size() : 0;
+            for (size_t i = 0; i < v1.Size(); i++)
+              if (masters.Test(i))
+                for (size_t j = es*i; j < es*(i+1); j++)
+                  localsum += (conjugate ? Conj(fv1(j)) : fv1(j)) * fv2(j);
+            values.Append (localsum);
+            return values.Size()-1;
+          }
+      }
+
+    if constexpr (is_same<SCAL,Complex>::value)
+      if (conjugate)
+        {
+          values.Append (ngbla::InnerProduct (Conj(fv1), fv2));
+          return values.Size()-1;
+        }
+    values.Append (ngbla::InnerProduct (fv1, fv2));
+    return values.Size()-1;
+  }
+
+  template <class SCAL>
+  void FusedInnerProducts<SCAL> :: Start ()
+  {
+#ifdef PARALLEL
+    if (pardofs && values.Size() && !started)
+      {
+        MPI_Iallreduce (MPI_IN_PLACE, values.Data(), values.Size(), GetMPIType<SCAL>(),
+                        MPI_SUM, pardofs->GetCommunicator(), &request);
+        started = true;
+      }
+#endif
+  }
+
+  template <class SCAL>
+  FlatArray<SCAL> FusedInnerProducts<SCAL> :: Wait ()
+  {
+#ifdef PARALLEL
+    if (started)
+      {
+        static Timer t("FusedInnerProducts - Wait");
+        RegionTimer reg(t);
+        MPI_Wait (&request, MPI_STATUS_IGNORE);
+        started = false;
+      }
+#endif
+    return values;
+  }
+
+  template <class SCAL>
+  void FusedInnerProducts<SCAL> :: Reset ()
+  {
+    Wait();
+    values.SetSize0();
+    pardofs = nullptr;
+  }
+
+  template class FusedInnerProducts<double>;
+  template class FusedInnerProducts<Complex>;
+
+
+
   /*
   template <class SCAL>
   S_ParallelBaseVectorPtr<SCAL> :: S_ParallelBaseVectorPtr (int as, int aes, void * adata) throw()
@@ -555,6 +693,134 @@ namespace ngla
 
 
 
+  /**
+     MultiVector of parallel vectors. All pairwise inner products are
+     computed locally and summed by one global reduction. Linear 
+     combinations work on the local values, once all vectors have the 
+     same parallel status.
+   */
+  class ParallelMultiVector : public MultiVector
+  {
+  public:
+    using MultiVector::MultiVector;
+    using MultiVector::InnerProductD;
+    using MultiVector::Add;
+
+    unique_ptr<MultiVector> Range(IntRange r) const override
+    {
+      auto mv2 = make_unique<ParallelMultiVector>(refvec, 0);
+      for (auto i : r)
+        mv2->vecs.Append (vecs[i]);
+      return mv2;
+    }
+
+    unique_ptr<MultiVector> SubSet(const Array<int> & indices) const override
+    {
+      auto mv2 = make_unique<ParallelMultiVector>(refvec, 0);
+      for (auto i : indices)
+        mv2->vecs.Append (vecs[i]);
+      return mv2;
+    }
+
+    Matrix<> InnerProductD (const MultiVector & y) const override
+    {
+      auto parvec = dynamic_cast_ParallelBaseVector(refvec.get());
+      auto pardofs = parvec ? parvec->GetParallelDofs() : nullptr;
+      if (IsComplex() || !pardofs || refvec->GetParallelStatus() == NOT_PARALLEL)
+        return MultiVector::InnerProductD (y);
+      
+      static Timer t("ParallelMultiVector::InnerProductD");
+      RegionTimer reg(t);
+
+      // me cumulated, y distributed: the local products sum up to the inner product
+      for (auto & v : vecs)
+        v->Cumulate();
+      Array<shared_ptr<BaseVector>> ydist(y.Size());
+      for (size_t j = 0; j < y.Size(); j++)
+        {
+          ydist[j] = y[j];
+          if (y[j]->GetParallelStatus() != CUMULATED) continue;
+          if (vecs.Contains (y[j]))
+            {
+              ydist[j] = y[j]->CreateVector();
+              *ydist[j] = *y[j];
+            }
+          ydist[j]->Distribute();
+        }
+
+      Matrix<double> res(Size(), y.Size());
+      res = 0.0;
+      ParallelForRange
+        (refvec->FVDouble().Size(), [&] (IntRange r)
+         {
+           Array<double*> px(Size()), py(y.Size());
+           for (size_t i = 0; i < Size(); i++)
+             px[i] = vecs[i]->FVDouble().Addr(r.First());
+           for (size_t j = 0; j < y.Size(); j++)
+             py[j] = ydist[j]->FVDouble().Addr(r.First());
+
+           Matrix<double> hres(Size(), y.Size());
+           ngbla::PairwiseInnerProduct (r.Size(), px, py, hres);
+           for (size_t i = 0; i < Size(); i++)
+             for (size_t j = 0; j < y.Size(); j++)
+               AtomicAdd (res(i,j), hres(i,j));
+         });
+      
+#ifdef PARALLEL
+      MPI_Allreduce (MPI_IN_PLACE, res.Data(), res.Height()*res.Width(), MPI_DOUBLE,
+                     MPI_SUM, pardofs->GetCommunicator());
+#endif
+      return res;
+    }
+
+    void Add (const MultiVector & v2, FlatMatrix<double> mat) override
+    {
+      if (IsComplex() || !Size() || !v2.Size())
+        {
+          MultiVector::Add (v2, mat);
+          return;
+        }
+      
+      static Timer t("ParallelMultiVector::Add");
+      RegionTimer reg(t);
+
+      PARALLEL_STATUS status = vecs[0]->GetParallelStatus();
+      bool same = true;
+      for (auto & v : vecs)
+        if (v->GetParallelStatus() != status) same = false;
+      for (size_t j = 0; j < v2.Size(); j++)
+        if (v2[j]->GetParallelStatus() != status) same = false;
+      if (!same)
+        {
+          for (auto & v : vecs)
+            v->Cumulate();
+          for (size_t j = 0; j < v2.Size(); j++)
+            v2[j]->Cumulate();
+        }
+
+      ParallelForRange
+        (refvec->FVDouble().Size(), [&] (IntRange r)
+         {
+           Array<double*> px(Size()), py(v2.Size());
+           for (size_t i = 0; i < Size(); i++)
+             px[i] = vecs[i]->FVDouble().Addr(r.First());
+           for (size_t j = 0; j < v2.Size(); j++)
+             py[j] = v2[j]->FVDouble().Addr(r.First());
+           MultiVectorAdd (r.Size(), px, py, mat);
+         });
+    }
+  };
+
+
+  template <typename SCAL>
+  unique_ptr<MultiVector> S_ParallelBaseVectorPtr<SCAL> :: 
+  CreateMultiVector (size_t cnt) const
+  {
+    return make_unique<ParallelMultiVector> (CreateVector(), cnt);
+  }
+
+
+
   template <typename SCAL>
   AutoVector S_ParallelBaseVectorPtr<SCAL> :: 
   CreateVector () const
@@ -86,11 +86,16 @@ class NewtonSolver:
         u.vec.data += w
 
     def _UpdateInverse(self):
-        if self.inverse in ("sparsecholesky", "given") and self.inv:
+        if self.inverse == "given" and self.inv:
+            self.inv.Update()
+        elif self.inv and self.inv.supports_update and self._invmat is self.a.mat:
+            # same matrix graph: numeric refactorization only,
+            # ordering and symbolic factorization are reused
             self.inv.Update()
         else:
             self.inv = self.a.mat.Inverse(self.freedofs,
                                           inverse=self.inverse)
+            self._invmat = self.a.mat
 
 
 def Newton(a, u, freedofs=None, maxit=100, maxerr=1e-11, inverse="umfpack", \
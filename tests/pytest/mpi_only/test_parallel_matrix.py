@@ -0,0 +1,50 @@
+from ngsolve import *
+
+def setup_problem():
+    comm = MPI_Init()
+    mesh = Mesh('square.vol.gz', comm)
+    fes = H1(mesh, order=3, dirichlet=".*")
+    u,v = fes.TnT()
+    a = BilinearForm(fes)
+    a += (grad(u)*grad(v)+u*v)*dx
+    pre = Preconditioner(a, "local")
+    a.Assemble()
+    f = LinearForm(fes)
+    f += v*dx
+    f.Assemble()
+    return comm, fes, a, f, pre
+
+def test_matvec_overlap():
+    comm, fes, a, f, pre = setup_problem()
+    x = a.mat.CreateRowVector()
+    x.SetRandom()
+    x.SetParallelStatus(PARALLEL_STATUS.DISTRIBUTED)
+    x2 = x.CreateVector()
+    x2.data = x
+    y1 = a.mat.CreateColVector()
+    y2 = a.mat.CreateColVector()
+
+    a.mat.overlap = False
+    y1.data = a.mat * x
+    a.mat.overlap = True
+    y2.data = a.mat * x2
+    assert (y1-y2).Norm() < 1e-12 * y1.Norm()
+
+def test_exchange_modes():
+    comm, fes, a, f, pre = setup_problem()
+    pardofs = fes.ParallelDofs()
+    x = f.vec.CreateVector()
+    x.SetRandom()
+    ref = x.CreateVector()
+    ref.data = x
+    ref.SetParallelStatus(PARALLEL_STATUS.DISTRIBUTED)
+    ref.Cumulate()
+    for mode in [EXCHANGE_MODE.PERSISTENT, EXCHANGE_MODE.NEIGHBOR, EXCHANGE_MODE.ONESIDED]:
+        pardofs.exchange_mode = mode
+        y = x.CreateVector()
+        for i in range(3):   # plans are reused
+            y.data = x
+            y.SetParallelStatus(PARALLEL_STATUS.DISTRIBUTED)
+            y.Cumulate()
+            assert (y-ref).Norm() < 1e-14 * ref.Norm()
+    pardofs.exchange_mode = EXCHANGE_MODE.PERSISTENT
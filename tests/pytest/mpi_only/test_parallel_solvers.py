@@ -0,0 +1,22 @@
+from ngsolve import *
+
+def test_pipelined_cg():
+    comm = MPI_Init()
+    mesh = Mesh('square.vol.gz', comm)
+    fes = H1(mesh, order=3, dirichlet=".*")
+    u,v = fes.TnT()
+    a = BilinearForm(fes)
+    a += (grad(u)*grad(v)+u*v)*dx
+    pre = Preconditioner(a, "local")
+    a.Assemble()
+    f = LinearForm(fes)
+    f += v*dx
+    f.Assemble()
+
+    gfu = GridFunction(fes)
+    inv = la.PipelinedCGSolver(a.mat, pre.mat, printrates=False, precision=1e-10, maxsteps=500)
+    gfu.vec.data = inv * f.vec
+    res = f.vec.CreateVector()
+    res.data = f.vec - a.mat * gfu.vec
+    res.data = Projector(fes.FreeDofs(), True) * res
+    assert res.Norm() < 1e-7 * f.vec.Norm()
@@ -81,6 +81,43 @@ def test_code_generation_derivatives(unit_mesh_3d):
         vals -= vals_ref
         assert Norm(vals) == approx(0)
 
+def test_code_generation_bytecode(unit_mesh_2d):
+    fes = H1(unit_mesh_2d, order=3)
+    gfu = GridFunction(fes)
+    gfu.Set(x*y)
+    v = CoefficientFunction((x,y+1))
+    functions = [ 3*x+1, (x-2)/(y+1), 2/(1+x*x) - 1.5, sin(x)*exp(y)+sqrt(1+x), x**2+y**0.5, 
+                  atan2(y,1+x), InnerProduct(v,v), (x*v)[1], gfu*x+Norm(v), CoefficientFunction(2)*3 ]
+
+    for cf in functions:
+        f = cf.Compile()
+        assert Integrate( (cf-f)*(cf-f), unit_mesh_2d) == approx(0)
+
+def test_code_generation_bytecode_constants(unit_mesh_2d):
+    # constant base of pow and constant arguments of atan2 live in registers
+    one, two = CoefficientFunction(1), CoefficientFunction(2)
+    functions = [ two**x, atan2(one,1+x), atan2(x,one), two**(x+y)*atan2(one,y+1) ]
+    for cf in functions:
+        f = cf.Compile()
+        assert Integrate( (cf-f)*(cf-f), unit_mesh_2d) == approx(0)
+
+@pytest.mark.slow
+def test_code_generation_cache(tmpdir):
+    import os, subprocess, sys
+    script = """
+from ngsolve import *
+from netgen.geom2d import unit_square
+mesh = Mesh(unit_square.GenerateMesh(maxh=0.2))
+cf = (sin(x)*y+x*x).Compile(True, wait=True)
+print(Integrate(cf, mesh))
+"""
+    env = dict(os.environ, NGS_COMPILE_CACHE=str(tmpdir))
+    results = [ float(subprocess.check_output([sys.executable, "-c", script], env=env).split()[-1])
+                for i in range(2) ]
+    assert results[0] == approx(results[1])
+    # the second run reused the library of the first one
+    assert len([f for f in os.listdir(str(tmpdir)) if f.endswith(".so") or f.endswith(".dll")]) == 1
+
 if __name__ == "__main__":
     test_code_generation_derivatives()
     test_code_generation_volume_terms()
@@ -99,7 +99,217 @@ def test_sparsematrix_access():
     a.Assemble()
     assert abs(a.mat[1,1][0,0] - (reference_values[3])) < 1e-8
 
+def test_sparsematrix_sell():
+    mesh = Mesh("square.vol.gz")
+    fes = H1(mesh, order=3)
+    u,v = fes.TnT()
+    a = BilinearForm(fes)
+    a += grad(u)*grad(v)*dx + u*v*ds
+    a.Assemble()
+    for sigma in [1, 32, 1000000]:
+        sell = la.SparseMatrixSELL(a.mat, sigma=sigma)
+        x = a.mat.CreateRowVector()
+        x.SetRandom()
+        y1 = a.mat.CreateColVector()
+        y2 = a.mat.CreateColVector()
+        y1.data = a.mat * x
+        y2.data = sell * x
+        assert (y1-y2).Norm() < 1e-10 * y1.Norm()
+        y1.data = a.mat.T * x
+        y2.data = sell.T * x
+        assert (y1-y2).Norm() < 1e-10 * y1.Norm()
+    # symmetric storage is expanded to the full pattern
+    a = BilinearForm(grad(u)*grad(v)*dx + u*v*ds, symmetric=True).Assemble()
+    sell = la.SparseMatrixSELL(a.mat)
+    assert sell.nze_padded >= 2*a.mat.nze - fes.ndof
+    x = a.mat.CreateRowVector()
+    x.SetRandom()
+    y1 = a.mat.CreateColVector()
+    y2 = a.mat.CreateColVector()
+    y1.data = a.mat * x
+    y2.data = sell * x
+    assert (y1-y2).Norm() < 1e-10 * y1.Norm()
+
+def test_sumfactorization_apply():
+    from ngsolve.meshes import MakeStructured2DMesh, MakeStructured3DMesh
+    meshes = [MakeStructured2DMesh(quads=True, nx=3, ny=3, mapping=lambda x,y: (x+0.2*y*y, y+0.1*x)),
+              MakeStructured3DMesh(hexes=True, nx=2, mapping=lambda x,y,z: (x+0.2*z*z, y, z+0.1*x*y))]
+    for mesh in meshes:
+        fes = H1(mesh, order=4)
+        u,v = fes.TnT()
+        form = (u*v + grad(u)*grad(v)) * dx
+        a = BilinearForm(form).Assemble()
+        anonassemble = BilinearForm(form, nonassemble=True)
+        x = GridFunction(fes)
+        x.vec.SetRandom()
+        y1 = x.vec.CreateVector()
+        y2 = x.vec.CreateVector()
+        y1.data = a.mat * x.vec
+        y2.data = anonassemble.mat * x.vec
+        y1.data -= y2
+        assert Norm(y1) < 1e-10 * Norm(y2)
+
+def test_batch_assembly():
+    mesh = Mesh(unit_cube.GenerateMesh(maxh=0.3))
+    for order in [1, 2, 3]:
+        for fes in [H1(mesh, order=order), VectorH1(mesh, order=order)]:
+            u,v = fes.TnT()
+            c = Parameter(2)
+            if fes.type == "VectorH1":
+                form = (InnerProduct(Sym(Grad(u)), Sym(Grad(v))) + c*div(u)*div(v) + x*u*v) * dx
+            else:
+                form = (grad(u)*grad(v) + c*(1+x*y)*u*v) * dx
+            a1 = BilinearForm(form).Assemble()
+            a2 = BilinearForm(form, batch_assembly=True).Assemble()
+            diff = a1.mat.AsVector().CreateVector()
+            diff.data = a1.mat.AsVector() - a2.mat.AsVector()
+            assert Norm(diff) < 1e-12 * Norm(a1.mat.AsVector())
+
+def test_parameter_cache():
+    mesh = Mesh(unit_square.GenerateMesh(maxh=0.2))
+    fes = H1(mesh, order=2)
+    u,v = fes.TnT()
+    c, d = Parameter(1), Parameter(2)
+    for form in [(grad(u)*grad(v) + c*(1+x)*u*v + 0.5*d*u*v) * dx,
+                 (grad(u)*grad(v) + c*d*u*v) * dx]:
+        a = BilinearForm(form, precompute=True).Assemble()
+        for cval, dval in [(3, 0.5), (0, -1)]:
+            c.Set(cval)
+            d.Set(dval)
+            a.Assemble()
+            aref = BilinearForm(form).Assemble()
+            diff = a.mat.AsVector().CreateVector()
+            diff.data = a.mat.AsVector() - aref.mat.AsVector()
+            assert Norm(diff) < 1e-12 * Norm(aref.mat.AsVector())
+        c.Set(1)
+        d.Set(2)
+    # a mesh deformation must not reuse the cached matrices
+    a = BilinearForm(form, precompute=True).Assemble()
+    deform = GridFunction(VectorH1(mesh, order=1))
+    deform.Set((0.1*x*y, 0))
+    mesh.SetDeformation(deform)
+    a.Assemble()
+    aref = BilinearForm(form).Assemble()
+    mesh.UnsetDeformation()
+    diff = a.mat.AsVector().CreateVector()
+    diff.data = a.mat.AsVector() - aref.mat.AsVector()
+    assert Norm(diff) < 1e-12 * Norm(aref.mat.AsVector())
+
+def test_owner_assembly():
+    mesh = Mesh(unit_cube.GenerateMesh(maxh=0.3))
+    for fes in [H1(mesh, order=2), VectorH1(mesh, order=2)]:
+        u,v = fes.TnT()
+        if fes.type == "VectorH1":
+            form = (InnerProduct(Grad(u), Grad(v)) + x*u*v) * dx
+            lform = CoefficientFunction((1,x,y))*v*dx
+        else:
+            form = (grad(u)*grad(v) + (1+x*y)*u*v) * dx + u*v*ds
+            lform = x*v*dx + v*ds
+        for symmetric in [False, True]:
+            a1 = BilinearForm(form, symmetric=symmetric).Assemble()
+            a2 = BilinearForm(form, symmetric=symmetric, owner_assembly=True).Assemble()
+            diff = a1.mat.AsVector().CreateVector()
+            diff.data = a1.mat.AsVector() - a2.mat.AsVector()
+            assert Norm(diff) < 1e-12 * Norm(a1.mat.AsVector())
+        f1 = LinearForm(lform).Assemble()
+        f2 = LinearForm(lform, owner_assembly=True).Assemble()
+        diff = f1.vec.CreateVector()
+        diff.data = f1.vec - f2.vec
+        assert Norm(diff) < 1e-12 * Norm(f1.vec)
+
+
+def test_cachedofs():
+    mesh = Mesh(unit_cube.GenerateMesh(maxh=0.3))
+    for order in [1, 3]:
+        fes1 = HCurl(mesh, order=order)
+        fes2 = HCurl(mesh, order=order, cachedofs=True)
+        dofs1 = [el.dofs for el in fes1.Elements(VOL)]
+        dofs2 = [el.dofs for el in fes2.Elements(VOL)]
+        assert dofs1 == dofs2
+        mats = []
+        for fes in [fes1, fes2]:
+            u,v = fes.TnT()
+            mats.append(BilinearForm(curl(u)*curl(v)*dx+u*v*dx).Assemble().mat)
+        diff = mats[0].AsVector().CreateVector()
+        diff.data = mats[0].AsVector() - mats[1].AsVector()
+        assert Norm(diff) < 1e-12 * Norm(mats[0].AsVector())
+
+def test_discontinuous_graph():
+    mesh = Mesh(unit_square.GenerateMesh(maxh=0.2))
+    fes = Discontinuous(H1(mesh, order=1))
+    u,v = fes.TnT()
+    a = BilinearForm(u*v*dx).Assemble()
+    # element blocks only, 3 dofs per triangle
+    assert a.mat.nze == 9 * mesh.ne
+    fes = H1(mesh, order=2) * Discontinuous(H1(mesh, order=1))
+    (u1,u2),(v1,v2) = fes.TnT()
+    a = BilinearForm(grad(u1)*grad(v1)*dx + u1*v2*dx + u2*v2*dx).Assemble()
+    w = a.mat.CreateColVector()
+    w[:] = 1
+    r = a.mat.CreateColVector()
+    r.data = a.mat * w
+    assert Norm(r) > 0
+
+def test_nodal_graph():
+    mesh = Mesh(unit_cube.GenerateMesh(maxh=0.4))
+    cases = [(H1(mesh, order=3), lambda u,v: grad(u)*grad(v)*dx + u*v*ds),
+             (HCurl(mesh, order=2), lambda u,v: curl(u)*curl(v)*dx + u*v*dx)]
+    for fes, form in cases:
+        u,v = fes.TnT()
+        for symmetric in [False, True]:
+            for condense in [False, True]:
+                mats = [BilinearForm(form(u,v), symmetric=symmetric, condense=condense,
+                                     nodal_graph=nodal).Assemble().mat
+                        for nodal in [True, False]]
+                assert mats[0].nze == mats[1].nze
+                (r1,c1,v1), (r2,c2,v2) = [mat.COO() for mat in mats]
+                assert list(r1) == list(r2)
+                assert list(c1) == list(c2)
+                assert np.allclose(np.array(v1), np.array(v2))
+
+
+def test_restrict():
+    def dense(mat, symmetric):
+        firsti, colnr, data = np.array(mat.firsti), np.array(mat.colnr), np.array(mat.data)
+        bs = 1 if data.ndim == 1 else data.shape[1]
+        data = data.reshape(-1, bs, bs)
+        d = np.zeros((mat.height*bs, mat.width*bs))
+        for i in range(mat.height):
+            for k in range(firsti[i], firsti[i+1]):
+                j = colnr[k]
+                d[i*bs:(i+1)*bs, j*bs:(j+1)*bs] = data[k]
+                if symmetric:
+                    d[j*bs:(j+1)*bs, i*bs:(i+1)*bs] = data[k].T
+        return d
+
+    mesh = Mesh(unit_square.GenerateMesh(maxh=0.3))
+    for dim in [1, 2]:
+        fes = H1(mesh, order=2, dim=dim) if dim > 1 else H1(mesh, order=2)
+        u,v = fes.TnT()
+        n = fes.ndof
+        nc = n // 3
+        rows = [i for i in range(n) for k in range(2)]
+        cols = [(i//3 + k*(1+i%5)) % nc for i in range(n) for k in range(2)]
+        vals = [1+0.1*(i%7)-0.3*k for i in range(n) for k in range(2)]
+        prol = la.SparseMatrixd.CreateFromCOO(rows, cols, vals, n, nc)
+        prol2 = la.SparseMatrixd.CreateFromCOO(rows, cols, [2*x for x in vals], n, nc)
+        P = np.kron(dense(prol, False), np.eye(dim))
+        for symmetric in [False, True]:
+            form = InnerProduct(grad(u),grad(v))*dx + 0.5*InnerProduct(u,v)*dx
+            if not symmetric:
+                form += InnerProduct(grad(u)*CF((1,0.5)), v)*dx
+            a = BilinearForm(form, symmetric=symmetric).Assemble()
+            A = dense(a.mat, symmetric)
+            cmat = a.mat.Restrict(prol)
+            assert np.allclose(dense(cmat, symmetric), P.T @ A @ P)
+            # same pattern, only the values are recomputed
+            cmat2 = a.mat.Restrict(prol2, cmat)
+            assert cmat2.nze == cmat.nze
+            assert np.allclose(dense(cmat2, symmetric), 4 * P.T @ A @ P)
+
+
 if __name__ == "__main__":
     test_matrix()
     test_matrix_numpy()
     test_sparsematrix_access()
+    test_sparsematrix_sell()
@@ -82,6 +82,25 @@ def test_neighbours2d():
     assert mesh.Materials("base").Boundaries() * mesh.Materials("top").Boundaries() == mesh.Boundaries("default")
     assert mesh.Materials("base").Boundaries() * mesh.Materials("chip").Boundaries() == mesh.Boundaries("")
 
+def test_vtkoutput_vtu():
+    import os, struct
+    mesh = Mesh(unit_cube.GenerateMesh(maxh=0.5))
+    vtk = VTKOutput(ma=mesh, coefs=[x*y, CoefficientFunction((x,y,z))], names=["xy","pos"],
+                    filename="vtkout_test", subdivision=1, format="vtu")
+    name = vtk.Do()
+    with open(name+".vtu", "rb") as f:
+        data = f.read()
+    os.remove(name+".vtu")
+    header, appended = data.split(b'<AppendedData encoding="raw">\n_')
+    ncells = 8*mesh.ne
+    npoints = 10*mesh.ne
+    assert 'NumberOfPoints="{}" NumberOfCells="{}"'.format(npoints, ncells) in header.decode()
+    # first block are the points, 3 floats each
+    nbytes = struct.unpack("<Q", appended[:8])[0]
+    assert nbytes == 3*4*npoints
+    pts = struct.unpack("<{}f".format(3*npoints), appended[8:8+nbytes])
+    assert min(pts) >= -1e-6 and max(pts) <= 1+1e-6
+
 if __name__ == "__main__":
     test_neighbours2d()
     test_neighbours()
@@ -54,5 +54,321 @@ def test_newton_with_dirichlet():
     newton = solvers.Newton(a, gfu, dirichletvalues=dirichlet.vec)
 
 
+def test_float_smoothers():
+    mesh = Mesh (unit_square.GenerateMesh(maxh=0.2))
+    fes = H1(mesh, order=3, dirichlet="left|bottom")
+    u,v = fes.TnT()
+    a = BilinearForm(fes)
+    a += grad(u)*grad(v)*dx
+    a.Assemble()
+    f = LinearForm(fes)
+    f += v*dx
+    f.Assemble()
+
+    amatf = la.SparseMatrixFloat(a.mat)
+    x = a.mat.CreateRowVector()
+    x.SetRandom()
+    y1 = a.mat.CreateColVector()
+    y2 = a.mat.CreateColVector()
+    y1.data = a.mat * x
+    y2.data = amatf * x
+    assert (y1-y2).Norm() < 1e-6 * y1.Norm()
+
+    # symmetric storage is expanded to the full pattern
+    asym = BilinearForm(grad(u)*grad(v)*dx, symmetric=True).Assemble()
+    y2.data = la.SparseMatrixFloat(asym.mat) * x
+    assert (y1-y2).Norm() < 1e-6 * y1.Norm()
+
+    blocks = [ [d] for d in range(fes.ndof) if fes.FreeDofs()[d] ]
+    for pre in [amatf.CreateSmoother(fes.FreeDofs()), amatf.CreateBlockSmoother(blocks)]:
+        gfu = GridFunction(fes)
+        solvers.CG(mat=a.mat, pre=pre, rhs=f.vec, sol=gfu.vec, tol=1e-12, maxsteps=1000, printrates=False)
+        res = f.vec.CreateVector()
+        res.data = f.vec - a.mat * gfu.vec
+        res.data = Projector(fes.FreeDofs(), True) * res
+        assert res.Norm() < 1e-8 * f.vec.Norm()
+
+
+def test_sparsecholesky_ordering():
+    mesh = Mesh (unit_square.GenerateMesh(maxh=0.05))
+    fes = H1(mesh, order=3, dirichlet="left|bottom", complex=True)
+    u,v = fes.TnT()
+    a = BilinearForm(fes, symmetric=True)
+    a += (grad(u)*grad(v)+1j*u*v)*dx
+    a.Assemble()
+    f = LinearForm(fes)
+    f += v*dx
+    f.Assemble()
+
+    for ordering in ["mindegree", "nesteddissection"]:
+        inv = a.mat.Inverse(fes.FreeDofs(), inverse="sparsecholesky", ordering=ordering)
+        gfu = GridFunction(fes)
+        gfu.vec.data = inv * f.vec
+        res = f.vec.CreateVector()
+        res.data = f.vec - a.mat * gfu.vec
+        res.data = Projector(fes.FreeDofs(), True) * res
+        assert res.Norm() < 1e-10 * f.vec.Norm()
+
+
+def test_sparsecholesky_refactor():
+    mesh = Mesh (unit_square.GenerateMesh(maxh=0.1))
+    fes = H1(mesh, order=2, dirichlet="left|bottom")
+    u,v = fes.TnT()
+    c = Parameter(1)
+    a = BilinearForm(fes, symmetric=True)
+    a += (grad(u)*grad(v)+c*u*v)*dx
+    a.Assemble()
+    f = LinearForm(fes)
+    f += v*dx
+    f.Assemble()
+
+    inv = a.mat.Inverse(fes.FreeDofs(), inverse="sparsecholesky")
+    assert inv.supports_update
+    gfu = GridFunction(fes)
+    res = f.vec.CreateVector()
+    for val in [10, 100]:
+        c.Set(val)
+        a.Assemble()
+        inv.Update()
+        gfu.vec.data = inv * f.vec
+        res.data = f.vec - a.mat * gfu.vec
+        res.data = Projector(fes.FreeDofs(), True) * res
+        assert res.Norm() < 1e-10 * f.vec.Norm()
+
+    # new matrix with the same graph
+    a2 = BilinearForm(fes, symmetric=True)
+    a2 += (grad(u)*grad(v)+5*u*v)*dx
+    a2.Assemble()
+    inv.Refactor(a2.mat)
+    gfu.vec.data = inv * f.vec
+    res.data = f.vec - a2.mat * gfu.vec
+    res.data = Projector(fes.FreeDofs(), True) * res
+    assert res.Norm() < 1e-10 * f.vec.Norm()
+
+def test_blocksmoother_nesteddissection():
+    mesh = Mesh (unit_square.GenerateMesh(maxh=0.05))
+    fes = H1(mesh, order=3, dirichlet="left|bottom")
+    u,v = fes.TnT()
+    a = BilinearForm(fes, symmetric=True)
+    a += (grad(u)*grad(v)+u*v)*dx
+    a.Assemble()
+    f = LinearForm(fes)
+    f += v*dx
+    f.Assemble()
+
+    # a single large block is factored by sparse cholesky
+    blocks = [ [d for d in range(fes.ndof) if fes.FreeDofs()[d]] ]
+    pre = a.mat.CreateBlockSmoother(blocks, ordering="nesteddissection")
+    gfu = GridFunction(fes)
+    gfu.vec.data = pre * f.vec
+    res = f.vec.CreateVector()
+    res.data = f.vec - a.mat * gfu.vec
+    res.data = Projector(fes.FreeDofs(), True) * res
+    assert res.Norm() < 1e-10 * f.vec.Norm()
+
+    # Gauss-Seidel with several large blocks
+    free = blocks[0]
+    blocks = [free[0::2], free[1::2]]
+    pre = a.mat.CreateBlockSmoother(blocks, ordering="nesteddissection")
+    gfu.vec[:] = 0
+    norms = []
+    for i in range(20):
+        pre.Smooth(gfu.vec, f.vec)
+        res.data = f.vec - a.mat * gfu.vec
+        res.data = Projector(fes.FreeDofs(), True) * res
+        norms.append(res.Norm())
+    assert norms[-1] < 0.5 * norms[0]
+
+
+def test_communication_avoiding_krylov():
+    mesh = Mesh (unit_square.GenerateMesh(maxh=0.1))
+    fes = H1(mesh, order=2, dirichlet="left|bottom")
+    u,v = fes.TnT()
+    a = BilinearForm(fes)
+    a += (grad(u)*grad(v)+u*v)*dx
+    a.Assemble()
+    f = LinearForm(fes)
+    f += v*dx
+    f.Assemble()
+    pre = a.mat.CreateSmoother(fes.FreeDofs())
+
+    solvers = [la.PipelinedCGSolver(a.mat, pre, printrates=False, precision=1e-12, maxsteps=500),
+               la.SStepCGSolver(a.mat, pre, s=3, printrates=False, precision=1e-12, maxsteps=500),
+               la.SStepGMRESSolver(a.mat, pre, s=3, printrates=False, precision=1e-12, maxsteps=500)]
+    for inv in solvers:
+        gfu = GridFunction(fes)
+        gfu.vec.data = inv * f.vec
+        res = f.vec.CreateVector()
+        res.data = f.vec - a.mat * gfu.vec
+        res.data = Projector(fes.FreeDofs(), True) * res
+        assert res.Norm() < 1e-8 * f.vec.Norm()
+
+def test_block_krylov():
+    mesh = Mesh (unit_square.GenerateMesh(maxh=0.1))
+    fes = H1(mesh, order=2, dirichlet="left|bottom")
+    u,v = fes.TnT()
+    a = BilinearForm(fes)
+    a += (grad(u)*grad(v)+u*v)*dx
+    a.Assemble()
+    pre = a.mat.CreateSmoother(fes.FreeDofs())
+    proj = Projector(fes.FreeDofs(), True)
+
+    k = 5
+    rhs = MultiVector(a.mat.CreateColVector(), k)
+    for i in range(k):
+        rhs[i].SetRandom()
+        rhs[i].data = proj * rhs[i]
+
+    for inv in [la.BlockCGSolver(a.mat, pre, printrates=False, precision=1e-12, maxsteps=500),
+                la.BlockGMRESSolver(a.mat, pre, printrates=False, precision=1e-12, maxsteps=200)]:
+        sol = MultiVector(a.mat.CreateRowVector(), k)
+        sol.data = inv * rhs
+        res = rhs[0].CreateVector()
+        for i in range(k):
+            res.data = rhs[i] - a.mat * sol[i]
+            res.data = proj * res
+            assert res.Norm() < 1e-8 * rhs[i].Norm()
+
+def test_block_gmres_deflation():
+    mesh = Mesh (unit_square.GenerateMesh(maxh=0.1))
+    fes = H1(mesh, order=2, dirichlet="left|bottom")
+    u,v = fes.TnT()
+    a = BilinearForm(fes)
+    a += (grad(u)*grad(v)+u*v)*dx
+    a.Assemble()
+    pre = a.mat.CreateSmoother(fes.FreeDofs())
+    proj = Projector(fes.FreeDofs(), True)
+
+    # a zero column, a duplicated column and a linear combination
+    rhs = MultiVector(a.mat.CreateColVector(), 5)
+    for i in [0, 3]:
+        rhs[i].SetRandom()
+        rhs[i].data = proj * rhs[i]
+    rhs[1][:] = 0
+    rhs[2].data = rhs[0]
+    rhs[4].data = 2 * rhs[0] - rhs[3]
+
+    inv = la.BlockGMRESSolver(a.mat, pre, printrates=False, precision=1e-12, maxsteps=200)
+    sol = MultiVector(a.mat.CreateRowVector(), 5)
+    sol.data = inv * rhs
+    res = rhs[0].CreateVector()
+    for i in range(5):
+        res.data = rhs[i] - a.mat * sol[i]
+        res.data = proj * res
+        assert res.Norm() <= 1e-8 * rhs[i].Norm()
+    assert sol[1].Norm() == 0
+    res.data = sol[2] - sol[0]
+    assert res.Norm() < 1e-10 * sol[0].Norm()
+
+    for i in range(5):
+        rhs[i][:] = 0
+    sol.data = inv * rhs
+    for i in range(5):
+        assert sol[i].Norm() == 0
+
+
+def test_multivector_kernels():
+    mesh = Mesh (unit_square.GenerateMesh(maxh=0.1))
+    fes = H1(mesh, order=3, dirichlet="left|bottom")
+    u,v = fes.TnT()
+    a = BilinearForm(fes)
+    a += (grad(u)*grad(v)+u*v)*dx
+    a.Assemble()
+    blocks = [list(el.dofs) for el in fes.Elements()]
+    pre = a.mat.CreateBlockSmoother(blocks)
+
+    k = 7     # not a multiple of the SIMD width
+    x = MultiVector(a.mat.CreateRowVector(), k)
+    for i in range(k):
+        x[i].SetRandom()
+    y = MultiVector(a.mat.CreateColVector(), k)
+    hv = x[0].CreateVector()
+    for mat in [a.mat, pre]:
+        y[:] = mat * x
+        for i in range(k):
+            hv.data = mat * x[i]
+            hv.data -= y[i]
+            assert hv.Norm() < 1e-12 * y[i].Norm()
+
+
+def test_lobpcg():
+    from math import pi
+    mesh = Mesh (unit_square.GenerateMesh(maxh=0.1))
+    fes = H1(mesh, order=3, dirichlet="left|right|top|bottom")
+    u,v = fes.TnT()
+    a = BilinearForm(grad(u)*grad(v)*dx).Assemble()
+    m = BilinearForm(u*v*dx).Assemble()
+    pre = a.mat.CreateSmoother(fes.FreeDofs())
+
+    k = 4
+    evecs = MultiVector(a.mat.CreateRowVector(), k)
+    lam = la.LOBPCGSolver(a.mat, m.mat, pre, evecs, freedofs=fes.FreeDofs(),
+                          tol=1e-8, maxsteps=500)
+    exact = [2, 5, 5, 8]
+    for i in range(k):
+        assert abs(lam[i] - exact[i]*pi**2) < 1e-3 * lam[i]
+
+    proj = Projector(fes.FreeDofs(), True)
+    res = evecs[0].CreateVector()
+    mv = evecs[0].CreateVector()
+    for i in range(k):
+        mv.data = m.mat * evecs[i]
+        res.data = a.mat * evecs[i] - lam[i] * mv
+        res.data = proj * res
+        assert res.Norm() < 1e-6 * lam[i] * mv.Norm()
+        assert abs(InnerProduct(mv, evecs[i]) - 1) < 1e-8
+
+
+def test_chebyshev_smoother():
+    mesh = Mesh (unit_square.GenerateMesh(maxh=0.3))
+    fes = H1(mesh, order=2, dirichlet="left|bottom")
+    u,v = fes.TnT()
+    a = BilinearForm(grad(u)*grad(v)*dx)
+    f = LinearForm(v*dx)
+    gfu = GridFunction(fes)
+    pres = [Preconditioner(a, "multigrid", smoother="chebyshev", chebyshevdegree=3),
+            Preconditioner(a, "multigrid", smoother="block", chebyshev=True)]
+    for l in range(3):
+        if l > 0: mesh.Refine()
+        fes.Update()
+        gfu.Update()
+        a.Assemble()
+        f.Assemble()
+    for pre in pres:
+        inv = CGSolver(a.mat, pre.mat, precision=1e-10, maxsteps=100)
+        gfu.vec.data = inv * f.vec
+        assert inv.GetSteps() < 40
+        res = f.vec.CreateVector()
+        res.data = f.vec - a.mat * gfu.vec
+        res.data = Projector(fes.FreeDofs(), True) * res
+        assert res.Norm() < 1e-8 * f.vec.Norm()
+
+
+def test_saamg_elasticity():
+    from netgen.csg import unit_cube
+    mesh = Mesh(unit_cube.GenerateMesh(maxh=0.15))
+    fes = H1(mesh, order=1, dim=3, dirichlet="left")
+    u,v = fes.TnT()
+    eps = lambda w: 0.5*(grad(w)+grad(w).trans)
+    mu, lam = 1, 2
+    a = BilinearForm(fes)
+    a += (2*mu*InnerProduct(eps(u),eps(v)) + lam*Trace(eps(u))*Trace(eps(v)))*dx
+    pre = Preconditioner(a, "saamg")
+    a.Assemble()
+    f = LinearForm(fes)
+    f += CoefficientFunction((0,0,-1))*v*dx
+    f.Assemble()
+
+    gfu = GridFunction(fes)
+    inv = CGSolver(a.mat, pre.mat, precision=1e-8, maxsteps=200)
+    gfu.vec.data = inv * f.vec
+    assert inv.GetSteps() < 100
+    res = f.vec.CreateVector()
+    res.data = f.vec - a.mat * gfu.vec
+    res.data = Projector(fes.FreeDofs(), True) * res
+    assert res.Norm() < 1e-6 * f.vec.Norm()
+
+
+
 if __name__ == "__main__":
     test_arnoldi()
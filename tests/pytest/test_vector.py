@@ -40,3 +40,38 @@ def test_vector_numpy():
     assert d[0] == c[0]
     d[1] = 1+3j
     assert d[1] == c[1]
+
+def test_basevector_numpy_views():
+    try:
+        import numpy as np
+    except:
+        pytest.skip("could not import numpy")
+    v = BaseVector(10)
+    v[:] = 1
+    a = np.asarray(v)
+    a[3] = 5
+    assert v[3] == 5
+
+    arr = np.arange(6, dtype=float)
+    w = BaseVector(arr, copy=False)
+    w[2] = 42
+    assert arr[2] == 42
+    wc = BaseVector(arr, copy=True)
+    wc[0] = -1
+    assert arr[0] == 0
+
+    mv = MultiVector(8, 3, False)
+    for i in range(3):
+        mv[i][:] = i
+    m = mv.NumPy()
+    assert m.shape == (8, 3)
+    assert list(m[0,:]) == [0, 1, 2]
+    m[4,2] = 7
+    assert mv[2][4] == 7
+
+    from ngsolve.la import SparseMatrixd
+    mat = SparseMatrixd.CreateFromCOO([0,1,1], [0,0,1], [1,2,3], 2, 2)
+    assert list(mat.firsti) == [0, 1, 3]
+    assert list(mat.colnr) == [0, 0, 1]
+    assert list(mat.data) == [1, 2, 3]
+    assert not mat.data.flags.writeable